@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Public interface of libopenhpca_overlap, which runs the overlap search of the OpenHPCA benchmarks (time driven
+// model) against the communication and the computation of an application. The application provides a callback
+// posting its non-blocking communication, a callback completing it and, optionally, a callback computing for a given
+// amount of work units (the execution time of its kernel must grow linearly with the number of units); the library
+// measures the time of the communication alone, then searches for the largest amount of work that can be performed
+// while the communication is in flight without increasing the execution time, exactly like the benchmarks do.
+//
+// All the functions taking a context are collective over the communicator of the context. The parameters of the
+// search (e.g., OPENHPCA_OVERLAP_VALIDATION_STEPS, OPENHPCA_OVERLAP_ACCEPTANCE_THRESHOLD, OPENHPCA_OVERLAP_SYNC,
+// OPENHPCA_OVERLAP_SKEW or OPENHPCA_OVERLAP_DEBUG) are read from the environment, as by the benchmarks.
+//
+// The search relies on state shared by the whole process (e.g., the cache of the datatypes, the handles of the
+// performance and control variables and the structured output), only one context may therefore exist at a time: a
+// context must be freed before another one is created.
+
+#ifndef OPENHPCA_OVERLAP_H_
+#define OPENHPCA_OVERLAP_H_
+
+#include <stdint.h>
+
+#include "mpi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Increased every time the interface changes in a way that is not backward compatible
+#define OPENHPCA_OVERLAP_API_VERSION (2)
+
+// The library is built with hidden symbols, only the functions of the interface are exported
+#ifdef __GNUC__
+#define OPENHPCA_OVERLAP_EXPORT __attribute__((visibility("default")))
+#else
+#define OPENHPCA_OVERLAP_EXPORT
+#endif
+
+#define OPENHPCA_OVERLAP_SUCCESS (0)
+#define OPENHPCA_OVERLAP_ERROR (1)
+
+// Posts the communication of the application, e.g., a MPI_Iallreduce() saving its request in arg; returns
+// MPI_SUCCESS on success
+typedef int (*openhpca_overlap_post_fn_t)(void *arg);
+// Completes the communication posted by the post callback, e.g., with MPI_Wait(); returns MPI_SUCCESS on success
+typedef int (*openhpca_overlap_wait_fn_t)(void *arg);
+// Computes for the given amount of work units
+typedef void (*openhpca_overlap_work_fn_t)(void *arg, int64_t units);
+
+typedef struct openhpca_overlap_ctx *openhpca_overlap_ctx_t;
+
+// Result of a search, available on all the ranks; times are in milli-seconds and per iteration
+typedef struct openhpca_overlap_result
+{
+    int n_iters;
+    double ref_time;  // Time of the communication alone, from its post to its completion
+    double stdev;     // Standard deviation of the reference time
+    double work_time; // Largest amount of work overlapped with the communication
+    double wait_time; // Time spent completing the communication with that amount of work
+    double overlap;   // in percent
+    double inflation; // Slowdown of the computation with the communication in flight, in percent, averaged over the
+                      // ranks; 0 unless OPENHPCA_OVERLAP_COMPUTE_INFLATION is 1
+} openhpca_overlap_result_t;
+
+// openhpca_overlap_get_api_version returns the version of the interface implemented by the library
+OPENHPCA_OVERLAP_EXPORT int openhpca_overlap_get_api_version(void);
+
+// openhpca_overlap_create creates a context evaluating the communication performed on comm; MPI must be initialized.
+// Fails if another context has not been freed yet
+OPENHPCA_OVERLAP_EXPORT int openhpca_overlap_create(MPI_Comm comm, openhpca_overlap_ctx_t *ctx);
+
+// openhpca_overlap_set_callbacks sets the callbacks of the application, arg being passed to all of them. work can be
+// NULL, in which case the synthetic kernel of the benchmarks is used
+OPENHPCA_OVERLAP_EXPORT int openhpca_overlap_set_callbacks(openhpca_overlap_ctx_t ctx, openhpca_overlap_post_fn_t post,
+                                                           openhpca_overlap_wait_fn_t wait, openhpca_overlap_work_fn_t work, void *arg);
+
+// openhpca_overlap_set_iters sets the number of iterations of every measurement; 0 (the default) selects the number of
+// iterations giving statistically relevant results, up to OPENHPCA_DEFAULT_TDM_NUM_ITERS
+OPENHPCA_OVERLAP_EXPORT int openhpca_overlap_set_iters(openhpca_overlap_ctx_t ctx, int n_iters);
+
+// openhpca_overlap_run runs the overlap search
+OPENHPCA_OVERLAP_EXPORT int openhpca_overlap_run(openhpca_overlap_ctx_t ctx, openhpca_overlap_result_t *result);
+
+// openhpca_overlap_free frees a context and sets it to NULL
+OPENHPCA_OVERLAP_EXPORT int openhpca_overlap_free(openhpca_overlap_ctx_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENHPCA_OVERLAP_H_
@@ -11,8 +11,11 @@
 #include <sys/time.h>
 #include <inttypes.h>
 #include <string.h>
+#include <ctype.h>
 #include <stdio.h>
 
+#include "overlap_stats.h"
+
 #ifndef OPENHPCA_OVERLAP_H
 #define OPENHPCA_OVERLAP_H
 
@@ -32,6 +35,58 @@
 #define DEFAULT_CUTOFF_TIME (500)        // in milli-seconds
 #define DEFAULT_OVERLAP_THRESHOLD (5)    // If the difference between the injected work that allows overlap and the one that does not allow overlap is x%, the result is precise enough and we stop
 #define MAX_NUM_CALIBRATION_POINTS (1000)
+#define MAX_SWEEP_SIZES (64)
+#define DEFAULT_TIME_BUDGET (600) // in seconds
+#define MAX_ROOTS (64)
+#define MAX_SKEWS (32)
+#define MAX_COMM_SIZES (64)
+#define MAX_CONCURRENCY (16)
+#define DEFAULT_SKEW_SEED (1)
+#define DEFAULT_WORK_CYCLES (1000) // Cycles of the time stamp counter per work unit with the cycles work kernel
+
+// Kernels used to inject work
+#define WORK_KERNEL_FLOPS (0)  // Floating-point loop built without optimizations, do_flops()
+#define WORK_KERNEL_CYCLES (1) // Spin until a number of cycles of the time stamp counter elapsed, do_cycles()
+
+// Patterns used to delay the arrival of the ranks in the collective operations
+#define SKEW_PATTERN_LATE_RANK (0) // The last rank is late
+#define SKEW_PATTERN_RAMP (1)      // Rank r is late by r/(world_size-1) of the skew
+#define SKEW_PATTERN_RANDOM (2)    // Every rank is late by a random amount, uniformly distributed between 0 and the skew
+
+// Methods used to synchronize the ranks before each iteration
+#define SYNC_MODE_BARRIER (0) // MPI_Barrier() between iterations
+#define SYNC_MODE_WINDOW (1)  // Iterations start at agreed global timestamps, based on synchronized clocks
+#define DEFAULT_SYNC_WINDOW (1000)  // Minimum duration of a window, in micro-seconds
+#define SYNC_WINDOW_FACTOR (3)      // Windows are at least this many times longer than the expected iteration time
+#define SYNC_MAX_LATE_PERCENT (10)  // Windows are enlarged when more than 10% of the ranks' arrivals are late
+#define SYNC_N_PINGPONGS (20)       // Number of ping-pongs used to estimate the offset of a clock
+#define SYNC_DRIFT_INTERVAL (0.1)   // Time between the two offset estimations used to compute the drift, in seconds
+
+// Layouts of the buffers of the non-reduction collective operations under the time driven model
+#define DATATYPE_CONTIGUOUS (0) // MPI_DOUBLE
+#define DATATYPE_VECTOR (1)     // MPI_Type_vector()
+#define DATATYPE_INDEXED (2)    // MPI_Type_indexed()
+#define DATATYPE_SUBARRAY (3)   // MPI_Type_create_subarray(), 2D array with a row per block
+#define DEFAULT_BLOCK_LEN (1)   // in elements
+
+// Datatypes and operations of the reductions under the time driven model
+#define REDUCE_TYPE_DOUBLE (0)
+#define REDUCE_TYPE_FLOAT (1)
+#define REDUCE_TYPE_INT (2)
+#define REDUCE_TYPE_INT16 (3)
+#define REDUCE_TYPE_FLOAT16 (4) // Only when the MPI library provides MPIX_C_FLOAT16
+#define MAX_REDUCE_TYPES (5)
+#define REDUCE_OP_SUM (0)
+#define REDUCE_OP_MAX (1)
+#define REDUCE_OP_BAND (2) // Integer datatypes only
+#define REDUCE_OP_USER (3) // User-defined sum with a tunable cost
+#define MAX_REDUCE_OPS (4)
+
+// Communicators the time driven model runs on, besides MPI_COMM_WORLD
+#define COMM_SPLIT_NONE (0)    // MPI_COMM_WORLD
+#define COMM_SPLIT_NODE (1)    // Ranks of the node of rank 0, from MPI_Comm_split_type(MPI_COMM_TYPE_SHARED)
+#define COMM_SPLIT_LEADERS (2) // Lowest rank of every node
+#define COMM_SPLIT_SUBSET (3)  // First ranks of MPI_COMM_WORLD, used to evaluate the scaling of the overlap
 
 #define OVERLAP_MIN_NUM_ELTS_ENVVAR "OPENHPCA_OVERLAP_MIN_NUM_ELTS"
 #define OVERLAP_MAX_NUM_ELTS_ENVVAR "OPENHPCA_OVERLAP_MAX_NUM_ELTS"
@@ -45,11 +100,44 @@
 #define OVERLAP_MAX_TDM_ITERS_ENVVAR "OPENHPCA_DEFAULT_TDM_NUM_ITERS"
 
 #define OVERLAP_ACCEPTANCE_THRESHOLD_ENVVAR "OPENHPCA_OVERLAP_ACCEPTANCE_THRESHOLD"
+#define OVERLAP_SWEEP_SIZES_ENVVAR "OPENHPCA_OVERLAP_SWEEP_SIZES"
+#define OVERLAP_SWEEP_POINTS_ENVVAR "OPENHPCA_OVERLAP_SWEEP_POINTS"
+#define OVERLAP_TIME_BUDGET_ENVVAR "OPENHPCA_OVERLAP_TIME_BUDGET"
+#define OVERLAP_SEED_NUM_ELTS_ENVVAR "OPENHPCA_OVERLAP_SEED_NUM_ELTS"
+#define OVERLAP_ROOTS_ENVVAR "OPENHPCA_OVERLAP_ROOTS"
+#define OVERLAP_SKEW_ENVVAR "OPENHPCA_OVERLAP_SKEW"
+#define OVERLAP_SKEW_PATTERN_ENVVAR "OPENHPCA_OVERLAP_SKEW_PATTERN"
+#define OVERLAP_SKEW_SEED_ENVVAR "OPENHPCA_OVERLAP_SKEW_SEED"
+#define OVERLAP_SYNC_ENVVAR "OPENHPCA_OVERLAP_SYNC"
+#define OVERLAP_SYNC_WINDOW_ENVVAR "OPENHPCA_OVERLAP_SYNC_WINDOW"
+#define OVERLAP_COMM_SPLITS_ENVVAR "OPENHPCA_OVERLAP_COMM_SPLITS"
+#define OVERLAP_COMM_SIZES_ENVVAR "OPENHPCA_OVERLAP_COMM_SIZES"
+#define OVERLAP_CONCURRENCY_ENVVAR "OPENHPCA_OVERLAP_CONCURRENCY"
+#define OVERLAP_DATATYPE_ENVVAR "OPENHPCA_OVERLAP_DATATYPE"
+#define OVERLAP_BLOCK_LEN_ENVVAR "OPENHPCA_OVERLAP_BLOCK_LEN"
+#define OVERLAP_STRIDE_ENVVAR "OPENHPCA_OVERLAP_STRIDE"
+#define OVERLAP_REDUCE_TYPES_ENVVAR "OPENHPCA_OVERLAP_REDUCE_TYPES"
+#define OVERLAP_REDUCE_OPS_ENVVAR "OPENHPCA_OVERLAP_REDUCE_OPS"
+#define OVERLAP_USER_OP_COST_ENVVAR "OPENHPCA_OVERLAP_USER_OP_COST"
+#define OVERLAP_COMPUTE_INFLATION_ENVVAR "OPENHPCA_OVERLAP_COMPUTE_INFLATION"
+#define OVERLAP_WORK_KERNEL_ENVVAR "OPENHPCA_OVERLAP_WORK_KERNEL"
+#define OVERLAP_WORK_CYCLES_ENVVAR "OPENHPCA_OVERLAP_WORK_CYCLES"
 
 #define asm __asm__
 
+// Operations replacing the ones of the benchmarks when the search is driven through libopenhpca_overlap, see
+// openhpca_overlap.h
+typedef struct overlap_callbacks
+{
+    int (*post)(void *arg);                 // Posts the communication, returns MPI_SUCCESS on success
+    int (*wait)(void *arg);                 // Completes the communication, returns MPI_SUCCESS on success
+    void (*work)(void *arg, int64_t units); // Computes for the given amount of work units, NULL to use do_work()
+    void *arg;
+} overlap_callbacks_t;
+
 typedef struct overlap_params
 {
+    const char *name; // Name of the benchmark, i.e., argv[0]
     uint64_t min_elts;
     uint64_t max_elts;
     bool verbose;
@@ -63,6 +151,70 @@ typedef struct overlap_params
     int n_iters;
     int overlap_threshold;
     int max_iters;
+    // List of number of elements used by the time driven sweep mode, sorted in increasing order
+    uint64_t sweep_sizes[MAX_SWEEP_SIZES];
+    int sweep_n_sizes;
+    int time_budget; // in seconds
+    // Number of elements the time driven model starts its search from, 0 to start from a single element
+    uint64_t seed_elts;
+    // Root of the rooted collective operations (e.g., MPI_Ibcast) and list of roots to rotate through
+    int root;
+    int roots[MAX_ROOTS];
+    int n_roots;
+    // Arrival skew injected before posting the collective operations (in micro-seconds) and list of skews to evaluate
+    int skew;
+    int skews[MAX_SKEWS];
+    int n_skews;
+    int skew_pattern;
+    uint64_t skew_seed;
+    uint64_t skew_rng_state;
+    // Synchronization of the iterations
+    int sync_mode;
+    int sync_window; // in micro-seconds
+    // Model of the local clock against the clock of rank 0: global = local + offset + drift * (local - ref)
+    double clock_offset;
+    double clock_drift;
+    double clock_ref;
+    // Current series of windows (global times in seconds)
+    double window_start;
+    double window_len;
+    int window_idx;
+    int window_late;
+    // Average time (in milli-seconds) and size of the last configuration measured by tdm_get_coll_config_info(), used
+    // to predict the duration of the iterations of the next one
+    double prev_time;
+    uint64_t prev_n_elts;
+    // Communicator the collective operations are executed on; world_size and world_rank are relative to it
+    MPI_Comm comm;
+    int comm_split;  // COMM_SPLIT_* the communicator comes from
+    int comm_splits; // Bitmask of the additional communicators to evaluate, (1 << COMM_SPLIT_*)
+    // Sizes of the communicators used to evaluate the scaling of the overlap, sorted in increasing order
+    int comm_sizes[MAX_COMM_SIZES];
+    int n_comm_sizes;
+    // Number of collective operations in flight at the same time under the time driven model, each one being posted
+    // on its own duplicate of comm, and index of the operation being posted, i.e., of the buffers it must use
+    int concurrency;
+    int slot;
+    MPI_Comm comm_dups[MAX_CONCURRENCY];
+    // Layout of the buffers: blocks of block_len elements, stride elements apart
+    int datatype;
+    int block_len;
+    int stride;
+    // Datatype and operation of the reductions (REDUCE_TYPE_* and REDUCE_OP_*, -1 if the benchmark is not a reduction)
+    // and lists of datatypes and operations to sweep through
+    int reduce_type;
+    int reduce_op;
+    int reduce_types[MAX_REDUCE_TYPES];
+    int n_reduce_types;
+    int reduce_ops[MAX_REDUCE_OPS];
+    int n_reduce_ops;
+    int user_op_cost; // in work units per element
+    int cvar_setting; // Index of the setting of the control variables being evaluated, -1 outside of the sweep
+    bool compute_inflation; // Measure how much the communication in flight slows down the computation
+    int work_kernel;        // WORK_KERNEL_*
+    int64_t work_cycles;    // Cycles per work unit with WORK_KERNEL_CYCLES
+    double work_rate;       // Work units per nano-second on this rank, see tdm_calibrate_work()
+    const overlap_callbacks_t *callbacks; // NULL when the benchmarks post their own collective operations
 } overlap_params_t;
 
 typedef struct overlap_status
@@ -73,17 +225,21 @@ typedef struct overlap_status
     // min_invalid_overlap_work_units is the currently known minimum amount of work units that pushes the overall execution time with the work beyond the reference time
     int64_t min_invalid_overlap_work_units;
 
-    int validation_units;
+    int64_t validation_units;
     int validation_count;
     int validation_threshold;
 } overlap_status_t;
 
+// Kernel used by do_work(), set on all the ranks by sync_params()
+static int overlap_work_kernel = WORK_KERNEL_FLOPS;
+static int64_t overlap_work_cycles = DEFAULT_WORK_CYCLES;
+
 #ifdef __GNUC__
 #define __no_optimization __attribute__((optimize("O0")))
 #else
 #define __no_optimization
 #endif
-void __no_optimization do_work(double x, double y, double a, double b, int64_t n_ops)
+void __no_optimization do_flops(double x, double y, double a, double b, int64_t n_ops)
 {
     if (n_ops == 0)
     {
@@ -98,6 +254,96 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
     }
 }
 
+// read_cycles reads the time stamp counter: the invariant TSC on x86, the virtual counter on ARM and, on the other
+// architectures, the monotonic clock in nano-seconds. The counters tick at a constant rate, regardless of the
+// compiler, of the optimizations and of the frequency of the core.
+static inline uint64_t read_cycles(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    uint32_t lo, hi;
+    asm volatile("rdtsc"
+                 : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#elif defined(__GNUC__) && defined(__aarch64__)
+    uint64_t v;
+    asm volatile("mrs %0, cntvct_el0"
+                 : "=r"(v));
+    return v;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// do_cycles spins until n_cycles cycles of the time stamp counter elapsed; the counter being read through volatile
+// assembly, the loop cannot be optimized out
+static inline void do_cycles(int64_t n_cycles)
+{
+    uint64_t end = read_cycles() + (uint64_t)n_cycles;
+    while (read_cycles() < end)
+        ;
+}
+
+// do_work injects n_ops work units with the kernel selected by OPENHPCA_OVERLAP_WORK_KERNEL
+void do_work(double x, double y, double a, double b, int64_t n_ops)
+{
+    if (overlap_work_kernel == WORK_KERNEL_CYCLES)
+        do_cycles(n_ops * overlap_work_cycles);
+    else
+        do_flops(x, y, a, b, n_ops);
+}
+
+// overlap_work injects the given amount of work units, with the kernel of the application when one is provided
+static inline void overlap_work(overlap_params_t *params, int64_t units)
+{
+    if (params->callbacks != NULL && params->callbacks->work != NULL)
+        params->callbacks->work(params->callbacks->arg, units);
+    else
+        do_work(1.0, 1.0, 1.0, 1.0, units);
+}
+
+// skew_random returns a pseudo-random number uniformly distributed in [0, 1) (xorshift64*)
+static double skew_random(overlap_params_t *params)
+{
+    uint64_t x = params->skew_rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    params->skew_rng_state = x;
+    return (double)((x * 0x2545F4914F6CDD1DULL) >> 11) / (double)(1ULL << 53);
+}
+
+// inject_skew delays the calling rank based on the skew pattern; it is meant to be called right before posting a
+// collective operation so the ranks do not all arrive at the same time. Busy-waiting is used so the delay is not
+// extended by the operating system.
+static inline void inject_skew(overlap_params_t *params)
+{
+    double delay = 0.0, end;
+
+    if (params->skew <= 0)
+        return;
+
+    switch (params->skew_pattern)
+    {
+    case SKEW_PATTERN_LATE_RANK:
+        if (params->world_rank == params->world_size - 1)
+            delay = params->skew;
+        break;
+    case SKEW_PATTERN_RAMP:
+        if (params->world_size > 1)
+            delay = (double)params->skew * params->world_rank / (params->world_size - 1);
+        break;
+    case SKEW_PATTERN_RANDOM:
+        delay = params->skew * skew_random(params);
+        break;
+    }
+
+    end = MPI_Wtime() + delay / 1000000; // Micro-seconds to seconds
+    while (MPI_Wtime() < end)
+        ;
+}
+
 #define CHECK_N_ELTS(_n_elts, _max_elts, _avg_wait_time) do {                                     \
     uint64_t _n = _n_elts * 2;                                                    \
     if (_n * 2 > (_max_elts))                                                     \
@@ -111,14 +357,12 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
     }                                                                             \
 } while (0)
 
-#define INIT_OVERLAP_LOOP                                                    \
+#define INIT_OVERLAP_VARIABLES                                               \
     /* All the variables necessary to use non-blocking collectives */        \
     double end_time, total_time = 0.0, ref_time = 0.0, start_work, end_work; \
     double overlap;                                                          \
     int64_t work = 0;                                                        \
     int n_iters = DDM_DEFAULT_N_ITERS;                                       \
-    MPI_Request req;                                                         \
-    MPI_Status status;                                                       \
                                                                              \
     double *final_rank_times = NULL;                                         \
     double *final_work_stdevs = NULL;                                        \
@@ -164,6 +408,15 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
     MEMALLOC(post_maxs, double, params->world_size * sizeof(double));        \
     MEMALLOC(post_totals, double, params->world_size * sizeof(double));      \
                                                                              \
+    uint64_t n_elts;                                                         \
+    int n;                                                                   \
+    double stdev;
+
+#define INIT_OVERLAP_LOOP                                                    \
+    INIT_OVERLAP_VARIABLES                                                   \
+    MPI_Request req;                                                         \
+    MPI_Status status;                                                       \
+                                                                             \
     if (params->verbose && params->world_rank == 0)                          \
         display_overlap_params(params, sizeof(double));                      \
                                                                              \
@@ -171,11 +424,7 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
     {                                                                        \
         fprintf(stderr, "Calibration failed\n");                             \
         goto exit_error;                                                     \
-    }                                                                        \
-                                                                             \
-    uint64_t n_elts;                                                         \
-    int n;                                                                   \
-    double stdev;
+    }
 
 #define INIT_OVERLAP_BENCH           \
     overlap_params_t params;         \
@@ -183,7 +432,8 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
     int rc = MPI_Init(&argc, &argv); \
     if (MPI_SUCCESS != rc)           \
         goto exit_error;             \
-    get_overlap_params(&params);
+    get_overlap_params(&params);     \
+    params.name = argv[0];
 
 #define FINI_OVERLAP_BENCH          \
     do                              \
@@ -235,6 +485,10 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
             fprintf(stdout, "[%s:%d] " fmt, __FILE__, __LINE__, __VA_ARGS__); \
     } while (0)
 
+// SLOT_BUF returns the buffer of the operation being posted when several operations are in flight, each operation
+// using slot_elts elements
+#define SLOT_BUF(_buf, _params, _slot_elts) ((_buf) + (size_t)(_params)->slot * (_slot_elts))
+
 #define MEMALLOC(_var, _type, _size)                                \
     do                                                              \
     {                                                               \
@@ -256,49 +510,8 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
         }                 \
     } while (0)
 
-#define STDEV_UINT64(array, size, stdev)        \
-    do                                          \
-    {                                           \
-        uint64_t _sum = 0;                      \
-        double _mean;                           \
-        stdev = 0.0;                            \
-        int _i;                                 \
-        for (_i = 1; _i < size; _i++)           \
-            _sum += array[_i];                  \
-        _mean = (double)_sum / size;            \
-        for (_i = 0; _i < size; _i++)           \
-        {                                       \
-            stdev += pow(array[_i] - _mean, 2); \
-        }                                       \
-        stdev = sqrt(stdev / size);             \
-    } while (0)
-
-#define STDEV(array, size, stdev)               \
-    do                                          \
-    {                                           \
-        double _sum = 0.0;                      \
-        double _mean;                           \
-        stdev = 0.0;                            \
-        int _i;                                 \
-        for (_i = 1; _i < size; _i++)           \
-            _sum += array[_i];                  \
-        _mean = _sum / size;                    \
-        for (_i = 0; _i < size; _i++)           \
-            stdev += pow(array[_i] - _mean, 2); \
-        stdev = sqrt(stdev / size);             \
-    } while (0)
-
-// Overlap is defined as the ratio between the time spent
-// to the work over the time spent to do the work in addition
-// of the time for communication
-#define GET_OVERLAP(_overlap, _total_time, _work_time) \
-    do                                                 \
-    {                                                  \
-        _overlap = _work_time / _total_time;           \
-    } while (0)
-
 // All times are in milliseconds
-#define GET_WORK_EQUIVALENCE(x, y, a, b, time, work)            \
+#define GET_WORK_EQUIVALENCE(params, time, work)                \
     do                                                          \
     {                                                           \
         int64_t _w = 1;                                         \
@@ -306,7 +519,7 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
         while (_t < time)                                       \
         {                                                       \
             double _s = MPI_Wtime();                            \
-            do_work(x, y, a, b, _w);                            \
+            overlap_work(params, _w);                           \
             double _e = MPI_Wtime();                            \
             _t = _e - _s;                                       \
             _t *= 1000;                                         \
@@ -338,7 +551,7 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
                 ref_time += rank_ref_times[n];                                                                \
             ref_time /= params->world_size;                                                                   \
             /* Once we have the global reference time, we can estimate the work equivalence */                \
-            GET_WORK_EQUIVALENCE(x, y, a, b, ref_time, work);                                                 \
+            GET_WORK_EQUIVALENCE(params, ref_time, work);                                                     \
             OVERLAP_DEBUG(params, "Work equivalence: %f seconds - %" PRId64 " work units\n", ref_time, work); \
         }                                                                                                     \
                                                                                                               \
@@ -463,6 +676,328 @@ void __no_optimization do_work(double x, double y, double a, double b, int64_t n
         }                                                                                                                                                                     \
     } while (0)
 
+// parse_list_item finds the item of a comma-separated list starting at p, without its surrounding spaces, and returns
+// the beginning of the next item
+static const char *parse_list_item(const char *p, const char **item, size_t *len)
+{
+    const char *end = p;
+
+    while (*end != '\0' && *end != ',')
+        end++;
+    while (p < end && isspace((unsigned char)*p))
+        p++;
+    *item = p;
+    *len = end - p;
+    while (*len > 0 && isspace((unsigned char)p[*len - 1]))
+        (*len)--;
+    return (*end == ',') ? end + 1 : end;
+}
+
+// parse_uint_list parses a comma-separated list of numbers, e.g., "1,10,100,1000", and returns the number of values.
+// Values below min_value and values beyond max_values are ignored.
+static int parse_uint_list(overlap_params_t *params, const char *str, uint64_t min_value, uint64_t *values, int max_values)
+{
+    const char *p = str, *item;
+    size_t len;
+    uint64_t v;
+    int n = 0;
+
+    while (*p != '\0')
+    {
+        p = parse_list_item(p, &item, &len);
+        if (len == 0)
+            continue;
+        if (!isdigit((unsigned char)*item) || (v = strtoull(item, NULL, 10)) < min_value)
+        {
+            if (params->world_rank == 0)
+                fprintf(stderr, "Invalid value '%.*s', ignoring it\n", (int)len, item);
+            continue;
+        }
+        if (n == max_values)
+        {
+            if (params->world_rank == 0)
+                fprintf(stderr, "Too many values, %" PRIu64 " ignored (max: %d)\n", v, max_values);
+            continue;
+        }
+        values[n++] = v;
+    }
+    return n;
+}
+
+static void add_sweep_size(overlap_params_t *params, uint64_t n_elts)
+{
+    int i, j;
+
+    if (n_elts == 0)
+        return;
+
+    if (n_elts >= params->max_elts)
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Sweep size of %" PRIu64 " elements ignored, please enlarge %s\n", n_elts, OVERLAP_MAX_NUM_ELTS_ENVVAR);
+        return;
+    }
+
+    if (params->sweep_n_sizes == MAX_SWEEP_SIZES)
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Too many sweep sizes, %" PRIu64 " elements ignored (max: %d)\n", n_elts, MAX_SWEEP_SIZES);
+        return;
+    }
+
+    // Keep the list sorted and without duplicates
+    for (i = 0; i < params->sweep_n_sizes; i++)
+    {
+        if (params->sweep_sizes[i] == n_elts)
+            return;
+        if (params->sweep_sizes[i] > n_elts)
+            break;
+    }
+    for (j = params->sweep_n_sizes; j > i; j--)
+        params->sweep_sizes[j] = params->sweep_sizes[j - 1];
+    params->sweep_sizes[i] = n_elts;
+    params->sweep_n_sizes++;
+}
+
+// parse_sweep_sizes parses a comma-separated list of number of elements, e.g., "1,10,100,1000"
+static void parse_sweep_sizes(overlap_params_t *params, const char *str)
+{
+    uint64_t sizes[MAX_SWEEP_SIZES];
+    int n, i;
+
+    n = parse_uint_list(params, str, 1, sizes, MAX_SWEEP_SIZES);
+    for (i = 0; i < n; i++)
+        add_sweep_size(params, sizes[i]);
+}
+
+// get_log_spaced_sweep_sizes generates n_points sizes evenly spaced on a log scale between the minimum and maximum number of elements
+static void get_log_spaced_sweep_sizes(overlap_params_t *params, int n_points)
+{
+    int i;
+    double log_min, log_max;
+
+    if (n_points <= 0)
+        return;
+
+    if (n_points == 1 || params->max_elts <= params->min_elts + 1)
+    {
+        add_sweep_size(params, params->min_elts);
+        return;
+    }
+
+    log_min = log((double)params->min_elts);
+    log_max = log((double)(params->max_elts - 1));
+    for (i = 0; i < n_points; i++)
+        add_sweep_size(params, (uint64_t)llround(exp(log_min + (log_max - log_min) * i / (n_points - 1))));
+}
+
+static void add_root(overlap_params_t *params, int root)
+{
+    int i;
+
+    if (root < 0 || root >= params->world_size)
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Root %d is not a valid rank (%d ranks), ignoring it\n", root, params->world_size);
+        return;
+    }
+
+    for (i = 0; i < params->n_roots; i++)
+    {
+        if (params->roots[i] == root)
+            return;
+    }
+
+    if (params->n_roots >= MAX_ROOTS)
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Too many roots, ignoring %d (max: %d)\n", root, MAX_ROOTS);
+        return;
+    }
+
+    params->roots[params->n_roots] = root;
+    params->n_roots++;
+}
+
+// parse_roots parses a list of ranks separated by commas. Besides ranks, the following keywords are supported:
+// 'first' (rank 0), 'mid' (rank in the middle of the communicator, usually in the middle of the collective tree),
+// 'last' (last rank, usually on the node the furthest away from rank 0) and 'all'.
+static void parse_roots(overlap_params_t *params, const char *str)
+{
+    const char *p = str, *item;
+    size_t len;
+    int i;
+
+    while (*p != '\0')
+    {
+        p = parse_list_item(p, &item, &len);
+        if (len == 5 && strncmp(item, "first", len) == 0)
+            add_root(params, 0);
+        else if (len == 3 && strncmp(item, "mid", len) == 0)
+            add_root(params, params->world_size / 2);
+        else if (len == 4 && strncmp(item, "last", len) == 0)
+            add_root(params, params->world_size - 1);
+        else if (len == 3 && strncmp(item, "all", len) == 0)
+        {
+            for (i = 0; i < params->world_size; i++)
+                add_root(params, i);
+        }
+        else if (len > 0 && isdigit((unsigned char)*item))
+            add_root(params, atoi(item));
+        else if (len > 0 && params->world_rank == 0)
+            fprintf(stderr, "Invalid root '%.*s', ignoring it\n", (int)len, item);
+    }
+}
+
+static inline const char *comm_split_name(int comm_split)
+{
+    switch (comm_split)
+    {
+    case COMM_SPLIT_NODE:
+        return "node";
+    case COMM_SPLIT_LEADERS:
+        return "leaders";
+    case COMM_SPLIT_SUBSET:
+        return "subset";
+    default:
+        return "world";
+    }
+}
+
+// parse_comm_splits parses a comma-separated list of communicators: 'node' (ranks sharing the memory of the node of
+// rank 0), 'leaders' (one rank per node) or 'all'
+static void parse_comm_splits(overlap_params_t *params, const char *str)
+{
+    const char *p = str, *item;
+    size_t len;
+
+    while (*p != '\0')
+    {
+        p = parse_list_item(p, &item, &len);
+        if (len == 4 && strncmp(item, "node", len) == 0)
+            params->comm_splits |= 1 << COMM_SPLIT_NODE;
+        else if (len == 7 && strncmp(item, "leaders", len) == 0)
+            params->comm_splits |= 1 << COMM_SPLIT_LEADERS;
+        else if (len == 3 && strncmp(item, "all", len) == 0)
+            params->comm_splits |= (1 << COMM_SPLIT_NODE) | (1 << COMM_SPLIT_LEADERS);
+        else if (len > 0 && params->world_rank == 0)
+            fprintf(stderr, "Invalid communicator '%.*s', ignoring it\n", (int)len, item);
+    }
+}
+
+static void add_comm_size(overlap_params_t *params, int size)
+{
+    int i, j;
+
+    // A communicator of the size of MPI_COMM_WORLD would only repeat the main run
+    if (size < 2 || size >= params->world_size)
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Communicator size %d ignored, it must be between 2 and %d\n", size, params->world_size - 1);
+        return;
+    }
+
+    if (params->n_comm_sizes == MAX_COMM_SIZES)
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Too many communicator sizes, %d ignored (max: %d)\n", size, MAX_COMM_SIZES);
+        return;
+    }
+
+    // Keep the list sorted and without duplicates
+    for (i = 0; i < params->n_comm_sizes; i++)
+    {
+        if (params->comm_sizes[i] == size)
+            return;
+        if (params->comm_sizes[i] > size)
+            break;
+    }
+    for (j = params->n_comm_sizes; j > i; j--)
+        params->comm_sizes[j] = params->comm_sizes[j - 1];
+    params->comm_sizes[i] = size;
+    params->n_comm_sizes++;
+}
+
+// parse_comm_sizes parses a comma-separated list of communicator sizes. The 'auto' keyword selects the powers of two
+// smaller than the number of ranks, as well as the non-power-of-two sizes half-way between them (3, 6, 12...), since
+// collective algorithms often switch to a slower path with non-power-of-two communicators.
+static void parse_comm_sizes(overlap_params_t *params, const char *str)
+{
+    const char *p = str, *item;
+    size_t len;
+    int size;
+
+    while (*p != '\0')
+    {
+        p = parse_list_item(p, &item, &len);
+        if (len == 4 && strncmp(item, "auto", len) == 0)
+        {
+            for (size = 2; size < params->world_size; size *= 2)
+            {
+                add_comm_size(params, size);
+                if (size + size / 2 < params->world_size)
+                    add_comm_size(params, size + size / 2);
+            }
+        }
+        else if (len > 0 && isdigit((unsigned char)*item))
+            add_comm_size(params, atoi(item));
+        else if (len > 0 && params->world_rank == 0)
+            fprintf(stderr, "Invalid communicator size '%.*s', ignoring it\n", (int)len, item);
+    }
+}
+
+static const char *reduce_type_names[MAX_REDUCE_TYPES] = {"double", "float", "int", "int16", "float16"};
+static const char *reduce_op_names[MAX_REDUCE_OPS] = {"sum", "max", "band", "user"};
+
+// parse_name_list parses a comma-separated list of names, e.g., reduction datatypes or operations, into a list of
+// indexes in names, without duplicates
+static int parse_name_list(overlap_params_t *params, const char *str, const char **names, int n_names, int *list)
+{
+    const char *p = str, *item;
+    size_t len;
+    int n = 0;
+    int i, j;
+
+    while (*p != '\0')
+    {
+        p = parse_list_item(p, &item, &len);
+        for (i = 0; i < n_names; i++)
+        {
+            if (strlen(names[i]) == len && strncmp(item, names[i], len) == 0)
+                break;
+        }
+        if (i == n_names)
+        {
+            if (len > 0 && params->world_rank == 0)
+            {
+                fprintf(stderr, "Invalid name '%.*s', ignoring it (valid names:", (int)len, item);
+                for (i = 0; i < n_names; i++)
+                    fprintf(stderr, " %s", names[i]);
+                fprintf(stderr, ")\n");
+            }
+        }
+        else
+        {
+            for (j = 0; j < n && list[j] != i; j++)
+                ;
+            if (j == n)
+                list[n++] = i;
+        }
+    }
+    return n;
+}
+
+// parse_skews parses a comma-separated list of skews in micro-seconds, e.g., "0,10,100,1000"
+static void parse_skews(overlap_params_t *params, const char *str)
+{
+    uint64_t skews[MAX_SKEWS];
+    int i;
+
+    params->n_skews = parse_uint_list(params, str, 0, skews, MAX_SKEWS);
+    for (i = 0; i < params->n_skews; i++)
+        params->skews[i] = (int)skews[i];
+}
+
 static void get_overlap_params(overlap_params_t *params)
 {
     char *min_elts_str = getenv(OVERLAP_MIN_NUM_ELTS_ENVVAR);
@@ -476,8 +1011,31 @@ static void get_overlap_params(overlap_params_t *params)
     char *default_n_iters_str = getenv(OVERLAP_DEFAULT_TDM_N_ITERS_ENVVAR);
     char *overlap_threshold_str = getenv(OVERLAP_ACCEPTANCE_THRESHOLD_ENVVAR);
     char *max_iters_str = getenv(OVERLAP_MAX_TDM_ITERS_ENVVAR);
+    char *sweep_sizes_str = getenv(OVERLAP_SWEEP_SIZES_ENVVAR);
+    char *sweep_points_str = getenv(OVERLAP_SWEEP_POINTS_ENVVAR);
+    char *time_budget_str = getenv(OVERLAP_TIME_BUDGET_ENVVAR);
+    char *seed_elts_str = getenv(OVERLAP_SEED_NUM_ELTS_ENVVAR);
+    char *roots_str = getenv(OVERLAP_ROOTS_ENVVAR);
+    char *skew_str = getenv(OVERLAP_SKEW_ENVVAR);
+    char *skew_pattern_str = getenv(OVERLAP_SKEW_PATTERN_ENVVAR);
+    char *skew_seed_str = getenv(OVERLAP_SKEW_SEED_ENVVAR);
+    char *sync_str = getenv(OVERLAP_SYNC_ENVVAR);
+    char *sync_window_str = getenv(OVERLAP_SYNC_WINDOW_ENVVAR);
+    char *comm_splits_str = getenv(OVERLAP_COMM_SPLITS_ENVVAR);
+    char *comm_sizes_str = getenv(OVERLAP_COMM_SIZES_ENVVAR);
+    char *concurrency_str = getenv(OVERLAP_CONCURRENCY_ENVVAR);
+    char *datatype_str = getenv(OVERLAP_DATATYPE_ENVVAR);
+    char *block_len_str = getenv(OVERLAP_BLOCK_LEN_ENVVAR);
+    char *stride_str = getenv(OVERLAP_STRIDE_ENVVAR);
+    char *reduce_types_str = getenv(OVERLAP_REDUCE_TYPES_ENVVAR);
+    char *reduce_ops_str = getenv(OVERLAP_REDUCE_OPS_ENVVAR);
+    char *user_op_cost_str = getenv(OVERLAP_USER_OP_COST_ENVVAR);
+    char *compute_inflation_str = getenv(OVERLAP_COMPUTE_INFLATION_ENVVAR);
+    char *work_kernel_str = getenv(OVERLAP_WORK_KERNEL_ENVVAR);
+    char *work_cycles_str = getenv(OVERLAP_WORK_CYCLES_ENVVAR);
 
     /* Initialize to default values */
+    params->name = NULL;
     params->verbose = 0;
     params->debug = 0;
     params->calibration = 0;
@@ -487,6 +1045,46 @@ static void get_overlap_params(overlap_params_t *params)
     params->min_elts = DEFAULT_MIN_ELTS;
     params->overlap_threshold = DEFAULT_OVERLAP_THRESHOLD;
     params->max_iters = TDM_MAX_ITERS;
+    params->sweep_n_sizes = 0;
+    params->time_budget = DEFAULT_TIME_BUDGET;
+    params->seed_elts = 0;
+    params->root = 0;
+    params->n_roots = 0;
+    params->skew = 0;
+    params->n_skews = 0;
+    params->skew_pattern = SKEW_PATTERN_LATE_RANK;
+    params->skew_seed = DEFAULT_SKEW_SEED;
+    params->sync_mode = SYNC_MODE_BARRIER;
+    params->sync_window = DEFAULT_SYNC_WINDOW;
+    params->clock_offset = 0.0;
+    params->clock_drift = 0.0;
+    params->clock_ref = 0.0;
+    params->window_start = 0.0;
+    params->window_len = 0.0;
+    params->window_idx = 0;
+    params->window_late = 0;
+    params->prev_time = 0.0;
+    params->prev_n_elts = 0;
+    params->comm = MPI_COMM_WORLD;
+    params->comm_split = COMM_SPLIT_NONE;
+    params->comm_splits = 0;
+    params->n_comm_sizes = 0;
+    params->concurrency = 1;
+    params->slot = 0;
+    params->datatype = DATATYPE_CONTIGUOUS;
+    params->block_len = DEFAULT_BLOCK_LEN;
+    params->stride = 0;
+    params->reduce_type = -1;
+    params->reduce_op = -1;
+    params->n_reduce_types = 0;
+    params->n_reduce_ops = 0;
+    params->user_op_cost = 0;
+    params->cvar_setting = -1;
+    params->compute_inflation = false;
+    params->work_kernel = WORK_KERNEL_FLOPS;
+    params->work_cycles = DEFAULT_WORK_CYCLES;
+    params->work_rate = 0.0;
+    params->callbacks = NULL;
     if (params->data_driven_model)
     {
         params->max_elts = DDM_DEFAULT_MAX_ELTS;
@@ -564,6 +1162,159 @@ static void get_overlap_params(overlap_params_t *params)
         if (v > 0)
             params->max_iters = v;
     }
+
+    if (time_budget_str)
+    {
+        int v = atoi(time_budget_str);
+        if (v > 0)
+            params->time_budget = v;
+    }
+
+    if (seed_elts_str)
+        params->seed_elts = strtoull(seed_elts_str, NULL, 10);
+
+    if (roots_str)
+        parse_roots(params, roots_str);
+
+    if (skew_str)
+        parse_skews(params, skew_str);
+    if (params->n_skews > 0)
+        params->skew = params->skews[0];
+
+    if (skew_pattern_str)
+    {
+        if (strcmp(skew_pattern_str, "late") == 0)
+            params->skew_pattern = SKEW_PATTERN_LATE_RANK;
+        else if (strcmp(skew_pattern_str, "ramp") == 0)
+            params->skew_pattern = SKEW_PATTERN_RAMP;
+        else if (strcmp(skew_pattern_str, "random") == 0)
+            params->skew_pattern = SKEW_PATTERN_RANDOM;
+        else if (params->world_rank == 0)
+            fprintf(stderr, "Invalid skew pattern '%s', using 'late'\n", skew_pattern_str);
+    }
+
+    if (skew_seed_str)
+        params->skew_seed = strtoull(skew_seed_str, NULL, 10);
+
+    if (sync_str)
+    {
+        if (strcmp(sync_str, "barrier") == 0)
+            params->sync_mode = SYNC_MODE_BARRIER;
+        else if (strcmp(sync_str, "window") == 0)
+            params->sync_mode = SYNC_MODE_WINDOW;
+        else if (params->world_rank == 0)
+            fprintf(stderr, "Invalid synchronization method '%s', using 'barrier'\n", sync_str);
+    }
+
+    if (sync_window_str)
+    {
+        int v = atoi(sync_window_str);
+        if (v > 0)
+            params->sync_window = v;
+    }
+
+    if (comm_splits_str)
+        parse_comm_splits(params, comm_splits_str);
+
+    if (comm_sizes_str)
+        parse_comm_sizes(params, comm_sizes_str);
+
+    if (concurrency_str)
+    {
+        int v = atoi(concurrency_str);
+        if (v > MAX_CONCURRENCY)
+        {
+            if (params->world_rank == 0)
+                fprintf(stderr, "Too many concurrent operations, using %d\n", MAX_CONCURRENCY);
+            v = MAX_CONCURRENCY;
+        }
+        if (v > 0)
+            params->concurrency = v;
+    }
+
+    if (datatype_str)
+    {
+        if (strcmp(datatype_str, "contiguous") == 0)
+            params->datatype = DATATYPE_CONTIGUOUS;
+        else if (strcmp(datatype_str, "vector") == 0)
+            params->datatype = DATATYPE_VECTOR;
+        else if (strcmp(datatype_str, "indexed") == 0)
+            params->datatype = DATATYPE_INDEXED;
+        else if (strcmp(datatype_str, "subarray") == 0)
+            params->datatype = DATATYPE_SUBARRAY;
+        else if (params->world_rank == 0)
+            fprintf(stderr, "Invalid datatype '%s', using 'contiguous'\n", datatype_str);
+    }
+
+    if (block_len_str)
+    {
+        int v = atoi(block_len_str);
+        if (v > 0)
+            params->block_len = v;
+    }
+
+    if (reduce_types_str)
+        params->n_reduce_types = parse_name_list(params, reduce_types_str, reduce_type_names, MAX_REDUCE_TYPES, params->reduce_types);
+#ifndef MPIX_C_FLOAT16
+    {
+        int i;
+        for (i = 0; i < params->n_reduce_types; i++)
+        {
+            if (params->reduce_types[i] == REDUCE_TYPE_FLOAT16)
+            {
+                if (params->world_rank == 0)
+                    fprintf(stderr, "float16 is not supported by the MPI library, ignoring it\n");
+                params->reduce_types[i] = params->reduce_types[--params->n_reduce_types];
+                break;
+            }
+        }
+    }
+#endif
+
+    if (reduce_ops_str)
+        params->n_reduce_ops = parse_name_list(params, reduce_ops_str, reduce_op_names, MAX_REDUCE_OPS, params->reduce_ops);
+
+    if (user_op_cost_str)
+    {
+        int v = atoi(user_op_cost_str);
+        if (v >= 0)
+            params->user_op_cost = v;
+    }
+
+    if (compute_inflation_str)
+        params->compute_inflation = atoi(compute_inflation_str) != 0;
+
+    if (work_kernel_str)
+    {
+        if (strcmp(work_kernel_str, "flops") == 0)
+            params->work_kernel = WORK_KERNEL_FLOPS;
+        else if (strcmp(work_kernel_str, "cycles") == 0)
+            params->work_kernel = WORK_KERNEL_CYCLES;
+        else if (params->world_rank == 0)
+            fprintf(stderr, "Invalid work kernel '%s', using 'flops'\n", work_kernel_str);
+    }
+
+    if (work_cycles_str)
+    {
+        int64_t v = atoll(work_cycles_str);
+        if (v > 0)
+            params->work_cycles = v;
+    }
+
+    // Blocks are separated by a gap of the size of a block by default
+    if (stride_str)
+        params->stride = atoi(stride_str);
+    if (params->stride < params->block_len)
+    {
+        if (stride_str && params->world_rank == 0)
+            fprintf(stderr, "Stride of %d elements is smaller than the blocks, using %d\n", params->stride, 2 * params->block_len);
+        params->stride = 2 * params->block_len;
+    }
+
+    if (sweep_sizes_str)
+        parse_sweep_sizes(params, sweep_sizes_str);
+    else if (sweep_points_str)
+        get_log_spaced_sweep_sizes(params, atoi(sweep_points_str));
 }
 
 #define MINMAX(array, sz, min, max) \
@@ -607,6 +1358,81 @@ static void display_overlap_params(overlap_params_t *params, size_t dtsz)
         fprintf(stdout, "Data driven execution: ON\n");
     else
         fprintf(stdout, "Time driven execution: ON\n");
+    if (!params->data_driven_model && params->sweep_n_sizes > 0)
+    {
+        int i;
+        fprintf(stdout, "Sweep sizes (number of elements):");
+        for (i = 0; i < params->sweep_n_sizes; i++)
+            fprintf(stdout, " %" PRIu64, params->sweep_sizes[i]);
+        fprintf(stdout, "\n");
+        fprintf(stdout, "Sweep time budget: %d seconds\n", params->time_budget);
+    }
+    if (!params->data_driven_model && params->seed_elts > 0)
+        fprintf(stdout, "Size search starting point: %" PRIu64 " elements\n", params->seed_elts);
+    if (params->sync_mode == SYNC_MODE_WINDOW)
+        fprintf(stdout, "Synchronization: windows of at least %d micro-seconds\n", params->sync_window);
+    else
+        fprintf(stdout, "Synchronization: barrier\n");
+    if (params->n_skews > 0)
+    {
+        const char *patterns[] = {"late rank", "ramp", "random"};
+        int i;
+        fprintf(stdout, "Skews (micro-seconds):");
+        for (i = 0; i < params->n_skews; i++)
+            fprintf(stdout, " %d", params->skews[i]);
+        fprintf(stdout, "\n");
+        fprintf(stdout, "Skew pattern: %s (seed: %" PRIu64 ")\n", patterns[params->skew_pattern], params->skew_seed);
+    }
+    if (params->n_roots > 0)
+    {
+        int i;
+        fprintf(stdout, "Roots:");
+        for (i = 0; i < params->n_roots; i++)
+            fprintf(stdout, " %d", params->roots[i]);
+        fprintf(stdout, "\n");
+    }
+    if (!params->data_driven_model && params->comm_splits != 0)
+    {
+        int split;
+        fprintf(stdout, "Communicators: world");
+        for (split = COMM_SPLIT_NODE; split <= COMM_SPLIT_LEADERS; split++)
+        {
+            if (params->comm_splits & (1 << split))
+                fprintf(stdout, " %s", comm_split_name(split));
+        }
+        fprintf(stdout, "\n");
+    }
+    if (!params->data_driven_model && params->datatype != DATATYPE_CONTIGUOUS)
+    {
+        const char *datatypes[] = {"contiguous", "vector", "indexed", "subarray"};
+        fprintf(stdout, "Datatype: %s (blocks of %d elements, stride of %d elements)\n", datatypes[params->datatype],
+                params->block_len, params->stride);
+    }
+    if (!params->data_driven_model && params->reduce_type >= 0 && (params->n_reduce_types > 0 || params->n_reduce_ops > 0))
+    {
+        int i;
+        fprintf(stdout, "Reduction datatypes:");
+        for (i = 0; i < params->n_reduce_types; i++)
+            fprintf(stdout, " %s", reduce_type_names[params->reduce_types[i]]);
+        fprintf(stdout, "\nReduction operations:");
+        for (i = 0; i < params->n_reduce_ops; i++)
+            fprintf(stdout, " %s", reduce_op_names[params->reduce_ops[i]]);
+        fprintf(stdout, "\nCost of the user-defined operation: %d work units per element\n", params->user_op_cost);
+    }
+    if (!params->data_driven_model && params->concurrency > 1)
+        fprintf(stdout, "Concurrent operations: %d\n", params->concurrency);
+    if (params->work_kernel == WORK_KERNEL_CYCLES)
+        fprintf(stdout, "Work kernel: cycles (%" PRId64 " cycles per work unit)\n", params->work_cycles);
+    else
+        fprintf(stdout, "Work kernel: flops\n");
+    if (!params->data_driven_model && params->n_comm_sizes > 0)
+    {
+        int i;
+        fprintf(stdout, "Communicator sizes:");
+        for (i = 0; i < params->n_comm_sizes; i++)
+            fprintf(stdout, " %d", params->comm_sizes[i]);
+        fprintf(stdout, "\n");
+    }
     fprintf(stdout, "\n");
 }
 
@@ -700,82 +1526,72 @@ exit_error:
     return ret;
 }
 
+// calibrate_mpi_wait displays, for every size, the cost of the MPI_Test() calls polling a MPI_Iallreduce() until its
+// completion on every rank; overlap_polling is the complete benchmark
 static bool calibrate_mpi_wait(overlap_params_t *params)
 {
-    bool ret = true;
+    bool ret = false;
     uint64_t test_count = 0;
     MPI_Request req;
     MPI_Status status;
-
-    double *val = (double *)malloc(params->max_elts * sizeof(double));
-    if (val == NULL)
-    {
-        ret = false;
-        goto exit_error;
-    }
-    double *result = (double *)malloc(params->max_elts * sizeof(double));
-    if (result == NULL)
-    {
-        ret = false;
-        goto exit_error;
-    }
-
-    int i, j;
+    double *val = NULL;
+    double *result = NULL;
+    uint64_t *total_times = NULL;
+    uint64_t *max_times = NULL;
+    uint64_t *last_times = NULL;
+    uint64_t *test_counts = NULL;
+    uint64_t i;
+    int j;
     int completed;
     uint64_t max_time, last_time, total_time;
     uint64_t start, end, timer;
-    uint64_t *total_times = (uint64_t *)malloc(params->world_size * sizeof(uint64_t));
-    if (total_times == NULL)
-        goto exit_error;
-    uint64_t *max_times = (uint64_t *)malloc(params->world_size * sizeof(uint64_t));
-    if (max_times == NULL)
-        goto exit_error;
-    uint64_t *last_times = (uint64_t *)malloc(params->world_size * sizeof(uint64_t));
-    if (last_times == NULL)
-        goto exit_error;
-    uint64_t *test_counts = (uint64_t *)malloc(params->world_size * sizeof(uint64_t));
-    if (test_counts == NULL)
-        goto exit_error;
+
+    MEMALLOC(val, double, params->max_elts * sizeof(double));
+    MEMALLOC(result, double, params->max_elts * sizeof(double));
+    MEMALLOC(total_times, uint64_t, params->world_size * sizeof(uint64_t));
+    MEMALLOC(max_times, uint64_t, params->world_size * sizeof(uint64_t));
+    MEMALLOC(last_times, uint64_t, params->world_size * sizeof(uint64_t));
+    MEMALLOC(test_counts, uint64_t, params->world_size * sizeof(uint64_t));
 
     for (i = params->min_elts; i <= params->max_elts; i *= 2)
     {
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         // warmup
         for (j = 0; j < 100; j++)
         {
             MPI_CHECK(MPI_Iallreduce(val, result, i, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req));
             MPI_CHECK(MPI_Wait(&req, &status));
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         }
 
+        max_time = 0;
+        last_time = 0;
+        test_count = 0;
+        total_time = 0;
+        MPI_CHECK(MPI_Iallreduce(val, result, i, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req));
+        do
         {
-            max_time = 0;
-            test_count = 0;
-            total_time = 0;
-            MPI_CHECK(MPI_Iallreduce(val, result, i, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req));
-            do
-            {
-                TIMESTAMP(start);
-                MPI_CHECK(MPI_Test(&req, &completed, &status));
-                TIMESTAMP(end);
-                timer = end - start;
-                if (max_time < timer)
-                    max_time = timer;
-                if (completed)
-                    last_time = timer;
-                total_time += timer;
-                test_count++;
-            } while (!completed);
-            MPI_Barrier(MPI_COMM_WORLD);
-        }
-        MPI_Barrier(MPI_COMM_WORLD);
-        MPI_Gather(&total_time, 1, MPI_UINT64_T, total_times, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
-        MPI_Gather(&max_time, 1, MPI_UINT64_T, max_times, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
-        MPI_Gather(&last_time, 1, MPI_UINT64_T, last_times, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
-        MPI_Gather(&test_count, 1, MPI_UINT64_T, test_counts, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+            TIMESTAMP(start);
+            MPI_CHECK(MPI_Test(&req, &completed, &status));
+            TIMESTAMP(end);
+            timer = end - start;
+            if (max_time < timer)
+                max_time = timer;
+            if (completed)
+                last_time = timer;
+            total_time += timer;
+            test_count++;
+        } while (!completed);
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+        MPI_CHECK(MPI_Gather(&total_time, 1, MPI_UINT64_T, total_times, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD));
+        MPI_CHECK(MPI_Gather(&max_time, 1, MPI_UINT64_T, max_times, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD));
+        MPI_CHECK(MPI_Gather(&last_time, 1, MPI_UINT64_T, last_times, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD));
+        MPI_CHECK(MPI_Gather(&test_count, 1, MPI_UINT64_T, test_counts, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD));
 
         if (params->world_rank == 0)
         {
+            fprintf(stdout, "Message size: %" PRIu64 " bytes\n", i * sizeof(double));
             fprintf(stdout, "Total test times per rank (us) - 1 iteration\n");
             for (j = 0; j < params->world_size; j++)
                 fprintf(stdout, "%" PRIu64 " ", total_times[j]);
@@ -788,44 +1604,24 @@ static bool calibrate_mpi_wait(overlap_params_t *params)
 
             fprintf(stdout, "Last test times per rank (us) - 1 iteration\n");
             for (j = 0; j < params->world_size; j++)
-                fprintf(stdout, "%" PRIu64 " ", total_times[j]);
+                fprintf(stdout, "%" PRIu64 " ", last_times[j]);
             fprintf(stdout, "\n");
 
-            fprintf(stdout, "Test counts per rank (us) - 1 iteration\n");
+            fprintf(stdout, "Test counts per rank - 1 iteration\n");
             for (j = 0; j < params->world_size; j++)
                 fprintf(stdout, "%" PRIu64 " ", test_counts[j]);
             fprintf(stdout, "\n");
         }
     }
-
-    if (val)
-        free(val);
-    if (result)
-        free(result);
-    if (total_times)
-        free(total_times);
-    if (max_times)
-        free(max_times);
-    if (last_times)
-        free(last_times);
-    if (test_counts)
-        free(test_counts);
-    ret = false; // debug: should be true
-    return ret;
+    ret = true;
 
 exit_error:
-    if (val)
-        free(val);
-    if (result)
-        free(result);
-    if (total_times)
-        free(total_times);
-    if (max_times)
-        free(max_times);
-    if (last_times)
-        free(last_times);
-    if (test_counts)
-        free(test_counts);
+    MEMFREE(val);
+    MEMFREE(result);
+    MEMFREE(total_times);
+    MEMFREE(max_times);
+    MEMFREE(last_times);
+    MEMFREE(test_counts);
     return ret;
 }
 
@@ -840,30 +1636,211 @@ static bool calibrate_collectives(overlap_params_t *params)
     return true;
 }
 
+// overlap_getenv_int sets *value from the environment variable envvar when it holds an integer of at least min_value,
+// *value keeping its default otherwise, and broadcasts it so that the environment of rank 0 prevails; it must be
+// called by all the ranks of params->comm
+static inline bool overlap_getenv_int(overlap_params_t *params, const char *envvar, int min_value, int *value)
+{
+    char *str = getenv(envvar);
+    if (str != NULL && atoi(str) >= min_value)
+        *value = atoi(str);
+    MPI_CHECK(MPI_Bcast(value, 1, MPI_INT, 0, params->comm));
+    return true;
+
+exit_error:
+    return false;
+}
+
 // sync_params lets us make sure that regardless of the MPI implementation
 // that is used, all ranks have a consistent set of parameters, regardless
-// of how environment variables are handled
+// of how environment variables are handled; it must be called by all the ranks of params->comm
 static inline bool sync_params(overlap_params_t *params)
 {
     if (params == NULL)
         return false;
 
-    MPI_CHECK(MPI_Bcast(&(params->verbose), 1, MPI_C_BOOL, 0, MPI_COMM_WORLD));
-    MPI_CHECK(MPI_Bcast(&(params->debug), 1, MPI_C_BOOL, 0, MPI_COMM_WORLD));
-    MPI_CHECK(MPI_Bcast(&(params->calibration), 1, MPI_C_BOOL, 0, MPI_COMM_WORLD));
-    MPI_CHECK(MPI_Bcast(&(params->min_elts), 1, MPI_INT, 0, MPI_COMM_WORLD));
-    MPI_CHECK(MPI_Bcast(&(params->max_elts), 1, MPI_INT, 0, MPI_COMM_WORLD));
-    MPI_CHECK(MPI_Bcast(&(params->validation_steps), 1, MPI_INT, 0, MPI_COMM_WORLD));
+    MPI_CHECK(MPI_Bcast(&(params->verbose), 1, MPI_C_BOOL, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->debug), 1, MPI_C_BOOL, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->calibration), 1, MPI_C_BOOL, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->min_elts), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->max_elts), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->validation_steps), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->sweep_n_sizes), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(params->sweep_sizes, MAX_SWEEP_SIZES, MPI_UINT64_T, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->time_budget), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->seed_elts), 1, MPI_UINT64_T, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->n_roots), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(params->roots, MAX_ROOTS, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->skew), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->n_skews), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(params->skews, MAX_SKEWS, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->skew_pattern), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->skew_seed), 1, MPI_UINT64_T, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->sync_mode), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->sync_window), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->comm_splits), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->n_comm_sizes), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(params->comm_sizes, MAX_COMM_SIZES, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->concurrency), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->datatype), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->block_len), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->stride), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->n_reduce_types), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(params->reduce_types, MAX_REDUCE_TYPES, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->n_reduce_ops), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(params->reduce_ops, MAX_REDUCE_OPS, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->user_op_cost), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->compute_inflation), 1, MPI_C_BOOL, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->work_kernel), 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&(params->work_cycles), 1, MPI_INT64_T, 0, params->comm));
+    overlap_work_kernel = params->work_kernel;
+    overlap_work_cycles = params->work_cycles;
+    // Every rank has its own random sequence, reproducible from one run to another
+    params->skew_rng_state = params->skew_seed ^ ((uint64_t)(params->world_rank + 1) * 0x9E3779B97F4A7C15ULL);
+    if (params->skew_rng_state == 0)
+        params->skew_rng_state = 0x9E3779B97F4A7C15ULL;
     return true;
 exit_error:
     return false;
 }
 
+// global_time returns the current time (in seconds) on the clock of rank 0
+static inline double global_time(overlap_params_t *params)
+{
+    double t = MPI_Wtime();
+    return t + params->clock_offset + params->clock_drift * (t - params->clock_ref);
+}
+
+// sync_clocks estimates the offset and drift of the local clock against the clock of rank 0. Each rank performs a
+// series of ping-pongs with rank 0 and keeps the exchange with the smallest round-trip time to estimate the offset;
+// this is done twice, SYNC_DRIFT_INTERVAL apart, to estimate the drift.
+static bool sync_clocks(overlap_params_t *params)
+{
+    double offsets[2] = {0.0, 0.0}, mids[2] = {0.0, 0.0};
+    double t_start, t_end, t_root, rtt, best_rtt;
+    int dummy = 0;
+    int round, r, i;
+
+    for (round = 0; round < 2; round++)
+    {
+        if (round > 0)
+        {
+            t_end = MPI_Wtime() + SYNC_DRIFT_INTERVAL;
+            while (MPI_Wtime() < t_end)
+                ;
+        }
+        MPI_CHECK(MPI_Barrier(params->comm));
+
+        for (r = 1; r < params->world_size; r++)
+        {
+            if (params->world_rank == 0)
+            {
+                for (i = 0; i < SYNC_N_PINGPONGS; i++)
+                {
+                    MPI_CHECK(MPI_Recv(&dummy, 1, MPI_INT, r, 0, params->comm, MPI_STATUS_IGNORE));
+                    t_root = MPI_Wtime();
+                    MPI_CHECK(MPI_Send(&t_root, 1, MPI_DOUBLE, r, 0, params->comm));
+                }
+            }
+            else if (params->world_rank == r)
+            {
+                best_rtt = -1.0;
+                for (i = 0; i < SYNC_N_PINGPONGS; i++)
+                {
+                    t_start = MPI_Wtime();
+                    MPI_CHECK(MPI_Send(&dummy, 1, MPI_INT, 0, 0, params->comm));
+                    MPI_CHECK(MPI_Recv(&t_root, 1, MPI_DOUBLE, 0, 0, params->comm, MPI_STATUS_IGNORE));
+                    t_end = MPI_Wtime();
+                    rtt = t_end - t_start;
+                    if (best_rtt < 0 || rtt < best_rtt)
+                    {
+                        best_rtt = rtt;
+                        mids[round] = t_start + rtt / 2;
+                        offsets[round] = t_root - mids[round];
+                    }
+                }
+            }
+        }
+    }
+
+    params->clock_offset = offsets[0];
+    params->clock_ref = mids[0];
+    params->clock_drift = 0.0;
+    if (mids[1] > mids[0])
+        params->clock_drift = (offsets[1] - offsets[0]) / (mids[1] - mids[0]);
+    OVERLAP_DEBUG(params, "Rank %d: clock offset = %e s, drift = %e\n", params->world_rank, params->clock_offset, params->clock_drift);
+    return true;
+exit_error:
+    return false;
+}
+
+// overlap_sync_wait_window waits for the beginning of the current window
+static inline void overlap_sync_wait_window(overlap_params_t *params)
+{
+    double target = params->window_start + params->window_idx * params->window_len;
+    if (global_time(params) > target)
+    {
+        params->window_late++;
+        return;
+    }
+    while (global_time(params) < target)
+        ;
+}
+
+// overlap_sync_start synchronizes the ranks before a series of iterations. With windows, rank 0 picks the start of
+// the first window and the windows are enlarged if too many arrivals were late during the previous series.
+// expected_time is the expected duration of an iteration on rank 0, in milli-seconds (0 if unknown).
+static inline int overlap_sync_start(overlap_params_t *params, double expected_time)
+{
+    double window[2];
+    int total_late = 0;
+
+    if (params->sync_mode != SYNC_MODE_WINDOW)
+        return MPI_Barrier(params->comm);
+
+    MPI_CHECK(MPI_Reduce(&params->window_late, &total_late, 1, MPI_INT, MPI_SUM, 0, params->comm));
+    if (params->world_rank == 0)
+    {
+        if (params->window_idx > 0 && total_late * 100 > (params->window_idx + 1) * params->world_size * SYNC_MAX_LATE_PERCENT)
+        {
+            OVERLAP_DEBUG(params, "%d late arrivals out of %d, enlarging windows\n", total_late, (params->window_idx + 1) * params->world_size);
+            params->sync_window *= 2;
+        }
+        window[1] = (double)params->sync_window / 1000000; // Micro-seconds to seconds
+        if (window[1] < expected_time * SYNC_WINDOW_FACTOR / 1000)
+            window[1] = expected_time * SYNC_WINDOW_FACTOR / 1000;
+        window[0] = global_time(params) + window[1];
+    }
+    MPI_CHECK(MPI_Bcast(window, 2, MPI_DOUBLE, 0, params->comm));
+    params->window_start = window[0];
+    params->window_len = window[1];
+    params->window_idx = 0;
+    params->window_late = 0;
+    overlap_sync_wait_window(params);
+    return MPI_SUCCESS;
+exit_error:
+    return MPI_ERR_OTHER;
+}
+
+// overlap_sync_next synchronizes the ranks between two iterations of a series
+static inline int overlap_sync_next(overlap_params_t *params)
+{
+    if (params->sync_mode != SYNC_MODE_WINDOW)
+        return MPI_Barrier(params->comm);
+
+    params->window_idx++;
+    overlap_sync_wait_window(params);
+    return MPI_SUCCESS;
+}
+
 static bool calibrate(overlap_params_t *params)
 {
     if (!sync_params(params))
         return false;
 
+    if (params->sync_mode == SYNC_MODE_WINDOW && !sync_clocks(params))
+        return false;
+
     if (!params->calibration)
         return true;
 
@@ -873,6 +1850,196 @@ static bool calibrate(overlap_params_t *params)
     return true;
 }
 
+// overlap_datatype_elts returns the number of elements spanned by n_elts elements laid out according to
+// params->datatype, i.e., the extent of the datatype returned by overlap_get_datatype() and the size of the buffers
+static inline uint64_t overlap_datatype_elts(overlap_params_t *params, uint64_t n_elts)
+{
+    uint64_t n_blocks;
+
+    if (params->datatype == DATATYPE_CONTIGUOUS)
+        return n_elts;
+    n_blocks = (n_elts + params->block_len - 1) / params->block_len;
+    return n_blocks * params->stride;
+}
+
+// overlap_get_datatype gets the count and the datatype describing n_elts elements laid out according to
+// params->datatype, the number of elements being rounded up to a whole number of blocks. The non-contiguous datatype
+// of the last size is cached, the previous one being freed when the size changes.
+static inline int overlap_get_datatype(overlap_params_t *params, uint64_t n_elts, int *count, MPI_Datatype *type)
+{
+    static MPI_Datatype cached_type = MPI_DATATYPE_NULL;
+    static uint64_t cached_n_elts = 0;
+    MPI_Datatype layout = MPI_DATATYPE_NULL;
+    int *blocklens = NULL, *displs = NULL;
+    int sizes[2], subsizes[2], starts[2] = {0, 0};
+    int n_blocks, i;
+
+    if (params->datatype == DATATYPE_CONTIGUOUS)
+    {
+        *count = (int)n_elts;
+        *type = MPI_DOUBLE;
+        return MPI_SUCCESS;
+    }
+
+    if (cached_type == MPI_DATATYPE_NULL || n_elts != cached_n_elts)
+    {
+        if (cached_type != MPI_DATATYPE_NULL)
+            MPI_CHECK(MPI_Type_free(&cached_type));
+
+        n_blocks = (int)((n_elts + params->block_len - 1) / params->block_len);
+        switch (params->datatype)
+        {
+        case DATATYPE_VECTOR:
+            MPI_CHECK(MPI_Type_vector(n_blocks, params->block_len, params->stride, MPI_DOUBLE, &layout));
+            break;
+        case DATATYPE_INDEXED:
+            MEMALLOC(blocklens, int, n_blocks * sizeof(int));
+            MEMALLOC(displs, int, n_blocks * sizeof(int));
+            for (i = 0; i < n_blocks; i++)
+            {
+                blocklens[i] = params->block_len;
+                displs[i] = i * params->stride;
+            }
+            MPI_CHECK(MPI_Type_indexed(n_blocks, blocklens, displs, MPI_DOUBLE, &layout));
+            MEMFREE(blocklens);
+            MEMFREE(displs);
+            break;
+        default:
+            sizes[0] = n_blocks;
+            sizes[1] = params->stride;
+            subsizes[0] = n_blocks;
+            subsizes[1] = params->block_len;
+            MPI_CHECK(MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &layout));
+            break;
+        }
+
+        // Consecutive elements of the datatype, e.g., the blocks sent to different ranks, do not overlap
+        MPI_CHECK(MPI_Type_create_resized(layout, 0, (MPI_Aint)(overlap_datatype_elts(params, n_elts) * sizeof(double)), &cached_type));
+        MPI_CHECK(MPI_Type_commit(&cached_type));
+        MPI_CHECK(MPI_Type_free(&layout));
+        cached_n_elts = n_elts;
+    }
+
+    *count = 1;
+    *type = cached_type;
+    return MPI_SUCCESS;
+
+exit_error:
+    MEMFREE(blocklens);
+    MEMFREE(displs);
+    return MPI_ERR_OTHER;
+}
+
+// Operation used by the reductions with REDUCE_OP_USER and its cost, only one at a time since the function of a
+// user-defined operation does not have any context
+static MPI_Op overlap_user_op = MPI_OP_NULL;
+static int overlap_user_op_cost = 0;
+
+// overlap_user_op_fn sums the elements, like MPI_SUM, and injects overlap_user_op_cost work units per element to
+// emulate an expensive operation
+static void overlap_user_op_fn(void *in, void *inout, int *len, MPI_Datatype *type)
+{
+    int i;
+
+    if (*type == MPI_DOUBLE)
+    {
+        for (i = 0; i < *len; i++)
+            ((double *)inout)[i] += ((double *)in)[i];
+    }
+    else if (*type == MPI_FLOAT)
+    {
+        for (i = 0; i < *len; i++)
+            ((float *)inout)[i] += ((float *)in)[i];
+    }
+    else if (*type == MPI_INT)
+    {
+        for (i = 0; i < *len; i++)
+            ((int *)inout)[i] += ((int *)in)[i];
+    }
+    else if (*type == MPI_INT16_T)
+    {
+        for (i = 0; i < *len; i++)
+            ((int16_t *)inout)[i] += ((int16_t *)in)[i];
+    }
+    // Half precision elements are not summed, only their cost is emulated
+
+    if (overlap_user_op_cost > 0)
+        do_work(1.0, 1.0, 1.0, 1.0, (int64_t)*len * overlap_user_op_cost);
+}
+
+// overlap_reduce_create_op creates the user-defined operation when it is part of the operations of the benchmark
+static inline int overlap_reduce_create_op(overlap_params_t *params)
+{
+    int i;
+
+    for (i = 0; i < params->n_reduce_ops; i++)
+    {
+        if (params->reduce_ops[i] == REDUCE_OP_USER)
+        {
+            overlap_user_op_cost = params->user_op_cost;
+            return MPI_Op_create(overlap_user_op_fn, 1, &overlap_user_op);
+        }
+    }
+    return MPI_SUCCESS;
+}
+
+static inline void overlap_reduce_free_op(void)
+{
+    if (overlap_user_op != MPI_OP_NULL)
+        MPI_Op_free(&overlap_user_op);
+}
+
+static inline MPI_Datatype overlap_reduce_datatype(overlap_params_t *params)
+{
+    switch (params->reduce_type)
+    {
+    case REDUCE_TYPE_FLOAT:
+        return MPI_FLOAT;
+    case REDUCE_TYPE_INT:
+        return MPI_INT;
+    case REDUCE_TYPE_INT16:
+        return MPI_INT16_T;
+#ifdef MPIX_C_FLOAT16
+    case REDUCE_TYPE_FLOAT16:
+        return MPIX_C_FLOAT16;
+#endif
+    default:
+        return MPI_DOUBLE;
+    }
+}
+
+static inline MPI_Op overlap_reduce_op(overlap_params_t *params)
+{
+    switch (params->reduce_op)
+    {
+    case REDUCE_OP_MAX:
+        return MPI_MAX;
+    case REDUCE_OP_BAND:
+        return MPI_BAND;
+    case REDUCE_OP_USER:
+        return overlap_user_op;
+    default:
+        return MPI_SUM;
+    }
+}
+
+// overlap_elt_size returns the size of an element in bytes, which depends on the datatype of the reductions
+static inline int overlap_elt_size(overlap_params_t *params)
+{
+    int size = sizeof(double);
+    if (params->reduce_type >= 0)
+        MPI_Type_size(overlap_reduce_datatype(params), &size);
+    return size;
+}
+
+// overlap_reduce_supported returns false for the combinations that are not defined by the MPI standard
+static inline bool overlap_reduce_supported(int reduce_type, int reduce_op)
+{
+    if (reduce_op == REDUCE_OP_BAND)
+        return reduce_type == REDUCE_TYPE_INT || reduce_type == REDUCE_TYPE_INT16;
+    return true;
+}
+
 #define INIT_OVERLAP_STATUS(params, status)                      \
     do                                                           \
     {                                                            \
@@ -883,9 +2050,9 @@ static bool calibrate(overlap_params_t *params)
         status->validation_threshold = params->validation_steps; \
     } while (0)
 
-static int updated_overlap_status(overlap_params_t *params, overlap_status_t *status, double run_time, double ref_time, bool passed, int work_units)
+static int64_t updated_overlap_status(overlap_params_t *params, overlap_status_t *status, double run_time, double ref_time, bool passed, int64_t work_units)
 {
-    OVERLAP_DEBUG(params, "Updating with %d work units (passed=%d)\n", work_units, passed);
+    OVERLAP_DEBUG(params, "Updating with %" PRId64 " work units (passed=%d)\n", work_units, passed);
 
     if (!passed)
     {
@@ -903,19 +2070,19 @@ static int updated_overlap_status(overlap_params_t *params, overlap_status_t *st
             double ratio = run_time / ref_time;
             if (ratio > 10)
             {
-                OVERLAP_DEBUG(params, "Execution time high above target, trying with %d work units\n", work_units / 10);
+                OVERLAP_DEBUG(params, "Execution time high above target, trying with %" PRId64 " work units\n", work_units / 10);
                 status->validation_count = 0;
                 return work_units / 10;
             }
 
             if (ratio > 2)
             {
-                OVERLAP_DEBUG(params, "Execution time high above target, trying with %d work units\n", work_units / 2);
+                OVERLAP_DEBUG(params, "Execution time high above target, trying with %" PRId64 " work units\n", work_units / 2);
                 status->validation_count = 0;
                 return work_units / 2;
             }
 
-            OVERLAP_DEBUG(params, "Running the same configuration again for validation (%d work units)\n", work_units);
+            OVERLAP_DEBUG(params, "Running the same configuration again for validation (%" PRId64 " work units)\n", work_units);
             return work_units;
         }
     }
@@ -959,14 +2126,14 @@ static int updated_overlap_status(overlap_params_t *params, overlap_status_t *st
     if (status->min_invalid_overlap_work_units == -1)
     {
         // We did not figure out yet the higher bound
-        OVERLAP_DEBUG(params, "We did not figure out yet the higher bound (current work units=%d)\n", work_units);
+        OVERLAP_DEBUG(params, "We did not figure out yet the higher bound (current work units=%" PRId64 ")\n", work_units);
         return status->max_valid_overlap_work_units * 2;
     }
 
     if (status->max_valid_overlap_work_units == -1)
     {
         // We did not figure out yet the lower bound
-        OVERLAP_DEBUG(params, "We did not figure out yet the lower bound (current work units=%d)\n", work_units);
+        OVERLAP_DEBUG(params, "We did not figure out yet the lower bound (current work units=%" PRId64 ")\n", work_units);
         /* Compute by how much we need to decrease the time */
         double ratio = run_time / ref_time;
         if (ratio > 10)
@@ -987,7 +2154,7 @@ static int updated_overlap_status(overlap_params_t *params, overlap_status_t *st
     return 0;
 }
 
-static bool check_results(overlap_params_t *params, double ref_time, double *ref_times, double *rank_ref_stdevs, double *rank_times, double *work_times, double *work_stdevs)
+static inline bool check_results(overlap_params_t *params, double ref_time, double *ref_times, double *rank_ref_stdevs, double *rank_times, double *work_times, double *work_stdevs)
 {
     int i;
     double min_stdev, max_stdev;
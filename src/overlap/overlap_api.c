@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Implementation of libopenhpca_overlap (see openhpca_overlap.h): the time driven model of the benchmarks, driven by
+// the callbacks of the application instead of a collective operation of the benchmarks.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "mpi.h"
+#include "openhpca_overlap.h"
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+struct openhpca_overlap_ctx
+{
+    overlap_params_t params; // params.comm is a duplicate of the communicator of the application
+    overlap_callbacks_t callbacks;
+    int n_iters; // 0 for automatic
+};
+
+// Context that has not been freed yet, the search relies on state shared by the whole process (see openhpca_overlap.h)
+static openhpca_overlap_ctx_t openhpca_overlap_live_ctx = NULL;
+
+int openhpca_overlap_get_api_version(void)
+{
+    return OPENHPCA_OVERLAP_API_VERSION;
+}
+
+int openhpca_overlap_create(MPI_Comm comm, openhpca_overlap_ctx_t *ctx)
+{
+    openhpca_overlap_ctx_t c;
+
+    if (ctx == NULL)
+        return OPENHPCA_OVERLAP_ERROR;
+    *ctx = NULL;
+    if (openhpca_overlap_live_ctx != NULL)
+    {
+        fprintf(stderr, "[%s:%d] only one context may exist at a time\n", __func__, __LINE__);
+        return OPENHPCA_OVERLAP_ERROR;
+    }
+
+    c = (openhpca_overlap_ctx_t)calloc(1, sizeof(struct openhpca_overlap_ctx));
+    if (c == NULL)
+        return OPENHPCA_OVERLAP_ERROR;
+    get_overlap_params(&c->params);
+    c->params.name = "libopenhpca_overlap";
+    // The search uses its own communicator so that its synchronizations do not interfere with the application
+    c->params.comm = MPI_COMM_NULL;
+    MPI_CHECK(MPI_Comm_dup(comm, &c->params.comm));
+    MPI_CHECK(MPI_Comm_size(c->params.comm, &c->params.world_size));
+    MPI_CHECK(MPI_Comm_rank(c->params.comm, &c->params.world_rank));
+    // The application posts its own operations, and the calibration of the benchmarks evaluates MPI_Iallreduce() on
+    // MPI_COMM_WORLD, which is irrelevant here
+    c->params.concurrency = 1;
+    c->params.calibration = 0;
+    c->params.callbacks = &c->callbacks;
+    if (!calibrate(&c->params))
+        goto exit_error;
+
+    openhpca_overlap_live_ctx = c;
+    *ctx = c;
+    return OPENHPCA_OVERLAP_SUCCESS;
+
+exit_error:
+    if (c->params.comm != MPI_COMM_NULL)
+        MPI_Comm_free(&c->params.comm);
+    free(c);
+    return OPENHPCA_OVERLAP_ERROR;
+}
+
+int openhpca_overlap_set_callbacks(openhpca_overlap_ctx_t ctx, openhpca_overlap_post_fn_t post,
+                                   openhpca_overlap_wait_fn_t wait, openhpca_overlap_work_fn_t work, void *arg)
+{
+    if (ctx == NULL || post == NULL || wait == NULL)
+        return OPENHPCA_OVERLAP_ERROR;
+    ctx->callbacks.post = post;
+    ctx->callbacks.wait = wait;
+    ctx->callbacks.work = work;
+    ctx->callbacks.arg = arg;
+    return OPENHPCA_OVERLAP_SUCCESS;
+}
+
+int openhpca_overlap_set_iters(openhpca_overlap_ctx_t ctx, int n_iters)
+{
+    if (ctx == NULL || n_iters < 0 || n_iters > MAX_NUM_CALIBRATION_POINTS)
+        return OPENHPCA_OVERLAP_ERROR;
+    ctx->n_iters = n_iters;
+    return OPENHPCA_OVERLAP_SUCCESS;
+}
+
+int openhpca_overlap_run(openhpca_overlap_ctx_t ctx, openhpca_overlap_result_t *result)
+{
+    overlap_params_t *params;
+    tdm_result_t res;
+    double *data = NULL;
+    double stdev, avg_time, values[7];
+    int n_iters;
+
+    if (ctx == NULL || result == NULL || ctx->callbacks.post == NULL)
+        return OPENHPCA_OVERLAP_ERROR;
+    params = &ctx->params;
+    memset(&res, 0, sizeof(res));
+
+    n_iters = ctx->n_iters;
+    if (n_iters == 0)
+    {
+        // Same selection of the number of iterations as the benchmarks, the size of the communication being fixed
+        MEMALLOC(data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
+        if (tdm_get_coll_config_info(params, NULL, data, 0, params->n_iters, 0, &stdev, &avg_time, NULL))
+            goto exit_error;
+        if (params->world_rank == 0)
+        {
+            double required_iters = tdm_required_iters(stdev, avg_time);
+            OVERLAP_DEBUG(params, "Required number of iterations = %.0f\n", required_iters);
+            n_iters = params->n_iters;
+            if (required_iters > n_iters)
+                n_iters = required_iters > params->max_iters ? params->max_iters : (int)required_iters;
+        }
+        MPI_CHECK(MPI_Bcast(&n_iters, 1, MPI_INT, 0, params->comm));
+        MEMFREE(data);
+    }
+
+    if (tdm_overlap(params, NULL, 0, n_iters, 0, &res))
+        goto exit_error;
+    // Results are only recorded for the output of the benchmarks
+    overlap_output_reset();
+
+    values[0] = res.n_iters;
+    values[1] = res.ref_time;
+    values[2] = res.stdev;
+    values[3] = res.work_time;
+    values[4] = res.wait_time;
+    values[5] = res.overlap;
+    values[6] = res.has_inflation ? res.inflation : 0.0;
+    MPI_CHECK(MPI_Bcast(values, 7, MPI_DOUBLE, 0, params->comm));
+    result->n_iters = (int)values[0];
+    result->ref_time = values[1];
+    result->stdev = values[2];
+    result->work_time = values[3];
+    result->wait_time = values[4];
+    result->overlap = values[5];
+    result->inflation = values[6];
+    return OPENHPCA_OVERLAP_SUCCESS;
+
+exit_error:
+    MEMFREE(data);
+    overlap_output_reset();
+    return OPENHPCA_OVERLAP_ERROR;
+}
+
+int openhpca_overlap_free(openhpca_overlap_ctx_t *ctx)
+{
+    if (ctx == NULL || *ctx == NULL)
+        return OPENHPCA_OVERLAP_ERROR;
+    MPI_Comm_free(&(*ctx)->params.comm);
+    if (*ctx == openhpca_overlap_live_ctx)
+        openhpca_overlap_live_ctx = NULL;
+    free(*ctx);
+    *ctx = NULL;
+    return OPENHPCA_OVERLAP_SUCCESS;
+}
@@ -0,0 +1,379 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Latency cost of asynchrony. For every collective operation of the overlap benchmarks and every size, the benchmark
+// compares the latency of the blocking operation (e.g., MPI_Allreduce()), of the non-blocking operation immediately
+// followed by MPI_Wait() (e.g., MPI_Iallreduce()) and of the persistent operation started and immediately completed
+// (e.g., MPI_Allreduce_init() once, then MPI_Start() and MPI_Wait()). No computation is overlapped: the difference is
+// what an application pays for the non-blocking path, which the overlap must make up for. Persistent collectives are
+// only measured with MPI 4.0 or the pcollreq extension of Open MPI.
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#if MPI_VERSION < 4 && defined(OPEN_MPI)
+#include "mpi-ext.h"
+#endif
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+#if MPI_VERSION >= 4
+#define ASYNC_PERSISTENT_INIT(_coll, ...) MPI_##_coll##_init(__VA_ARGS__)
+#elif defined(OMPI_HAVE_MPI_EXT_PCOLLREQ) && OMPI_HAVE_MPI_EXT_PCOLLREQ
+#define ASYNC_PERSISTENT_INIT(_coll, ...) MPIX_##_coll##_init(__VA_ARGS__)
+#else
+#define ASYNC_PERSISTENT_INIT(_coll, ...) MPI_ERR_UNSUPPORTED_OPERATION
+#endif
+
+#define ASYNC_MODE_BLOCKING (0)
+#define ASYNC_MODE_NONBLOCKING (1)
+#define ASYNC_MODE_PERSISTENT (2)
+#define ASYNC_N_MODES (3)
+
+// ASYNC_CALL calls the blocking operation, posts the non-blocking operation or initializes the persistent operation,
+// depending on _mode; the request is req
+#define ASYNC_CALL(_mode, _blocking, _nonblocking, _persistent, ...)            \
+    ((_mode) == ASYNC_MODE_BLOCKING      ? _blocking(__VA_ARGS__)               \
+     : (_mode) == ASYNC_MODE_NONBLOCKING ? _nonblocking(__VA_ARGS__, req)       \
+                                         : ASYNC_PERSISTENT_INIT(_persistent, __VA_ARGS__, MPI_INFO_NULL, req))
+
+#define ASYNC_N_OPS (10)
+#define ASYNC_OP_BARRIER (6)
+#define ASYNC_DEFAULT_ITERS (100)
+#define ASYNC_WARMUP_ITERS (10)
+#define ASYNC_SIZE_FACTOR (8)  // Sizes are multiplied by that factor from min_elts to max_elts unless a sweep is set
+#define ASYNC_SMALL_SIZE (4096) // Largest data size, in bytes, of the small messages summarizing the cost
+#define ASYNC_RECORD_FORMAT "openhpca_async"
+#define ASYNC_RECORD_VERSION (1)
+
+#define OVERLAP_ASYNC_OPS_ENVVAR "OPENHPCA_OVERLAP_ASYNC_OPS"
+#define OVERLAP_ASYNC_ITERS_ENVVAR "OPENHPCA_OVERLAP_ASYNC_ITERS"
+
+static const char *async_op_names[ASYNC_N_OPS] = {"allreduce", "reduce", "allgather", "allgatherv", "alltoall",
+                                                  "alltoallv", "barrier", "bcast", "gather", "gatherv"};
+static const char *async_mode_names[ASYNC_N_MODES] = {"blocking", "nonblocking", "persistent"};
+static const char *async_mode_labels[ASYNC_N_MODES] = {"Blocking", "Non-blocking", "Persistent"};
+
+// Buffers used by the benchmark, allocated in main(); the vector operations exchange the same number of elements with
+// every rank
+static double *s_buf = NULL, *r_buf = NULL;
+static int *counts = NULL, *displs = NULL;
+
+// Latencies of an operation and a size in seconds, averaged over all the ranks; negative when not measured
+typedef struct async_result
+{
+    int op;
+    uint64_t n_elts;
+    double times[ASYNC_N_MODES];
+} async_result_t;
+
+static int async_call(overlap_params_t *params, int op, int mode, uint64_t n_elts, MPI_Request *req)
+{
+    MPI_Comm comm = params->comm;
+
+    switch (op)
+    {
+    case 0:
+        return ASYNC_CALL(mode, MPI_Allreduce, MPI_Iallreduce, Allreduce, s_buf, r_buf, n_elts, MPI_DOUBLE, MPI_SUM,
+                          comm);
+    case 1:
+        return ASYNC_CALL(mode, MPI_Reduce, MPI_Ireduce, Reduce, s_buf, r_buf, n_elts, MPI_DOUBLE, MPI_SUM, 0, comm);
+    case 2:
+        return ASYNC_CALL(mode, MPI_Allgather, MPI_Iallgather, Allgather, s_buf, n_elts, MPI_DOUBLE, r_buf, n_elts,
+                          MPI_DOUBLE, comm);
+    case 3:
+        return ASYNC_CALL(mode, MPI_Allgatherv, MPI_Iallgatherv, Allgatherv, s_buf, n_elts, MPI_DOUBLE, r_buf, counts,
+                          displs, MPI_DOUBLE, comm);
+    case 4:
+        return ASYNC_CALL(mode, MPI_Alltoall, MPI_Ialltoall, Alltoall, s_buf, n_elts, MPI_DOUBLE, r_buf, n_elts,
+                          MPI_DOUBLE, comm);
+    case 5:
+        return ASYNC_CALL(mode, MPI_Alltoallv, MPI_Ialltoallv, Alltoallv, s_buf, counts, displs, MPI_DOUBLE, r_buf,
+                          counts, displs, MPI_DOUBLE, comm);
+    case ASYNC_OP_BARRIER:
+        return ASYNC_CALL(mode, MPI_Barrier, MPI_Ibarrier, Barrier, comm);
+    case 7:
+        return ASYNC_CALL(mode, MPI_Bcast, MPI_Ibcast, Bcast, r_buf, n_elts, MPI_DOUBLE, 0, comm);
+    case 8:
+        return ASYNC_CALL(mode, MPI_Gather, MPI_Igather, Gather, s_buf, n_elts, MPI_DOUBLE, r_buf, n_elts, MPI_DOUBLE,
+                          0, comm);
+    default:
+        return ASYNC_CALL(mode, MPI_Gatherv, MPI_Igatherv, Gatherv, s_buf, n_elts, MPI_DOUBLE, r_buf, counts, displs,
+                          MPI_DOUBLE, 0, comm);
+    }
+}
+
+// async_run executes one operation in the given mode, from the call or the start to the completion
+static inline int async_run(overlap_params_t *params, int op, int mode, uint64_t n_elts, MPI_Request *req)
+{
+    if (mode == ASYNC_MODE_BLOCKING)
+        return async_call(params, op, mode, n_elts, req);
+
+    if (mode == ASYNC_MODE_NONBLOCKING)
+        MPI_CHECK(async_call(params, op, mode, n_elts, req));
+    else
+        MPI_CHECK(MPI_Start(req));
+    MPI_CHECK(MPI_Wait(req, MPI_STATUS_IGNORE));
+    return MPI_SUCCESS;
+
+exit_error:
+    return MPI_ERR_OTHER;
+}
+
+// async_measure measures the latency of an operation in all the modes on the calling rank; it must be called by all
+// the ranks of params->comm
+static int async_measure(overlap_params_t *params, int op, uint64_t n_elts, int n_iters, double *times)
+{
+    MPI_Request req = MPI_REQUEST_NULL;
+    double start, total;
+    int mode, i;
+
+    for (i = 0; i < params->world_size; i++)
+    {
+        counts[i] = n_elts;
+        displs[i] = i * n_elts;
+    }
+
+    for (mode = 0; mode < ASYNC_N_MODES; mode++)
+    {
+        times[mode] = -1.0;
+        if (mode == ASYNC_MODE_PERSISTENT && async_call(params, op, mode, n_elts, &req) != MPI_SUCCESS)
+            continue; // Persistent collectives are not supported
+
+        for (i = 0; i < ASYNC_WARMUP_ITERS; i++)
+            MPI_CHECK(async_run(params, op, mode, n_elts, &req));
+
+        total = 0.0;
+        for (i = 0; i < n_iters; i++)
+        {
+            MPI_CHECK(MPI_Barrier(params->comm));
+            start = MPI_Wtime();
+            MPI_CHECK(async_run(params, op, mode, n_elts, &req));
+            total += MPI_Wtime() - start;
+        }
+        times[mode] = total / n_iters;
+
+        if (mode == ASYNC_MODE_PERSISTENT)
+            MPI_CHECK(MPI_Request_free(&req));
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// async_overhead returns the latency increase of a mode compared to the blocking operation, in percent
+static inline double async_overhead(async_result_t *res, int mode)
+{
+    if (res->times[mode] < 0 || res->times[ASYNC_MODE_BLOCKING] <= 0)
+        return 0.0;
+    return (res->times[mode] - res->times[ASYNC_MODE_BLOCKING]) * 100 / res->times[ASYNC_MODE_BLOCKING];
+}
+
+static void async_display(async_result_t *res)
+{
+    int mode;
+
+    fprintf(stdout, "%s\t%" PRIu64, async_op_names[res->op], res->n_elts * sizeof(double));
+    for (mode = 0; mode < ASYNC_N_MODES; mode++)
+    {
+        if (res->times[mode] < 0)
+            fprintf(stdout, "\tN/A");
+        else
+            fprintf(stdout, "\t%.2f", res->times[mode] * 1e6);
+    }
+    fprintf(stdout, "\t%.1f", async_overhead(res, ASYNC_MODE_NONBLOCKING));
+    if (res->times[ASYNC_MODE_PERSISTENT] < 0)
+        fprintf(stdout, "\tN/A\n");
+    else
+        fprintf(stdout, "\t%.1f\n", async_overhead(res, ASYNC_MODE_PERSISTENT));
+}
+
+static void async_write_json(overlap_params_t *params, async_result_t *results, int n_results, int n_iters,
+                             double *summary, int *n_small, FILE *f)
+{
+    int i, mode;
+
+    overlap_output_record_header(f, ASYNC_RECORD_FORMAT, ASYNC_RECORD_VERSION, "overlap_async", params->world_size);
+    fprintf(f, "\"params\":{\"n_iters\":%d,\"small_size\":%d},\"results\":[", n_iters, ASYNC_SMALL_SIZE);
+    for (i = 0; i < n_results; i++)
+    {
+        async_result_t *res = &results[i];
+        fprintf(f, "%s{\"operation\":\"%s\",\"n_elts\":%" PRIu64 ",\"data_size\":%" PRIu64, i > 0 ? "," : "",
+                async_op_names[res->op], res->n_elts, res->n_elts * sizeof(double));
+        for (mode = 0; mode < ASYNC_N_MODES; mode++)
+        {
+            if (res->times[mode] < 0)
+                fprintf(f, ",\"%s_time\":null", async_mode_names[mode]);
+            else
+                fprintf(f, ",\"%s_time\":%.9g", async_mode_names[mode], res->times[mode] * 1e3);
+        }
+        fprintf(f, ",\"nonblocking_overhead\":%.9g", async_overhead(res, ASYNC_MODE_NONBLOCKING));
+        if (res->times[ASYNC_MODE_PERSISTENT] < 0)
+            fprintf(f, ",\"persistent_overhead\":null}");
+        else
+            fprintf(f, ",\"persistent_overhead\":%.9g}", async_overhead(res, ASYNC_MODE_PERSISTENT));
+    }
+    fprintf(f, "]");
+    for (mode = ASYNC_MODE_NONBLOCKING; mode < ASYNC_N_MODES; mode++)
+    {
+        if (n_small[mode] == 0)
+            fprintf(f, ",\"%s_overhead\":null", async_mode_names[mode]);
+        else
+            fprintf(f, ",\"%s_overhead\":%.9g", async_mode_names[mode], summary[mode]);
+    }
+    fprintf(f, "}\n");
+}
+
+int main(int argc, char **argv)
+{
+    char *ops_str;
+    int ops[ASYNC_N_OPS];
+    int n_ops = ASYNC_N_OPS;
+    int n_iters = ASYNC_DEFAULT_ITERS;
+    uint64_t sizes[MAX_SWEEP_SIZES];
+    int n_sizes = 0;
+    async_result_t *results = NULL;
+    double times[ASYNC_N_MODES];
+    double summary[ASYNC_N_MODES];
+    int n_small[ASYNC_N_MODES];
+    uint64_t n_elts;
+    int n_results = 0;
+    int i, j, mode;
+
+    INIT_OVERLAP_BENCH;
+
+    if (!calibrate(&params))
+        goto exit_error;
+
+    for (i = 0; i < ASYNC_N_OPS; i++)
+        ops[i] = i;
+    ops_str = getenv(OVERLAP_ASYNC_OPS_ENVVAR);
+    if (ops_str)
+        n_ops = parse_name_list(&params, ops_str, async_op_names, ASYNC_N_OPS, ops);
+    // The environment of rank 0 prevails
+    MPI_CHECK(MPI_Bcast(&n_ops, 1, MPI_INT, 0, params.comm));
+    MPI_CHECK(MPI_Bcast(ops, ASYNC_N_OPS, MPI_INT, 0, params.comm));
+    if (!overlap_getenv_int(&params, OVERLAP_ASYNC_ITERS_ENVVAR, 1, &n_iters))
+        goto exit_error;
+
+    if (params.sweep_n_sizes > 0)
+    {
+        for (i = 0; i < params.sweep_n_sizes; i++)
+        {
+            if (params.sweep_sizes[i] <= params.max_elts)
+                sizes[n_sizes++] = params.sweep_sizes[i];
+        }
+    }
+    else
+    {
+        for (n_elts = params.min_elts; n_elts <= params.max_elts && n_sizes < MAX_SWEEP_SIZES;
+             n_elts *= ASYNC_SIZE_FACTOR)
+            sizes[n_sizes++] = n_elts;
+    }
+
+    MEMALLOC(s_buf, double, params.world_size * params.max_elts * sizeof(double));
+    MEMALLOC(r_buf, double, params.world_size * params.max_elts * sizeof(double));
+    MEMALLOC(counts, int, params.world_size * sizeof(int));
+    MEMALLOC(displs, int, params.world_size * sizeof(int));
+    MEMALLOC(results, async_result_t, n_ops * n_sizes * sizeof(async_result_t));
+    memset(s_buf, 0, params.world_size * params.max_elts * sizeof(double));
+
+    if (params.world_rank == 0)
+    {
+        fprintf(stdout, "Latency of the blocking, non-blocking and persistent operations, %d iterations on %d ranks\n",
+                n_iters, params.world_size);
+        fprintf(stdout, "Operation\tSize (bytes)\tBlocking (us)\tNon-blocking (us)\tPersistent (us)\t"
+                        "Non-blocking overhead (%%)\tPersistent overhead (%%)\n");
+    }
+
+    for (i = 0; i < n_ops; i++)
+    {
+        for (j = 0; j < n_sizes; j++)
+        {
+            // The size does not matter for barriers
+            if (ops[i] == ASYNC_OP_BARRIER && j > 0)
+                break;
+            n_elts = ops[i] == ASYNC_OP_BARRIER ? 0 : sizes[j];
+
+            if (async_measure(&params, ops[i], n_elts, n_iters, times))
+                goto exit_error;
+            results[n_results].op = ops[i];
+            results[n_results].n_elts = n_elts;
+            MPI_CHECK(MPI_Reduce(times, results[n_results].times, ASYNC_N_MODES, MPI_DOUBLE, MPI_SUM, 0, params.comm));
+            if (params.world_rank == 0)
+            {
+                for (mode = 0; mode < ASYNC_N_MODES; mode++)
+                {
+                    if (times[mode] < 0)
+                        results[n_results].times[mode] = -1.0;
+                    else
+                        results[n_results].times[mode] /= params.world_size;
+                }
+                async_display(&results[n_results]);
+            }
+            n_results++;
+        }
+    }
+
+    if (params.world_rank == 0)
+    {
+        // The cost of asynchrony is summarized by the average overhead on small messages, where latency dominates
+        for (mode = 0; mode < ASYNC_N_MODES; mode++)
+        {
+            summary[mode] = 0.0; // Always 0 for the blocking operations
+            n_small[mode] = 0;
+        }
+        for (i = 0; i < n_results; i++)
+        {
+            if (results[i].n_elts * sizeof(double) > ASYNC_SMALL_SIZE)
+                continue;
+            for (mode = ASYNC_MODE_NONBLOCKING; mode < ASYNC_N_MODES; mode++)
+            {
+                if (results[i].times[mode] < 0)
+                    continue;
+                summary[mode] += async_overhead(&results[i], mode);
+                n_small[mode]++;
+            }
+        }
+        for (mode = ASYNC_MODE_NONBLOCKING; mode < ASYNC_N_MODES; mode++)
+        {
+            if (n_small[mode] > 0)
+                summary[mode] /= n_small[mode];
+        }
+
+        fprintf(stdout, "\n");
+        for (mode = ASYNC_MODE_NONBLOCKING; mode < ASYNC_N_MODES; mode++)
+        {
+            if (n_small[mode] == 0)
+                fprintf(stdout, "%s overhead (up to %d bytes): N/A\n", async_mode_labels[mode], ASYNC_SMALL_SIZE);
+            else
+                fprintf(stdout, "%s overhead (up to %d bytes): %.1f %%\n", async_mode_labels[mode], ASYNC_SMALL_SIZE,
+                        summary[mode]);
+        }
+        async_write_json(&params, results, n_results, n_iters, summary, n_small, stdout);
+    }
+
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    MEMFREE(counts);
+    MEMFREE(displs);
+    MEMFREE(results);
+    MPI_Finalize();
+    return EXIT_SUCCESS;
+
+exit_error:
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    MEMFREE(counts);
+    MEMFREE(displs);
+    MEMFREE(results);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    return EXIT_FAILURE;
+}
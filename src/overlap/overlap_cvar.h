@@ -0,0 +1,331 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#ifndef OVERLAP_CVAR_H_
+#define OVERLAP_CVAR_H_
+
+// Sweep of the MPI_T control variables (cvars) of the MPI implementation, e.g., the algorithm used by a collective
+// operation, so that all the settings can be evaluated within a single job. OPENHPCA_OVERLAP_CVARS is a
+// semicolon-separated list of cvars with the comma-separated values to evaluate, e.g.,
+// "coll_libnbc_iallreduce_algorithm=1,2". Values are integers or, for enumerated cvars, the names of the items.
+// All the combinations of the values are evaluated; a cvar with a single value is therefore set for all the
+// combinations. The cvars are restored to their initial value at the end of the sweep.
+
+#define OVERLAP_CVARS_ENVVAR "OPENHPCA_OVERLAP_CVARS"
+
+#define MAX_CVARS (8)
+#define MAX_CVAR_VALUES (16)
+#define MAX_CVAR_NAME_LEN (128)
+#define MAX_CVARS_STR_LEN (1024)
+#define MAX_CVAR_SETTING_LEN (256)
+
+typedef struct overlap_cvar
+{
+    char name[MAX_CVAR_NAME_LEN];
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype; // MPI_T_ENUM_NULL if the values are not enumerated
+    MPI_T_cvar_handle handle;
+    long long initial_value;
+    long long values[MAX_CVAR_VALUES];
+    int n_values;
+    int cur; // Index of the value of the current combination
+} overlap_cvar_t;
+
+typedef struct overlap_cvars
+{
+    bool enabled;
+    int n_cvars;
+    overlap_cvar_t cvars[MAX_CVARS];
+} overlap_cvars_t;
+
+// Only one benchmark per binary, the cvars are therefore global
+static overlap_cvars_t overlap_cvars;
+
+static inline bool overlap_cvar_supported(MPI_Datatype datatype, int bind, int scope)
+{
+    if (bind != MPI_T_BIND_NO_OBJECT || scope == MPI_T_SCOPE_CONSTANT || scope == MPI_T_SCOPE_READONLY)
+        return false;
+    return datatype == MPI_INT || datatype == MPI_UNSIGNED || datatype == MPI_UNSIGNED_LONG ||
+           datatype == MPI_UNSIGNED_LONG_LONG || datatype == MPI_COUNT;
+}
+
+static inline int overlap_cvar_read(overlap_cvar_t *cvar, long long *value)
+{
+    union
+    {
+        int i;
+        unsigned u;
+        unsigned long ul;
+        unsigned long long ull;
+        MPI_Count c;
+    } buf;
+    int rc = MPI_T_cvar_read(cvar->handle, &buf);
+    if (rc != MPI_SUCCESS)
+        return rc;
+
+    if (cvar->datatype == MPI_INT)
+        *value = buf.i;
+    else if (cvar->datatype == MPI_UNSIGNED)
+        *value = buf.u;
+    else if (cvar->datatype == MPI_UNSIGNED_LONG)
+        *value = buf.ul;
+    else if (cvar->datatype == MPI_UNSIGNED_LONG_LONG)
+        *value = buf.ull;
+    else
+        *value = buf.c;
+    return MPI_SUCCESS;
+}
+
+static inline int overlap_cvar_write(overlap_cvar_t *cvar, long long value)
+{
+    union
+    {
+        int i;
+        unsigned u;
+        unsigned long ul;
+        unsigned long long ull;
+        MPI_Count c;
+    } buf;
+
+    if (cvar->datatype == MPI_INT)
+        buf.i = value;
+    else if (cvar->datatype == MPI_UNSIGNED)
+        buf.u = value;
+    else if (cvar->datatype == MPI_UNSIGNED_LONG)
+        buf.ul = value;
+    else if (cvar->datatype == MPI_UNSIGNED_LONG_LONG)
+        buf.ull = value;
+    else
+        buf.c = value;
+    return MPI_T_cvar_write(cvar->handle, &buf);
+}
+
+// overlap_cvar_parse_value parses a value of a cvar, either an integer or the name of an item of its enumeration
+static inline bool overlap_cvar_parse_value(MPI_T_enum enumtype, const char *str, long long *value)
+{
+    char name[MAX_CVAR_NAME_LEN];
+    char *end;
+    int i, n_items, len, item_value;
+
+    *value = strtoll(str, &end, 0);
+    if (end != str && *end == '\0')
+        return true;
+
+    if (enumtype == MPI_T_ENUM_NULL)
+        return false;
+    len = MAX_CVAR_NAME_LEN;
+    if (MPI_T_enum_get_info(enumtype, &n_items, name, &len) != MPI_SUCCESS)
+        return false;
+    for (i = 0; i < n_items; i++)
+    {
+        len = MAX_CVAR_NAME_LEN;
+        if (MPI_T_enum_get_item(enumtype, i, &item_value, name, &len) == MPI_SUCCESS && strcmp(name, str) == 0)
+        {
+            *value = item_value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// overlap_cvar_parse parses a "name=value,value" entry of OPENHPCA_OVERLAP_CVARS and allocates the handle of the cvar
+static inline bool overlap_cvar_parse(overlap_params_t *params, char *entry, overlap_cvar_t *cvar, int num_cvars)
+{
+    char name[MAX_CVAR_NAME_LEN], desc[1];
+    char *values = strchr(entry, '=');
+    char *value, *saveptr = NULL;
+    int i, name_len, desc_len, verbosity, bind, scope, count;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+
+    if (values == NULL || values == entry || values - entry >= MAX_CVAR_NAME_LEN)
+        return false;
+    *values++ = '\0';
+    strcpy(cvar->name, entry);
+
+    for (i = 0; i < num_cvars; i++)
+    {
+        name_len = MAX_CVAR_NAME_LEN;
+        desc_len = 0;
+        if (MPI_T_cvar_get_info(i, name, &name_len, &verbosity, &datatype, &enumtype, desc, &desc_len, &bind, &scope) == MPI_SUCCESS &&
+            strcmp(name, cvar->name) == 0)
+            break;
+    }
+    if (i == num_cvars)
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Unknown control variable: %s\n", cvar->name);
+        return false;
+    }
+    if (!overlap_cvar_supported(datatype, bind, scope))
+    {
+        if (params->world_rank == 0)
+            fprintf(stderr, "Control variable %s cannot be set at runtime\n", cvar->name);
+        return false;
+    }
+    if (MPI_T_cvar_handle_alloc(i, NULL, &cvar->handle, &count) != MPI_SUCCESS)
+        return false;
+    cvar->datatype = datatype;
+    cvar->enumtype = enumtype;
+    if (count != 1 || overlap_cvar_read(cvar, &cvar->initial_value) != MPI_SUCCESS)
+    {
+        MPI_T_cvar_handle_free(&cvar->handle);
+        return false;
+    }
+
+    cvar->n_values = 0;
+    cvar->cur = 0;
+    for (value = strtok_r(values, ",", &saveptr); value != NULL; value = strtok_r(NULL, ",", &saveptr))
+    {
+        if (cvar->n_values == MAX_CVAR_VALUES || !overlap_cvar_parse_value(enumtype, value, &cvar->values[cvar->n_values]))
+        {
+            if (params->world_rank == 0)
+                fprintf(stderr, "Invalid value for %s: %s\n", cvar->name, value);
+            MPI_T_cvar_handle_free(&cvar->handle);
+            return false;
+        }
+        cvar->n_values++;
+    }
+    if (cvar->n_values == 0)
+    {
+        MPI_T_cvar_handle_free(&cvar->handle);
+        return false;
+    }
+    return true;
+}
+
+// overlap_cvar_init parses OPENHPCA_OVERLAP_CVARS. The string of rank 0 is broadcast so that all the ranks set the
+// same cvars. It must be called by all the ranks of MPI_COMM_WORLD.
+static inline int overlap_cvar_init(overlap_params_t *params)
+{
+    char str[MAX_CVARS_STR_LEN] = "";
+    char *entry, *saveptr = NULL;
+    int num_cvars = 0, provided, valid = 1;
+
+    overlap_cvars.enabled = false;
+    overlap_cvars.n_cvars = 0;
+    if (params->world_rank == 0 && getenv(OVERLAP_CVARS_ENVVAR) != NULL)
+    {
+        if (strlen(getenv(OVERLAP_CVARS_ENVVAR)) >= MAX_CVARS_STR_LEN)
+            fprintf(stderr, "%s is too long\n", OVERLAP_CVARS_ENVVAR);
+        else
+            strcpy(str, getenv(OVERLAP_CVARS_ENVVAR));
+    }
+    MPI_CHECK(MPI_Bcast(str, MAX_CVARS_STR_LEN, MPI_CHAR, 0, MPI_COMM_WORLD));
+    if (str[0] == '\0')
+        return 0;
+
+    MPI_CHECK(MPI_T_init_thread(MPI_THREAD_SINGLE, &provided));
+    MPI_CHECK(MPI_T_cvar_get_num(&num_cvars));
+    for (entry = strtok_r(str, ";", &saveptr); entry != NULL && valid; entry = strtok_r(NULL, ";", &saveptr))
+    {
+        if (overlap_cvars.n_cvars == MAX_CVARS || !overlap_cvar_parse(params, entry, &overlap_cvars.cvars[overlap_cvars.n_cvars], num_cvars))
+        {
+            valid = 0;
+            break;
+        }
+        overlap_cvars.n_cvars++;
+    }
+    // All the ranks must agree, the cvars may not be available on all the ranks
+    MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &valid, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD));
+    overlap_cvars.enabled = true;
+    if (!valid)
+        goto exit_error;
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+static inline void overlap_cvar_fini()
+{
+    int i;
+    if (!overlap_cvars.enabled)
+        return;
+    for (i = 0; i < overlap_cvars.n_cvars; i++)
+        MPI_T_cvar_handle_free(&overlap_cvars.cvars[i].handle);
+    MPI_T_finalize();
+    overlap_cvars.enabled = false;
+    overlap_cvars.n_cvars = 0;
+}
+
+// overlap_cvar_next moves to the next combination of values, returns false when all the combinations have been
+// evaluated
+static inline bool overlap_cvar_next()
+{
+    int i;
+    for (i = overlap_cvars.n_cvars - 1; i >= 0; i--)
+    {
+        if (++overlap_cvars.cvars[i].cur < overlap_cvars.cvars[i].n_values)
+            return true;
+        overlap_cvars.cvars[i].cur = 0;
+    }
+    return false;
+}
+
+// overlap_cvar_apply sets the cvars to the values of the current combination
+static inline int overlap_cvar_apply()
+{
+    int i;
+    for (i = 0; i < overlap_cvars.n_cvars; i++)
+        MPI_CHECK(overlap_cvar_write(&overlap_cvars.cvars[i], overlap_cvars.cvars[i].values[overlap_cvars.cvars[i].cur]));
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// overlap_cvar_restore sets the cvars back to their initial value
+static inline int overlap_cvar_restore()
+{
+    int i;
+    for (i = 0; i < overlap_cvars.n_cvars; i++)
+    {
+        MPI_CHECK(overlap_cvar_write(&overlap_cvars.cvars[i], overlap_cvars.cvars[i].initial_value));
+        overlap_cvars.cvars[i].cur = 0;
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// overlap_cvar_value_name gets the name of the item of the enumeration of a cvar matching a value, returns false if
+// the cvar is not enumerated or no item matches
+static inline bool overlap_cvar_value_name(overlap_cvar_t *cvar, long long value, char *name, int len)
+{
+    int i, n_items, name_len = len, item_value;
+
+    if (cvar->enumtype == MPI_T_ENUM_NULL || MPI_T_enum_get_info(cvar->enumtype, &n_items, name, &name_len) != MPI_SUCCESS)
+        return false;
+    for (i = 0; i < n_items; i++)
+    {
+        name_len = len;
+        if (MPI_T_enum_get_item(cvar->enumtype, i, &item_value, name, &name_len) == MPI_SUCCESS && item_value == value)
+            return true;
+    }
+    return false;
+}
+
+// overlap_cvar_setting describes the current combination, e.g., "coll_libnbc_iallreduce_algorithm=ring"
+static inline void overlap_cvar_setting(char *setting, size_t len)
+{
+    char name[MAX_CVAR_NAME_LEN];
+    overlap_cvar_t *cvar;
+    size_t n = 0;
+    int i;
+    setting[0] = '\0';
+    for (i = 0; i < overlap_cvars.n_cvars && n < len; i++)
+    {
+        cvar = &overlap_cvars.cvars[i];
+        if (overlap_cvar_value_name(cvar, cvar->values[cvar->cur], name, MAX_CVAR_NAME_LEN))
+            n += snprintf(&setting[n], len - n, "%s%s=%s", i > 0 ? " " : "", cvar->name, name);
+        else
+            n += snprintf(&setting[n], len - n, "%s%s=%lld", i > 0 ? " " : "", cvar->name, cvar->values[cvar->cur]);
+    }
+}
+
+#endif // OVERLAP_CVAR_H_
@@ -99,6 +99,8 @@ ddm_data_process(overlap_params_t *params, double *rank_times)
         MPI_Gather(&post_total, 1, MPI_DOUBLE, post_totals, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);                                                                              \
                                                                                                                                                                             \
         total_time = ddm_data_process(params, rank_times);                                                                                                                  \
+        int64_t _probe_work = work;                                                                                                                                         \
+        int _probe_validations = overlap_status.validation_count;                                                                                                           \
         PROCESS_DATA;                                                                                                                                                       \
         if (params->world_rank == 0 && total_time <= ref_time + stdev)                                                                                                      \
         {                                                                                                                                                                   \
@@ -147,12 +149,22 @@ ddm_data_process(overlap_params_t *params, double *rank_times)
             memcpy(final_post_totals, post_totals, params->world_size * sizeof(double));                                                                                    \
         }                                                                                                                                                                   \
                                                                                                                                                                             \
+        /* Times of the probes are recorded in milli-seconds per iteration, like under the time driven model */                                                             \
+        if (params->world_rank == 0)                                                                                                                                        \
+            overlap_output_add_probe(params, n_elts, _probe_work, total_time * 1000 / n_iters, (ref_time + stdev) * 1000 / n_iters, total_time <= ref_time + stdev,         \
+                                     _probe_validations + 1);                                                                                                               \
+                                                                                                                                                                            \
         if (work == -1)                                                                                                                                                     \
         {                                                                                                                                                                   \
             PRINT_STATS;                                                                                                                                                    \
             if (!ddm_compute_overlap(params, &overlap_status, ref_time, rank_ref_times, rank_ref_stdevs, final_rank_times, final_work_totals, final_work_stdevs, &overlap)) \
                 goto exit_error;                                                                                                                                            \
             fprintf(stdout, "%ld\t%f\n", n_elts * sizeof(double), overlap);                                                                                                 \
+            if (params->world_rank == 0)                                                                                                                                    \
+            {                                                                                                                                                               \
+                overlap_output_result_t _r = {n_elts, n_iters, -1.0, -1.0, -1.0, -1.0, overlap, -1.0, true, 0, 0};                                                          \
+                overlap_output_add_result(params, &_r);                                                                                                                     \
+            }                                                                                                                                                               \
         }                                                                                                                                                                   \
     } while (0)
 
@@ -0,0 +1,371 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Data-parallel training pattern. The gradients of a transformer model become available in reverse layer order during
+// the backward pass and, like the data-parallel frameworks do, are packed into buckets of a given size, each bucket
+// being reduced with MPI_Iallreduce() as soon as it is full while the backward pass goes on. The benchmark measures the
+// step time of that pattern, the time of the backward pass alone and the time of the bucket reductions alone; the
+// exposed communication time is the part of the step not spent computing and the hidden share is the part of the
+// communication that the backward pass covered. Unlike the overlap of a single collective operation, the result
+// depends on the number and the sizes of the buckets and on how the MPI library progresses several operations in
+// flight.
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+#define DLTRAIN_N_MODELS (4)
+#define DLTRAIN_TENSORS_PER_LAYER (12)
+#define DLTRAIN_MAX_POSITIONS (512)
+#define DLTRAIN_DEFAULT_MODEL (1)                    // bert-base
+#define DLTRAIN_DEFAULT_BUCKET_SIZE (25 * 1024 * 1024) // in bytes, default bucket size of the data-parallel frameworks
+#define DLTRAIN_DEFAULT_COMPUTE_RATIO (100)          // Backward pass time, in percent of the time of the reductions
+#define DLTRAIN_DEFAULT_ITERS (10)
+#define DLTRAIN_WARMUP_ITERS (2)
+#define DLTRAIN_RECORD_FORMAT "openhpca_dltrain"
+#define DLTRAIN_RECORD_VERSION (1)
+
+#define OVERLAP_DLTRAIN_MODEL_ENVVAR "OPENHPCA_OVERLAP_DLTRAIN_MODEL"
+#define OVERLAP_DLTRAIN_HIDDEN_ENVVAR "OPENHPCA_OVERLAP_DLTRAIN_HIDDEN"
+#define OVERLAP_DLTRAIN_LAYERS_ENVVAR "OPENHPCA_OVERLAP_DLTRAIN_LAYERS"
+#define OVERLAP_DLTRAIN_VOCAB_ENVVAR "OPENHPCA_OVERLAP_DLTRAIN_VOCAB"
+#define OVERLAP_DLTRAIN_BUCKET_SIZE_ENVVAR "OPENHPCA_OVERLAP_DLTRAIN_BUCKET_SIZE"
+#define OVERLAP_DLTRAIN_COMPUTE_RATIO_ENVVAR "OPENHPCA_OVERLAP_DLTRAIN_COMPUTE_RATIO"
+#define OVERLAP_DLTRAIN_ITERS_ENVVAR "OPENHPCA_OVERLAP_DLTRAIN_ITERS"
+
+// Typical transformer models: hidden size, number of layers and size of the vocabulary
+typedef struct dltrain_model
+{
+    int hidden;
+    int layers;
+    int vocab;
+} dltrain_model_t;
+
+static const dltrain_model_t dltrain_models[DLTRAIN_N_MODELS] = {
+    {256, 4, 8192},    // tiny
+    {768, 12, 30522},  // bert-base
+    {1024, 24, 50257}, // gpt2-medium
+    {1024, 24, 30522}, // bert-large
+};
+static const char *dltrain_model_names[DLTRAIN_N_MODELS] = {"tiny", "bert-base", "gpt2-medium", "bert-large"};
+
+typedef struct dltrain_params
+{
+    int model; // Index in dltrain_models, the sizes can be overridden
+    int hidden;
+    int layers;
+    int vocab;
+    int64_t bucket_size; // in bytes
+    int compute_ratio;   // in percent
+    int n_iters;
+} dltrain_params_t;
+
+// Gradients of the model in the order of the backward pass, i.e., from the last layer to the embeddings, and buckets
+// they are packed into; every bucket is a contiguous range of the gradient buffer
+typedef struct dltrain_layout
+{
+    int n_tensors;
+    int64_t *tensor_elts;
+    int *tensor_bucket; // Bucket the tensor completes, -1 if the bucket still expects other tensors
+    int n_buckets;
+    int64_t *bucket_offset;
+    int64_t *bucket_elts;
+    int64_t n_elts;
+} dltrain_layout_t;
+
+// dltrain_layer_tensors sets the number of elements of the tensors of a transformer layer in the order of the backward
+// pass: the layer normalization and the MLP, then the attention
+static void dltrain_layer_tensors(int64_t h, int64_t *elts)
+{
+    const int64_t tensors[DLTRAIN_TENSORS_PER_LAYER] = {
+        h, h,                 // Output layer normalization (bias and weight)
+        h, 4 * h * h,         // Second linear layer of the MLP
+        4 * h, 4 * h * h,     // First linear layer of the MLP
+        h, h,                 // Attention layer normalization
+        h, h * h,             // Output projection of the attention
+        3 * h, 3 * h * h,     // Query, key and value projections
+    };
+    memcpy(elts, tensors, sizeof(tensors));
+}
+
+// dltrain_build_layout lists the gradients of the model in the order of the backward pass and packs them into buckets
+// of at most bucket_size bytes; a tensor larger than a bucket gets its own bucket
+static int dltrain_build_layout(dltrain_params_t *dl, dltrain_layout_t *layout)
+{
+    int64_t h = dl->hidden, bucket_elts = dl->bucket_size / sizeof(float), current = 0;
+    int i, l;
+
+    memset(layout, 0, sizeof(*layout));
+    if (bucket_elts < 1)
+        bucket_elts = 1;
+    // Final layer normalization, the layers and the embeddings (words and positions)
+    layout->n_tensors = 2 + dl->layers * DLTRAIN_TENSORS_PER_LAYER + 2;
+    MEMALLOC(layout->tensor_elts, int64_t, layout->n_tensors * sizeof(int64_t));
+    MEMALLOC(layout->tensor_bucket, int, layout->n_tensors * sizeof(int));
+    MEMALLOC(layout->bucket_offset, int64_t, layout->n_tensors * sizeof(int64_t));
+    MEMALLOC(layout->bucket_elts, int64_t, layout->n_tensors * sizeof(int64_t));
+
+    layout->tensor_elts[0] = h;
+    layout->tensor_elts[1] = h;
+    for (l = 0; l < dl->layers; l++)
+        dltrain_layer_tensors(h, &layout->tensor_elts[2 + l * DLTRAIN_TENSORS_PER_LAYER]);
+    layout->tensor_elts[layout->n_tensors - 2] = DLTRAIN_MAX_POSITIONS * h;
+    layout->tensor_elts[layout->n_tensors - 1] = (int64_t)dl->vocab * h;
+
+    for (i = 0; i < layout->n_tensors; i++)
+    {
+        int64_t elts = layout->tensor_elts[i];
+        layout->tensor_bucket[i] = -1;
+        // The current bucket is closed when the tensor does not fit
+        if (current > 0 && current + elts > bucket_elts)
+        {
+            layout->tensor_bucket[i - 1] = layout->n_buckets;
+            layout->bucket_offset[layout->n_buckets] = layout->n_elts - current;
+            layout->bucket_elts[layout->n_buckets] = current;
+            layout->n_buckets++;
+            current = 0;
+        }
+        current += elts;
+        layout->n_elts += elts;
+    }
+    layout->tensor_bucket[layout->n_tensors - 1] = layout->n_buckets;
+    layout->bucket_offset[layout->n_buckets] = layout->n_elts - current;
+    layout->bucket_elts[layout->n_buckets] = current;
+    layout->n_buckets++;
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+static void dltrain_free_layout(dltrain_layout_t *layout)
+{
+    MEMFREE(layout->tensor_elts);
+    MEMFREE(layout->tensor_bucket);
+    MEMFREE(layout->bucket_offset);
+    MEMFREE(layout->bucket_elts);
+}
+
+// Buffers used by the benchmark, allocated in main(); the gradients are reduced in place
+static float *grads = NULL;
+static MPI_Request *reqs = NULL;
+
+// dltrain_reset_grads sets the gradients back to the same values before a step; reduced in place step after step,
+// they would grow as world_size^steps and end up as infinities, which some reduction offloads handle on a slower path
+static void dltrain_reset_grads(dltrain_layout_t *layout)
+{
+    int64_t i;
+    for (i = 0; i < layout->n_elts; i++)
+        grads[i] = 1.0f;
+}
+
+// dltrain_step runs a step of the pattern: the backward pass computes the gradient of every tensor for a time
+// proportional to its size and posts the reduction of a bucket as soon as it is complete, the reductions being
+// progressed between the tensors like the frameworks do from their communication thread. work_per_elt is in
+// nano-seconds per element; with comm false only the backward pass is executed and with a null work_per_elt only the
+// reductions.
+static int dltrain_step(overlap_params_t *params, dltrain_layout_t *layout, double work_per_elt, bool comm)
+{
+    int i, b, flag;
+
+    for (i = 0; i < layout->n_tensors; i++)
+    {
+        if (work_per_elt > 0)
+            overlap_work(params, tdm_work_units(params, (int64_t)(layout->tensor_elts[i] * work_per_elt)));
+        if (!comm)
+            continue;
+        b = layout->tensor_bucket[i];
+        if (b >= 0)
+            MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, &grads[layout->bucket_offset[b]], (int)layout->bucket_elts[b],
+                                     MPI_FLOAT, MPI_SUM, params->comm, &reqs[b]));
+        MPI_CHECK(MPI_Testall(layout->n_buckets, reqs, &flag, MPI_STATUSES_IGNORE));
+    }
+    if (comm)
+        MPI_CHECK(MPI_Waitall(layout->n_buckets, reqs, MPI_STATUSES_IGNORE));
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// dltrain_measure returns the average time of a step on the slowest rank (on rank 0)
+static int dltrain_measure(overlap_params_t *params, dltrain_layout_t *layout, int n_iters, double work_per_elt,
+                           bool comm, double *time)
+{
+    double start, total = 0.0;
+    int i;
+
+    for (i = 0; i < DLTRAIN_WARMUP_ITERS; i++)
+    {
+        dltrain_reset_grads(layout);
+        if (dltrain_step(params, layout, work_per_elt, comm))
+            goto exit_error;
+    }
+    for (i = 0; i < n_iters; i++)
+    {
+        dltrain_reset_grads(layout);
+        MPI_CHECK(MPI_Barrier(params->comm));
+        start = MPI_Wtime();
+        if (dltrain_step(params, layout, work_per_elt, comm))
+            goto exit_error;
+        total += MPI_Wtime() - start;
+    }
+    total /= n_iters;
+    MPI_CHECK(MPI_Reduce(&total, time, 1, MPI_DOUBLE, MPI_MAX, 0, params->comm));
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// dltrain_get_params reads the parameters from the environment of rank 0; it must be called by all the ranks
+static bool dltrain_get_params(overlap_params_t *params, dltrain_params_t *dl)
+{
+    char *model_str = getenv(OVERLAP_DLTRAIN_MODEL_ENVVAR);
+    char *bucket_size_str = getenv(OVERLAP_DLTRAIN_BUCKET_SIZE_ENVVAR);
+    int i;
+
+    dl->model = DLTRAIN_DEFAULT_MODEL;
+    dl->bucket_size = DLTRAIN_DEFAULT_BUCKET_SIZE;
+    dl->compute_ratio = DLTRAIN_DEFAULT_COMPUTE_RATIO;
+    dl->n_iters = DLTRAIN_DEFAULT_ITERS;
+
+    if (model_str)
+    {
+        for (i = 0; i < DLTRAIN_N_MODELS; i++)
+        {
+            if (strcmp(model_str, dltrain_model_names[i]) == 0)
+                break;
+        }
+        if (i < DLTRAIN_N_MODELS)
+            dl->model = i;
+        else if (params->world_rank == 0)
+            fprintf(stderr, "Unknown model '%s', using '%s'\n", model_str, dltrain_model_names[dl->model]);
+    }
+    if (bucket_size_str && atoll(bucket_size_str) > 0)
+        dl->bucket_size = atoll(bucket_size_str);
+    // The environment of rank 0 prevails
+    MPI_CHECK(MPI_Bcast(&dl->model, 1, MPI_INT, 0, params->comm));
+    MPI_CHECK(MPI_Bcast(&dl->bucket_size, 1, MPI_INT64_T, 0, params->comm));
+
+    // The sizes of the model are the defaults of the overrides
+    dl->hidden = dltrain_models[dl->model].hidden;
+    dl->layers = dltrain_models[dl->model].layers;
+    dl->vocab = dltrain_models[dl->model].vocab;
+    return overlap_getenv_int(params, OVERLAP_DLTRAIN_HIDDEN_ENVVAR, 1, &dl->hidden) &&
+           overlap_getenv_int(params, OVERLAP_DLTRAIN_LAYERS_ENVVAR, 1, &dl->layers) &&
+           overlap_getenv_int(params, OVERLAP_DLTRAIN_VOCAB_ENVVAR, 1, &dl->vocab) &&
+           overlap_getenv_int(params, OVERLAP_DLTRAIN_COMPUTE_RATIO_ENVVAR, 0, &dl->compute_ratio) &&
+           overlap_getenv_int(params, OVERLAP_DLTRAIN_ITERS_ENVVAR, 1, &dl->n_iters);
+
+exit_error:
+    return false;
+}
+
+static void dltrain_write_json(overlap_params_t *params, dltrain_params_t *dl, dltrain_layout_t *layout,
+                               double step_time, double compute_time, double comm_time, double exposed_time,
+                               double hidden, FILE *f)
+{
+    int b;
+
+    overlap_output_record_header(f, DLTRAIN_RECORD_FORMAT, DLTRAIN_RECORD_VERSION, "overlap_dltrain", params->world_size);
+    fprintf(f, "\"params\":{\"model\":\"%s\",\"hidden\":%d,\"layers\":%d,\"vocab\":%d,\"bucket_size\":%" PRId64
+               ",\"compute_ratio\":%d,\"n_iters\":%d},",
+            dltrain_model_names[dl->model], dl->hidden, dl->layers, dl->vocab, dl->bucket_size, dl->compute_ratio,
+            dl->n_iters);
+    fprintf(f, "\"n_params\":%" PRId64 ",\"buckets\":[", layout->n_elts);
+    for (b = 0; b < layout->n_buckets; b++)
+        fprintf(f, "%s%" PRId64, b > 0 ? "," : "", layout->bucket_elts[b] * (int64_t)sizeof(float));
+    fprintf(f, "],\"step_time\":%.9g,\"compute_time\":%.9g,\"comm_time\":%.9g,\"exposed_time\":%.9g,\"hidden\":%.9g}\n",
+            step_time * 1e3, compute_time * 1e3, comm_time * 1e3, exposed_time * 1e3, hidden);
+}
+
+int main(int argc, char **argv)
+{
+    dltrain_params_t dl;
+    dltrain_layout_t layout;
+    tdm_result_t calibration;
+    double comm_time = 0.0, compute_time = 0.0, step_time = 0.0, exposed_time, hidden;
+    double work_per_elt = 0.0;
+    int64_t b;
+
+    memset(&layout, 0, sizeof(layout));
+    INIT_OVERLAP_BENCH;
+
+    if (!calibrate(&params))
+        goto exit_error;
+
+    if (!dltrain_get_params(&params, &dl))
+        goto exit_error;
+    if (dltrain_build_layout(&dl, &layout))
+        goto exit_error;
+
+    MEMALLOC(grads, float, layout.n_elts * sizeof(float));
+    MEMALLOC(reqs, MPI_Request, layout.n_buckets * sizeof(MPI_Request));
+    for (b = 0; b < layout.n_buckets; b++)
+        reqs[b] = MPI_REQUEST_NULL;
+
+    if (params.world_rank == 0)
+    {
+        fprintf(stdout, "Model: %s (hidden size: %d, layers: %d, vocabulary: %d), %" PRId64 " parameters\n",
+                dltrain_model_names[dl.model], dl.hidden, dl.layers, dl.vocab, layout.n_elts);
+        fprintf(stdout, "Buckets: %d of at most %" PRId64 " bytes, %d iterations on %d ranks\n", layout.n_buckets,
+                dl.bucket_size, dl.n_iters, params.world_size);
+    }
+
+    // The reductions alone, posted back to back as the buckets would be
+    if (dltrain_measure(&params, &layout, dl.n_iters, 0.0, true, &comm_time))
+        goto exit_error;
+
+    // The backward pass lasts compute_ratio percent of the reductions; every rank calibrates its own work units
+    MPI_CHECK(MPI_Bcast(&comm_time, 1, MPI_DOUBLE, 0, params.comm));
+    memset(&calibration, 0, sizeof(calibration));
+    if (dl.compute_ratio > 0)
+    {
+        if (tdm_calibrate_work(&params, comm_time * 1e3 * dl.compute_ratio / 100, &calibration))
+            goto exit_error;
+        work_per_elt = comm_time * 1e9 * dl.compute_ratio / 100 / layout.n_elts;
+        if (dltrain_measure(&params, &layout, dl.n_iters, work_per_elt, false, &compute_time))
+            goto exit_error;
+    }
+    if (dltrain_measure(&params, &layout, dl.n_iters, work_per_elt, true, &step_time))
+        goto exit_error;
+
+    if (params.world_rank == 0)
+    {
+        exposed_time = step_time - compute_time;
+        if (exposed_time < 0)
+            exposed_time = 0.0;
+        hidden = comm_time > 0 ? (comm_time - exposed_time) * 100 / comm_time : 0.0;
+        if (hidden < 0)
+            hidden = 0.0;
+
+        fprintf(stdout, "Communication time (reductions alone): %.3f ms\n", comm_time * 1e3);
+        fprintf(stdout, "Compute time (backward pass alone): %.3f ms\n", compute_time * 1e3);
+        fprintf(stdout, "Step time: %.3f ms\n", step_time * 1e3);
+        fprintf(stdout, "Exposed communication time: %.3f ms\n", exposed_time * 1e3);
+        fprintf(stdout, "Hidden communication: %.1f %%\n", hidden);
+        dltrain_write_json(&params, &dl, &layout, step_time, compute_time, comm_time, exposed_time, hidden, stdout);
+    }
+
+    MEMFREE(grads);
+    MEMFREE(reqs);
+    dltrain_free_layout(&layout);
+    MPI_Finalize();
+    return EXIT_SUCCESS;
+
+exit_error:
+    MEMFREE(grads);
+    MEMFREE(reqs);
+    dltrain_free_layout(&layout);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    return EXIT_FAILURE;
+}
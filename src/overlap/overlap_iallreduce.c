@@ -10,6 +10,9 @@
 
 #include "mpi.h"
 #include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
 #include "overlap_ddm.h"
 #include "overlap_tdm.h"
 
@@ -17,8 +20,6 @@
     do                      \
     {                       \
         FINI_OVERLAP_BENCH; \
-        MEMFREE(val);       \
-        MEMFREE(result);    \
     } while (0)
 
 volatile double x = 1.0, y = 1.0, a = 1.0, b = 1.0;
@@ -40,7 +41,7 @@ int data_driven_loop(overlap_params_t *params, double *val, double *result)
         wait_total = 0.0;
         post_total = 0.0;
         total_time = 0.0;
-        MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+        MPI_CHECK(overlap_sync_start(params, 0)); // Make sure to sync ranks before moving on, we don't want late arrivals
         // We mimic the loop to gather data so we can make meaning full comparisons
         for (n = 0; n < n_iters; n++)
         {
@@ -61,7 +62,7 @@ int data_driven_loop(overlap_params_t *params, double *val, double *result)
             work_total += end_work - start_work;
             wait_total += end_time - start_wait;
             post_total += end_post - start_time;
-            MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+            MPI_CHECK(overlap_sync_next(params)); // Make sure to sync ranks before moving on, we don't want late arrivals
         }
 
         COMPUTE_REQUIRED_WORK;
@@ -72,6 +73,7 @@ int data_driven_loop(overlap_params_t *params, double *val, double *result)
             work_total = 0.0;
             wait_total = 0.0;
             post_total = 0.0;
+            MPI_CHECK(overlap_sync_start(params, ref_time * 1000 / n_iters)); // ref_time is the total time of the reference loop, in seconds
             // Warm up
             for (n = 0; n < warmup; n++)
             {
@@ -84,7 +86,7 @@ int data_driven_loop(overlap_params_t *params, double *val, double *result)
                 start_wait = MPI_Wtime();
                 MPI_CHECK(MPI_Wait(&req, &status));
                 end_time = MPI_Wtime();
-                MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+                MPI_CHECK(overlap_sync_next(params)); // Make sure to sync ranks before moving on, we don't want late arrivals
             }
 
             // Actual benchmarking loop
@@ -107,7 +109,7 @@ int data_driven_loop(overlap_params_t *params, double *val, double *result)
                 work_total += end_work - start_work;
                 wait_total += end_time - start_wait;
                 post_total += end_post - start_time;
-                MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+                MPI_CHECK(overlap_sync_next(params)); // Make sure to sync ranks before moving on, we don't want late arrivals
             }
 
             DDM_GATHER_AND_PROCESS_DATA;
@@ -125,145 +127,14 @@ exit_error:
     return 1;
 }
 
-static inline int
-get_coll_config_info(overlap_params_t *params, double *val, double *result, double *data, int n_elts, int num_iters, int work, double *op_stdev, double *avg_time)
-{
-    double stdev, time_sum = 0;
-    double work_start_time, end_time;
-    double work_end_time; // Not used but minics what done in main benchmark loop
-    int i;
-    MPI_Request req;
-    MPI_Status status;
-    for (i = 0; i < num_iters; i++)
-    {
-        MPI_Barrier(MPI_COMM_WORLD);
-        MPI_CHECK(MPI_Iallreduce(val, result, n_elts, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req));
-        work_start_time = MPI_Wtime();
-        do_work(x, y, a, b, work);
-        work_end_time = MPI_Wtime();
-        MPI_CHECK(MPI_Wait(&req, &status));
-        end_time = MPI_Wtime();
-        data[i] = (end_time - work_start_time) * 1000; // In milli-seconds
-        time_sum += end_time - work_start_time;
-    }
-    time_sum *= 1000; // To milliseconds
-
-    STDEV(data, num_iters, stdev);
-    *op_stdev = stdev;
-    *avg_time = time_sum / num_iters;
-    return 0;
-exit_error:
-    return 1;
-}
+// Buffers used by the benchmark, allocated in main(), with a slot of receive buffer per concurrent operation
+static double *val = NULL, *result = NULL;
 
-int time_driven_loop(overlap_params_t *params, double *val, double *result)
+static int
+post_iallreduce(overlap_params_t *params, uint64_t n_elts, MPI_Request *req)
 {
-    double avg_wait_time = 0, work_time, final_work_time;
-    double *calibration_data;
-    int64_t ref_work;
-    TDM_VARIABLES
-    INIT_OVERLAP_LOOP
-    n_elts = 1;
-    n_iters = TDM_DEFAULT_N_ITERS;
-    INIT_OVERLAP_STATUS(params, (&overlap_status));
-    MEMALLOC(calibration_data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
-
-    // Find the size that gives an execution time close to the cutoff
-    do
-    {
-        get_coll_config_info(params, val, result, data, n_elts, 5, 0, &stdev, &avg_wait_time);
-        if (params->world_rank == 0 && avg_wait_time < params->cutoff_time)
-        {
-            CHECK_N_ELTS(n_elts, params->max_elts, avg_wait_time);
-            n_elts *= 2;
-        }
-
-        MPI_CHECK(MPI_Bcast(&avg_wait_time, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Bcast(&n_elts, 8, MPI_BYTE, 0, MPI_COMM_WORLD));
-    } while (avg_wait_time < params->cutoff_time);
-
-    if (params->world_rank == 0)
-        OVERLAP_DEBUG(params, "Will be using %" PRIu64 " elts (time = %f)\n", n_elts, avg_wait_time);
-
-    while (!done)
-    {
-        double required_iters;
-        do
-        {
-            // We gather some basic data using the default amount of iterations.
-            // Based on the resulting execution time and standard deviation, we calculate how much iterations would
-            // be necessary to have relevant results. If the number of iterations is within our limit, we use that
-            // configuration, otherwise we recursively increase the amount of data.
-            get_coll_config_info(params, val, result, data, n_elts, n_iters, 0, &stdev, &avg_wait_time);
-            if (params->world_rank == 0)
-            {
-                // 1.645 is the critical value for a 90% confidence
-                required_iters = pow((1.645 * stdev) / (avg_wait_time / 10), 2);
-                OVERLAP_DEBUG(params, "Required number of iterations = %.0f (%" PRIu64 " elts)\n", required_iters, n_elts);
-                if (required_iters > MAX_NUM_CALIBRATION_POINTS)
-                {
-                    CHECK_N_ELTS(n_elts, params->max_elts, avg_wait_time);
-                    n_elts *= 2;
-                }
-                else
-                {
-                    if (required_iters > n_iters)
-                        n_iters = (int)required_iters;
-                    if (required_iters > params->max_iters)
-                        n_iters = params->max_iters;
-                }
-            }
-
-            MPI_CHECK(MPI_Bcast(&n_iters, 1, MPI_INT, 0, MPI_COMM_WORLD));
-            MPI_CHECK(MPI_Bcast(&n_elts, 8, MPI_BYTE, 0, MPI_COMM_WORLD));
-        } while (required_iters > MAX_NUM_CALIBRATION_POINTS);
-
-        if (n_iters > MAX_NUM_CALIBRATION_POINTS)
-            MPI_Abort(MPI_COMM_WORLD, 1);
-        done = true;
-    }
-
-    // Get the reference time and stdev based on the final configuration
-    get_coll_config_info(params, val, result, data, n_elts, n_iters, 0, &stdev, &ref_time);
-    MEMFREE(calibration_data);
-    TDM_SET_ITERS_AND_ELTS
-
-    // Run the benchmark loop
-    while (work > 0)
-    {
-        // Actual benchmarking loop
-        if (params->world_rank == 0)
-            OVERLAP_DEBUG(params, "Benchmark loop for work = %" PRId64 "\n", work);
-        total_time = 0.0;
-        work_time = 0.0;
-        MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
-        for (n = 0; n < n_iters; n++)
-        {
-            MPI_CHECK(MPI_Iallreduce(val, result, n_elts, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req));
-            start_work = MPI_Wtime();
-            do_work(x, y, a, b, work);
-            end_work = MPI_Wtime();
-            MPI_CHECK(MPI_Wait(&req, &status));
-            end_time = MPI_Wtime();
-            total_time += end_time - start_work;
-            work_time += end_work - start_work;
-            MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
-        }
-        total_time *= 1000; // To milliseconds
-        work_time *= 1000;  // To milliseconds
-
-        TDM_PROCESS_DATA
-        MPI_CHECK(MPI_Bcast(&work, 8, MPI_BYTE, 0, MPI_COMM_WORLD));
-    }
-
-    TDM_COMPUTE_OVERLAP
-    FREEMEM;
-    return 0;
-
-exit_error:
-    FREEMEM;
-    MPI_Abort(MPI_COMM_WORLD, 1);
-    return 1;
+    return MPI_Iallreduce(val, SLOT_BUF(result, params, params->max_elts), n_elts, overlap_reduce_datatype(params),
+                          overlap_reduce_op(params), params->comm, req);
 }
 
 int main(int argc, char **argv)
@@ -271,19 +142,26 @@ int main(int argc, char **argv)
     INIT_OVERLAP_BENCH;
 
     // All the variables necessary for iallreduce
-    double *result = NULL;
-    double *val = NULL;
     MEMALLOC(val, double, params.max_elts * sizeof(double));
-    MEMALLOC(result, double, params.max_elts * sizeof(double));
+    MEMALLOC(result, double, params.max_elts * params.concurrency * sizeof(double));
+    // Zeroed so that every datatype and operation of the sweep reduces valid values, buffers sized for MPI_DOUBLE are
+    // large enough for all the datatypes
+    memset(val, 0, params.max_elts * sizeof(double));
+    memset(result, 0, params.max_elts * params.concurrency * sizeof(double));
+    params.reduce_type = REDUCE_TYPE_DOUBLE;
+    params.reduce_op = REDUCE_OP_SUM;
 
     if (params.data_driven_model)
         rc = data_driven_loop(&params, val, result);
     else
-        rc = time_driven_loop(&params, val, result);
+        rc = time_driven_loop(&params, post_iallreduce);
 
     if (rc)
         goto exit_error;
 
+    MEMFREE(val);
+    MEMFREE(result);
+    overlap_output_write(&params);
     MPI_Finalize();
     return (EXIT_SUCCESS);
 
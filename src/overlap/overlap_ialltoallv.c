@@ -10,6 +10,9 @@
 
 #include "mpi.h"
 #include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
 #include "overlap_ddm.h"
 #include "overlap_tdm.h"
 
@@ -17,12 +20,6 @@
     do                      \
     {                       \
         FINI_OVERLAP_BENCH; \
-        MEMFREE(s_buf);     \
-        MEMFREE(r_buf);     \
-        MEMFREE(s_counts);  \
-        MEMFREE(r_counts);  \
-        MEMFREE(s_disps);   \
-        MEMFREE(r_disps);   \
         MEMFREE(ref_data);  \
         MEMFREE(data);      \
     } while (0)
@@ -73,7 +70,7 @@ int data_driven_loop(overlap_params_t *params, double *s_buf, double *r_buf, int
         wait_total = 0.0;
         post_total = 0.0;
         total_time = 0.0;
-        MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+        MPI_CHECK(overlap_sync_start(params, 0)); // Make sure to sync ranks before moving on, we don't want late arrivals
         // We mimic the loop to gather data so we can make meaning full comparisons
         for (n = 0; n < n_iters; n++)
         {
@@ -96,7 +93,7 @@ int data_driven_loop(overlap_params_t *params, double *s_buf, double *r_buf, int
             work_total += end_work - start_work;
             wait_total += end_time - start_wait;
             post_total += end_post - start_time;
-            MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+            MPI_CHECK(overlap_sync_next(params)); // Make sure to sync ranks before moving on, we don't want late arrivals
         }
 
         COMPUTE_REQUIRED_WORK;
@@ -107,6 +104,7 @@ int data_driven_loop(overlap_params_t *params, double *s_buf, double *r_buf, int
             work_total = 0.0;
             wait_total = 0.0;
             post_total = 0.0;
+            MPI_CHECK(overlap_sync_start(params, ref_time * 1000 / n_iters)); // ref_time is the total time of the reference loop, in seconds
             // Warm up
             for (n = 0; n < warmup; n++)
             {
@@ -121,7 +119,7 @@ int data_driven_loop(overlap_params_t *params, double *s_buf, double *r_buf, int
                 start_wait = MPI_Wtime();
                 MPI_CHECK(MPI_Wait(&req, &status));
                 end_time = MPI_Wtime();
-                MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+                MPI_CHECK(overlap_sync_next(params)); // Make sure to sync ranks before moving on, we don't want late arrivals
             }
 
             // Actual benchmarking loop
@@ -146,7 +144,7 @@ int data_driven_loop(overlap_params_t *params, double *s_buf, double *r_buf, int
                 work_total += end_work - start_work;
                 wait_total += end_time - start_wait;
                 post_total += end_post - start_time;
-                MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
+                MPI_CHECK(overlap_sync_next(params)); // Make sure to sync ranks before moving on, we don't want late arrivals
             }
 
             DDM_GATHER_AND_PROCESS_DATA;
@@ -164,183 +162,54 @@ exit_error:
     return 1;
 }
 
-static inline int
-get_coll_config_info(overlap_params_t *params, double *s_buf, double *r_buf, int *s_counts, int *r_counts, int *s_disps, int *r_disps, double *data, int num_iters, int work, double *op_stdev, double *avg_time)
-{
-    double stdev, time_sum = 0;
-    double work_start_time, end_time;
-    double work_end_time; // Not used but minics what done in main benchmark loop
-    int i;
-    MPI_Request req;
-    MPI_Status status;
-
-    // Warmup
-    for (i = 0; i < 5; i++)
-    {
-        MPI_CHECK(MPI_Ialltoallv(s_buf, s_counts, s_disps, MPI_DOUBLE,
-                                 r_buf, r_counts, r_disps, MPI_DOUBLE,
-                                 MPI_COMM_WORLD, &req));
-    }
-
-    for (i = 0; i < num_iters; i++)
-    {
-        MPI_Barrier(MPI_COMM_WORLD);
-        MPI_CHECK(MPI_Ialltoallv(s_buf, s_counts, s_disps, MPI_DOUBLE,
-                                 r_buf, r_counts, r_disps, MPI_DOUBLE,
-                                 MPI_COMM_WORLD, &req));
-        work_start_time = MPI_Wtime();
-        do_work(x, y, a, b, work);
-        work_end_time = MPI_Wtime(); // Not used but minics what done in main benchmark loop
-        MPI_CHECK(MPI_Wait(&req, &status));
-        end_time = MPI_Wtime();
-        data[i] = (end_time - work_start_time) * 1000; // In milli-seconds
-        time_sum += end_time - work_start_time;
-    }
-    time_sum *= 1000; // To milliseconds
+// Buffers used by the benchmark, allocated in main(), with a slot of receive buffer per concurrent operation
+static double *s_buf = NULL, *r_buf = NULL;
+static int *s_counts = NULL, *r_counts = NULL, *s_disps = NULL, *r_disps = NULL;
+static uint64_t counts_n_elts = 0;
+static int counts_size = 0, counts_rank = -1;
 
-    STDEV(data, num_iters, stdev);
-    *op_stdev = stdev;
-    *avg_time = time_sum / num_iters;
-    return 0;
-exit_error:
-    return 1;
-}
-
-int time_driven_loop(overlap_params_t *params, double *s_buf, double *r_buf, int *s_counts, int *r_counts, int *s_disps, int *r_disps)
+static int
+post_ialltoallv(overlap_params_t *params, uint64_t n_elts, MPI_Request *req)
 {
-    double avg_wait_time = 0, work_time, final_work_time;
-    int64_t ref_work;
-    int i;
-    double *calibration_data;
-    TDM_VARIABLES
-    INIT_OVERLAP_LOOP
-    n_elts = 1;
-    n_iters = TDM_DEFAULT_N_ITERS;
-    INIT_OVERLAP_STATUS(params, (&overlap_status));
-    MEMALLOC(calibration_data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
+    MPI_Datatype type;
+    int count, rc, i;
 
-    // Find the size that gives an execution time close to the cutoff
-    do
+    rc = overlap_get_datatype(params, n_elts, &count, &type);
+    if (rc != MPI_SUCCESS)
+        return rc;
+
+    // Prepare the alltoallv parameters when the data size or the communicator changes
+    if (n_elts != counts_n_elts || params->world_size != counts_size || params->world_rank != counts_rank)
     {
-        // Prepare the alltoallv parameters for the current data size
         for (i = 0; i < params->world_size; i++)
         {
             if (i == params->world_rank)
                 s_counts[i] = 0;
             else
-                s_counts[i] = n_elts;
+                s_counts[i] = count;
         }
         for (i = 0; i < params->world_size; i++)
         {
             if (i == params->world_rank)
                 r_counts[i] = 0;
             else
-                r_counts[i] = n_elts;
+                r_counts[i] = count;
         }
 
         s_disps[0] = 0;
         for (i = 1; i < params->world_size; i++)
             s_disps[i] = s_disps[i - 1] + s_counts[i - 1];
         r_disps[0] = 0;
-        for (i = 0; i < params->world_size; i++)
-            r_disps[i] = r_disps[i - 1] + r_disps[i - 1];
-
-        get_coll_config_info(params, s_buf, r_buf, s_counts, r_counts, s_disps, r_disps, calibration_data, 5, 0, &stdev, &avg_wait_time);
-        if (params->world_rank == 0 && avg_wait_time < params->cutoff_time)
-        {
-            CHECK_N_ELTS(n_elts, params->max_elts, avg_wait_time);
-            n_elts *= 2;
-        }
-
-        MPI_CHECK(MPI_Bcast(&avg_wait_time, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Bcast(&n_elts, 8, MPI_BYTE, 0, MPI_COMM_WORLD));
-    } while (avg_wait_time < params->cutoff_time);
-
-    if (params->world_rank == 0)
-        OVERLAP_DEBUG(params, "Will be using %" PRIu64 " elts (time = %f)\n", n_elts, avg_wait_time);
-
-    while (!done)
-    {
-        double required_iters;
-        do
-        {
-            // We gather some basic data using the default amount of iterations.
-            // Based on the resulting execution time and standard deviation, we calculate how much iterations would
-            // be necessary to have relevant results. If the number of iterations is within our limit, we use that
-            // configuration, otherwise we recursively increase the amount of data.
-            get_coll_config_info(params, s_buf, r_buf, s_counts, r_counts, s_disps, r_disps, calibration_data, n_iters, 0, &stdev, &avg_wait_time);
-            if (params->world_rank == 0)
-            {
-                // 1.645 is the critical value for a 90% confidence
-                required_iters = pow((1.645 * stdev) / (avg_wait_time / 10), 2);
-                OVERLAP_DEBUG(params, "Required number of iterations = %.0f (%" PRIu64 " elts)\n", required_iters, n_elts);
-                if (required_iters > MAX_NUM_CALIBRATION_POINTS)
-                {
-                    CHECK_N_ELTS(n_elts, params->max_elts, avg_wait_time);
-                    n_elts *= 2;
-                }
-                else
-                {
-                    if (required_iters > n_iters)
-                        n_iters = (int)required_iters;
-                    if (required_iters > params->max_iters)
-                        n_iters = params->max_iters;
-                }
-            }
-            
-            MPI_CHECK(MPI_Bcast(&n_iters, 1, MPI_INT, 0, MPI_COMM_WORLD));
-            MPI_CHECK(MPI_Bcast(&n_elts, 8, MPI_BYTE, 0, MPI_COMM_WORLD));
-        } while (required_iters > MAX_NUM_CALIBRATION_POINTS);
-
-        if (n_iters > MAX_NUM_CALIBRATION_POINTS)
-            MPI_Abort(MPI_COMM_WORLD, 1);
-        done = true;
-    }
-
-    // Get the reference time and stdev based on the final configuration
-    get_coll_config_info(params, s_buf, r_buf, s_counts, r_counts, s_disps, r_disps, calibration_data, n_iters, 0, &stdev, &ref_time);
-    MEMFREE(calibration_data);
-    TDM_SET_ITERS_AND_ELTS
-
-    // Run the benchmark loop
-    while (work > 0)
-    {
-        // Actual benchmarking loop
-        if (params->world_rank == 0)
-            OVERLAP_DEBUG(params, "Benchmark loop for work = %" PRId64 "\n", work);
-        total_time = 0.0;
-        work_time = 0.0;
-        MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
-        for (n = 0; n < n_iters; n++)
-        {
-            MPI_CHECK(MPI_Ialltoallv(s_buf, s_counts, s_disps, MPI_DOUBLE,
-                                     r_buf, r_counts, r_disps, MPI_DOUBLE,
-                                     MPI_COMM_WORLD, &req));
-            start_work = MPI_Wtime();
-            do_work(x, y, a, b, work);
-            end_work = MPI_Wtime();
-            MPI_CHECK(MPI_Wait(&req, &status));
-            end_time = MPI_Wtime();
-            total_time += end_time - start_work;
-            work_time += end_work - start_work;
-            MPI_Barrier(MPI_COMM_WORLD); // Make sure to sync ranks before moving on, we don't want late arrivals
-        }
-        total_time *= 1000; // To milliseconds
-        work_time *= 1000;  // To milliseconds
-
-        TDM_PROCESS_DATA
-        MPI_CHECK(MPI_Bcast(&work, 8, MPI_BYTE, 0, MPI_COMM_WORLD));
+        for (i = 1; i < params->world_size; i++)
+            r_disps[i] = r_disps[i - 1] + r_counts[i - 1];
+        counts_n_elts = n_elts;
+        counts_size = params->world_size;
+        counts_rank = params->world_rank;
     }
 
-    TDM_COMPUTE_OVERLAP
-    FREEMEM;
-    return 0;
-
-exit_error:
-    fprintf(stderr, "[l.%d] %s() failed\n", __LINE__, __func__);
-    FREEMEM;
-    MPI_Abort(MPI_COMM_WORLD, 1);
-    return 1;
+    return MPI_Ialltoallv(s_buf, s_counts, s_disps, type,
+                          SLOT_BUF(r_buf, params, params->world_size * overlap_datatype_elts(params, params->max_elts)), r_counts, r_disps, type,
+                          params->comm, req);
 }
 
 int main(int argc, char **argv)
@@ -348,11 +217,8 @@ int main(int argc, char **argv)
     INIT_OVERLAP_BENCH;
 
     // All the variables specific to ialltoallv
-    double *s_buf = NULL, *r_buf = NULL;
-    int *s_counts = NULL, *r_counts = NULL;
-    int *s_disps = NULL, *r_disps = NULL;
-    MEMALLOC(s_buf, double, params.world_size *params.max_elts * sizeof(double));
-    MEMALLOC(r_buf, double, params.world_size *params.max_elts * sizeof(double));
+    MEMALLOC(s_buf, double, params.world_size * overlap_datatype_elts(&params, params.max_elts) * sizeof(double));
+    MEMALLOC(r_buf, double, params.world_size * overlap_datatype_elts(&params, params.max_elts) * params.concurrency * sizeof(double));
     MEMALLOC(s_counts, int, params.world_size * sizeof(int));
     MEMALLOC(r_counts, int, params.world_size * sizeof(int));
     MEMALLOC(s_disps, int, params.world_size * sizeof(int));
@@ -361,7 +227,7 @@ int main(int argc, char **argv)
     if (params.data_driven_model)
         rc = data_driven_loop(&params, s_buf, r_buf, s_counts, r_counts, s_disps, r_disps);
     else
-        rc = time_driven_loop(&params, s_buf, r_buf, s_counts, r_counts, s_disps, r_disps);
+        rc = time_driven_loop(&params, post_ialltoallv);
 
     if (rc)
     {
@@ -369,6 +235,13 @@ int main(int argc, char **argv)
         goto exit_error;
     }
 
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    MEMFREE(s_counts);
+    MEMFREE(r_counts);
+    MEMFREE(s_disps);
+    MEMFREE(r_disps);
+    overlap_output_write(&params);
     MPI_Finalize();
     return (EXIT_SUCCESS);
 
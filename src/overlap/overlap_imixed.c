@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Overlap of several non-blocking collective operations of different types in flight at the same time, e.g., the
+// independent reductions and broadcasts of a solver step. Operations are posted in the order of mixed_ops, each one
+// on its own duplicate of MPI_COMM_WORLD, and completed with MPI_Waitall(). Only the time driven model is supported.
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+#define MIXED_N_OPS (4)
+
+static const char *mixed_ops[MIXED_N_OPS] = {"iallreduce", "ibcast", "iallgather", "ialltoall"};
+
+// Buffers used by the benchmark, allocated in main(), with a slot of receive buffer per concurrent operation
+static double *s_buf = NULL, *r_buf = NULL;
+
+static int
+post_imixed(overlap_params_t *params, uint64_t n_elts, MPI_Request *req)
+{
+    double *buf = SLOT_BUF(r_buf, params, params->world_size * params->max_elts);
+
+    switch (params->slot % MIXED_N_OPS)
+    {
+    case 0:
+        return MPI_Iallreduce(s_buf, buf, n_elts, MPI_DOUBLE, MPI_SUM, params->comm, req);
+    case 1:
+        return MPI_Ibcast(buf, n_elts, MPI_DOUBLE, params->root, params->comm, req);
+    case 2:
+        return MPI_Iallgather(s_buf, n_elts, MPI_DOUBLE, buf, n_elts, MPI_DOUBLE, params->comm, req);
+    default:
+        return MPI_Ialltoall(s_buf, n_elts, MPI_DOUBLE, buf, n_elts, MPI_DOUBLE, params->comm, req);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int i;
+
+    INIT_OVERLAP_BENCH;
+
+    if (params.data_driven_model)
+    {
+        if (params.world_rank == 0)
+            fprintf(stderr, "%s only supports the time driven model\n", argv[0]);
+        goto exit_error;
+    }
+
+    // One operation of each type unless specified otherwise
+    if (getenv(OVERLAP_CONCURRENCY_ENVVAR) == NULL)
+        params.concurrency = MIXED_N_OPS;
+    if (params.world_rank == 0)
+    {
+        fprintf(stdout, "Operations:");
+        for (i = 0; i < params.concurrency; i++)
+            fprintf(stdout, " %s", mixed_ops[i % MIXED_N_OPS]);
+        fprintf(stdout, "\n");
+    }
+
+    MEMALLOC(s_buf, double, params.world_size * params.max_elts * sizeof(double));
+    MEMALLOC(r_buf, double, params.world_size * params.max_elts * params.concurrency * sizeof(double));
+
+    rc = rooted_time_driven_loop(&params, post_imixed);
+    if (rc)
+    {
+        fprintf(stderr, "Benchmark function failed (return code = %d)\n", rc);
+        goto exit_error;
+    }
+
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    overlap_output_write(&params);
+    MPI_Finalize();
+    return (EXIT_SUCCESS);
+
+exit_error:
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    return (EXIT_FAILURE);
+}
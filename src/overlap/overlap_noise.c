@@ -0,0 +1,341 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Operating system noise benchmark, to be run with one rank per core. The overlap verdicts compare the execution time
+// of the probes against the reference time plus its standard deviation, so the noise of a single node inflates the
+// standard deviation and distorts the results. Every rank times quanta of work:
+// - with the fixed work quantum model (FWQ, default), the same amount of work, equivalent to the quantum on rank 0,
+//   is executed over and over and timed;
+// - with the fixed time quantum model (FTQ), small chunks of work are executed during every quantum and counted.
+// The noise of a quantum is the percentage of the quantum lost compared to the best quantum of the rank. The results
+// are aggregated per node: a histogram of the noise of the quanta, and the nodes whose average noise is above a
+// threshold are reported as noisy. The OpenHPCA tools flag the overlap results of the same run that the noise may
+// distort, i.e., when some nodes are noisy or when the noise is as large as the variation of the reference time.
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+#define NOISE_MODE_FWQ (0)
+#define NOISE_MODE_FTQ (1)
+#define NOISE_DEFAULT_QUANTUM (1000)  // in micro-seconds
+#define NOISE_DEFAULT_SAMPLES (2000)
+#define NOISE_DEFAULT_THRESHOLD (2.0) // in percent
+#define NOISE_FTQ_CHUNKS (100)        // Number of chunks of work of a quantum without noise under FTQ
+#define NOISE_N_BINS (9)
+#define NOISE_RECORD_FORMAT "openhpca_noise"
+#define NOISE_RECORD_VERSION (1)
+
+#define OVERLAP_NOISE_MODE_ENVVAR "OPENHPCA_OVERLAP_NOISE_MODE"
+#define OVERLAP_NOISE_QUANTUM_ENVVAR "OPENHPCA_OVERLAP_NOISE_QUANTUM"
+#define OVERLAP_NOISE_SAMPLES_ENVVAR "OPENHPCA_OVERLAP_NOISE_SAMPLES"
+#define OVERLAP_NOISE_THRESHOLD_ENVVAR "OPENHPCA_OVERLAP_NOISE_THRESHOLD"
+
+// Upper bounds of the bins of the histograms (noise in percent), the last bin gathering everything above 100%
+static const double noise_bins[NOISE_N_BINS - 1] = {0.1, 1, 2, 5, 10, 20, 50, 100};
+static const char *noise_mode_names[2] = {"fwq", "ftq"};
+
+typedef struct noise_params
+{
+    int mode;
+    int quantum; // in micro-seconds
+    int n_samples;
+    double threshold; // in percent
+} noise_params_t;
+
+// Results of a node, computed by its lowest rank
+typedef struct noise_node
+{
+    char name[MPI_MAX_PROCESSOR_NAME];
+    int n_ranks;
+    int noisiest_rank; // Rank of MPI_COMM_WORLD with the highest average noise
+    double min_time;   // in micro-seconds, time of a quantum of work
+    double mean_time;
+    double max_time;
+    double noise;     // Average noise of the quanta, in percent
+    double max_noise; // Highest noise of a quantum, in percent
+    uint64_t histogram[NOISE_N_BINS];
+} noise_node_t;
+
+static void noise_get_params(overlap_params_t *params, noise_params_t *noise)
+{
+    char *mode_str = getenv(OVERLAP_NOISE_MODE_ENVVAR);
+    char *quantum_str = getenv(OVERLAP_NOISE_QUANTUM_ENVVAR);
+    char *samples_str = getenv(OVERLAP_NOISE_SAMPLES_ENVVAR);
+    char *threshold_str = getenv(OVERLAP_NOISE_THRESHOLD_ENVVAR);
+
+    noise->mode = NOISE_MODE_FWQ;
+    noise->quantum = NOISE_DEFAULT_QUANTUM;
+    noise->n_samples = NOISE_DEFAULT_SAMPLES;
+    noise->threshold = NOISE_DEFAULT_THRESHOLD;
+
+    if (mode_str)
+    {
+        if (strcmp(mode_str, "ftq") == 0)
+            noise->mode = NOISE_MODE_FTQ;
+        else if (strcmp(mode_str, "fwq") != 0 && params->world_rank == 0)
+            fprintf(stderr, "Invalid noise mode '%s', using 'fwq'\n", mode_str);
+    }
+
+    if (quantum_str && atoi(quantum_str) > 0)
+        noise->quantum = atoi(quantum_str);
+
+    if (samples_str && atoi(samples_str) > 0)
+        noise->n_samples = atoi(samples_str);
+
+    if (threshold_str && atof(threshold_str) >= 0)
+        noise->threshold = atof(threshold_str);
+}
+
+static inline int noise_bin(double noise)
+{
+    int i;
+    for (i = 0; i < NOISE_N_BINS - 1; i++)
+    {
+        if (noise < noise_bins[i])
+            return i;
+    }
+    return NOISE_N_BINS - 1;
+}
+
+// noise_fwq times n_samples executions of the same amount of work; times are in seconds
+static void noise_fwq(overlap_params_t *params, noise_params_t *noise, int64_t work, double *times)
+{
+    double start;
+    int i;
+
+    for (i = 0; i < noise->n_samples; i++)
+    {
+        start = MPI_Wtime();
+        overlap_work(params, work);
+        times[i] = MPI_Wtime() - start;
+    }
+}
+
+// noise_ftq counts the chunks of work executed during n_samples quanta and converts every count into the time the
+// quantum of work would have taken, so that both models are processed the same way
+static void noise_ftq(overlap_params_t *params, noise_params_t *noise, int64_t chunk, double *times)
+{
+    double quantum = (double)noise->quantum / 1000000; // Micro-seconds to seconds
+    double end = MPI_Wtime();
+    int64_t count, max_count = 1;
+    int i;
+
+    for (i = 0; i < noise->n_samples; i++)
+    {
+        count = 0;
+        end += quantum;
+        while (MPI_Wtime() < end)
+        {
+            overlap_work(params, chunk);
+            count++;
+        }
+        times[i] = (double)count; // Counts are converted once the best quantum is known
+        if (count > max_count)
+            max_count = count;
+    }
+
+    for (i = 0; i < noise->n_samples; i++)
+        times[i] = quantum * max_count / (times[i] > 0 ? times[i] : 1);
+}
+
+static void noise_display(noise_params_t *noise, noise_node_t *nodes, int n_nodes, double total_noise)
+{
+    int i, j, n_noisy = 0;
+    uint64_t n_quanta;
+
+    fprintf(stdout, "Noise measurement: %s model, %d quanta of %d us per rank\n", noise_mode_names[noise->mode],
+            noise->n_samples, noise->quantum);
+    fprintf(stdout, "Node\tRanks\tMin (us)\tMean (us)\tMax (us)\tNoise (%%)\tMax noise (%%)\tNoisiest rank\n");
+    for (i = 0; i < n_nodes; i++)
+        fprintf(stdout, "%s\t%d\t%.2f\t%.2f\t%.2f\t%.3f\t%.1f\t%d\n", nodes[i].name, nodes[i].n_ranks, nodes[i].min_time,
+                nodes[i].mean_time, nodes[i].max_time, nodes[i].noise, nodes[i].max_noise, nodes[i].noisiest_rank);
+
+    fprintf(stdout, "\nNoise histogram (%% of the quanta per noise level)\nNode");
+    for (j = 0; j < NOISE_N_BINS - 1; j++)
+        fprintf(stdout, "\t<%g%%", noise_bins[j]);
+    fprintf(stdout, "\t>=%g%%\n", noise_bins[NOISE_N_BINS - 2]);
+    for (i = 0; i < n_nodes; i++)
+    {
+        n_quanta = 0;
+        for (j = 0; j < NOISE_N_BINS; j++)
+            n_quanta += nodes[i].histogram[j];
+        fprintf(stdout, "%s", nodes[i].name);
+        for (j = 0; j < NOISE_N_BINS; j++)
+            fprintf(stdout, "\t%.2f", n_quanta > 0 ? (double)nodes[i].histogram[j] * 100 / n_quanta : 0.0);
+        fprintf(stdout, "\n");
+    }
+
+    fprintf(stdout, "\nNoisy nodes (noise above %g %%):", noise->threshold);
+    for (i = 0; i < n_nodes; i++)
+    {
+        if (nodes[i].noise > noise->threshold)
+        {
+            fprintf(stdout, " %s", nodes[i].name);
+            n_noisy++;
+        }
+    }
+    fprintf(stdout, "%s\n", n_noisy == 0 ? " none" : "");
+    fprintf(stdout, "Noise: %.3f %%\n", total_noise);
+}
+
+static void noise_write_json(overlap_params_t *params, noise_params_t *noise, noise_node_t *nodes, int n_nodes, double total_noise, FILE *f)
+{
+    int i, j, n_noisy = 0;
+
+    overlap_output_record_header(f, NOISE_RECORD_FORMAT, NOISE_RECORD_VERSION, "overlap_noise", params->world_size);
+    fprintf(f, "\"params\":{\"mode\":\"%s\",\"quantum\":%d,\"samples\":%d,\"threshold\":%g},\"bins\":[",
+            noise_mode_names[noise->mode], noise->quantum, noise->n_samples, noise->threshold);
+    for (j = 0; j < NOISE_N_BINS - 1; j++)
+        fprintf(f, "%s%g", j > 0 ? "," : "", noise_bins[j]);
+    fprintf(f, "],\"nodes\":[");
+    for (i = 0; i < n_nodes; i++)
+    {
+        noise_node_t *n = &nodes[i];
+        fprintf(f, "%s{\"node\":", i > 0 ? "," : "");
+        overlap_output_json_string(f, n->name);
+        fprintf(f, ",\"n_ranks\":%d,\"min_time\":%.9g,\"mean_time\":%.9g,\"max_time\":%.9g,\"noise\":%.9g,\"max_noise\":%.9g,"
+                   "\"noisiest_rank\":%d,\"histogram\":[",
+                n->n_ranks, n->min_time, n->mean_time, n->max_time, n->noise, n->max_noise, n->noisiest_rank);
+        for (j = 0; j < NOISE_N_BINS; j++)
+            fprintf(f, "%s%" PRIu64, j > 0 ? "," : "", n->histogram[j]);
+        fprintf(f, "],\"noisy\":%s}", n->noise > noise->threshold ? "true" : "false");
+    }
+    fprintf(f, "],\"noisy_nodes\":[");
+    for (i = 0; i < n_nodes; i++)
+    {
+        if (nodes[i].noise <= noise->threshold)
+            continue;
+        if (n_noisy++ > 0)
+            fprintf(f, ",");
+        overlap_output_json_string(f, nodes[i].name);
+    }
+    fprintf(f, "],\"noise\":%.9g}\n", total_noise);
+}
+
+int main(int argc, char **argv)
+{
+    noise_params_t noise;
+    noise_node_t node, *nodes = NULL;
+    MPI_Comm node_comm = MPI_COMM_NULL, leaders_comm = MPI_COMM_NULL;
+    struct
+    {
+        double value;
+        int rank;
+    } rank_noise, node_noise;
+    double *times = NULL;
+    double min_time, max_time, sum_time, sum_noise, max_noise, noise_value, total_noise = 0.0;
+    uint64_t histogram[NOISE_N_BINS];
+    int64_t work = 0;
+    int node_rank, name_len, n_nodes = 0, i;
+
+    INIT_OVERLAP_BENCH;
+    noise_get_params(&params, &noise);
+    // The parameters of rank 0 are used everywhere
+    MPI_CHECK(MPI_Bcast(&noise, sizeof(noise), MPI_BYTE, 0, MPI_COMM_WORLD));
+    MEMALLOC(times, double, noise.n_samples * sizeof(double));
+
+    // The same amount of work is used on all the ranks: a quantum under FWQ, a chunk under FTQ
+    if (params.world_rank == 0)
+    {
+        double target = (double)noise.quantum / 1000; // Micro-seconds to milli-seconds
+        if (noise.mode == NOISE_MODE_FTQ)
+            target /= NOISE_FTQ_CHUNKS;
+        GET_WORK_EQUIVALENCE((&params), target, work);
+        OVERLAP_DEBUG((&params), "%" PRId64 " work units per %s\n", work, noise.mode == NOISE_MODE_FTQ ? "chunk" : "quantum");
+    }
+    MPI_CHECK(MPI_Bcast(&work, 1, MPI_INT64_T, 0, MPI_COMM_WORLD));
+
+    // All the cores are measured at the same time, like they are used by the overlap benchmarks
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+    if (noise.mode == NOISE_MODE_FTQ)
+        noise_ftq(&params, &noise, work, times);
+    else
+        noise_fwq(&params, &noise, work, times);
+
+    // Noise of every quantum against the best quantum of the rank
+    min_time = max_time = times[0];
+    sum_time = 0.0;
+    for (i = 0; i < noise.n_samples; i++)
+    {
+        if (times[i] < min_time)
+            min_time = times[i];
+        if (times[i] > max_time)
+            max_time = times[i];
+        sum_time += times[i];
+    }
+    memset(histogram, 0, sizeof(histogram));
+    sum_noise = max_noise = 0.0;
+    for (i = 0; i < noise.n_samples; i++)
+    {
+        noise_value = min_time > 0 ? (times[i] - min_time) / min_time * 100 : 0.0;
+        histogram[noise_bin(noise_value)]++;
+        sum_noise += noise_value;
+        if (noise_value > max_noise)
+            max_noise = noise_value;
+    }
+    rank_noise.value = sum_noise / noise.n_samples;
+    rank_noise.rank = params.world_rank;
+    min_time *= 1000000; // To micro-seconds
+    max_time *= 1000000;
+    sum_time *= 1000000;
+
+    // Aggregation per node, on the lowest rank of the node
+    memset(&node, 0, sizeof(node));
+    MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, params.world_rank, MPI_INFO_NULL, &node_comm));
+    MPI_CHECK(MPI_Comm_rank(node_comm, &node_rank));
+    MPI_CHECK(MPI_Comm_size(node_comm, &node.n_ranks));
+    MPI_CHECK(MPI_Get_processor_name(node.name, &name_len));
+    MPI_CHECK(MPI_Reduce(&min_time, &node.min_time, 1, MPI_DOUBLE, MPI_MIN, 0, node_comm));
+    MPI_CHECK(MPI_Reduce(&max_time, &node.max_time, 1, MPI_DOUBLE, MPI_MAX, 0, node_comm));
+    MPI_CHECK(MPI_Reduce(&sum_time, &node.mean_time, 1, MPI_DOUBLE, MPI_SUM, 0, node_comm));
+    MPI_CHECK(MPI_Reduce(&sum_noise, &node.noise, 1, MPI_DOUBLE, MPI_SUM, 0, node_comm));
+    MPI_CHECK(MPI_Reduce(&max_noise, &node.max_noise, 1, MPI_DOUBLE, MPI_MAX, 0, node_comm));
+    MPI_CHECK(MPI_Reduce(histogram, node.histogram, NOISE_N_BINS, MPI_UINT64_T, MPI_SUM, 0, node_comm));
+    MPI_CHECK(MPI_Reduce(&rank_noise, &node_noise, 1, MPI_DOUBLE_INT, MPI_MAXLOC, 0, node_comm));
+    node.mean_time /= (double)node.n_ranks * noise.n_samples;
+    node.noise /= (double)node.n_ranks * noise.n_samples;
+    node.noisiest_rank = node_noise.rank;
+
+    // Rank 0 of MPI_COMM_WORLD is the lowest rank of its node, it gathers the results of all the nodes
+    MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, params.world_rank, &leaders_comm));
+    if (leaders_comm != MPI_COMM_NULL)
+    {
+        MPI_CHECK(MPI_Comm_size(leaders_comm, &n_nodes));
+        if (params.world_rank == 0)
+            MEMALLOC(nodes, noise_node_t, n_nodes * sizeof(noise_node_t));
+        MPI_CHECK(MPI_Gather(&node, sizeof(noise_node_t), MPI_BYTE, nodes, sizeof(noise_node_t), MPI_BYTE, 0, leaders_comm));
+        MPI_Comm_free(&leaders_comm);
+    }
+    MPI_Comm_free(&node_comm);
+
+    if (params.world_rank == 0)
+    {
+        // Overall noise, every node being weighted by its number of ranks
+        for (i = 0; i < n_nodes; i++)
+            total_noise += nodes[i].noise * nodes[i].n_ranks;
+        total_noise /= params.world_size;
+        noise_display(&noise, nodes, n_nodes, total_noise);
+        noise_write_json(&params, &noise, nodes, n_nodes, total_noise, stdout);
+        fflush(stdout);
+    }
+
+    MEMFREE(nodes);
+    MEMFREE(times);
+    MPI_Finalize();
+    return (EXIT_SUCCESS);
+
+exit_error:
+    MEMFREE(nodes);
+    MEMFREE(times);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    return (EXIT_FAILURE);
+}
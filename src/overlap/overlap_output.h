@@ -0,0 +1,553 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#ifndef OVERLAP_OUTPUT_H_
+#define OVERLAP_OUTPUT_H_
+
+// Machine-readable output of the benchmarks. At the end of the execution, rank 0 writes a single JSON record on
+// stdout, on a line of its own, with the parameters, the search trajectories and the results. The version must be
+// increased every time the format of the record changes in a way that is not backward compatible. The benchmarks that
+// do not measure the overlap of a single operation (noise, asynchrony, patterns) write their own record, with its own
+// format and version, that the OpenHPCA tools report next to the overlap score.
+#define OVERLAP_OUTPUT_FORMAT "openhpca_overlap"
+#define OVERLAP_OUTPUT_VERSION (1)
+
+#define OVERLAP_JSON_FILE_ENVVAR "OPENHPCA_OVERLAP_JSON_FILE"
+#define OVERLAP_CSV_FILE_ENVVAR "OPENHPCA_OVERLAP_CSV_FILE"
+
+// Measurement of a step of the search of the size matching the cutoff time
+typedef struct overlap_output_search_step
+{
+    uint64_t n_elts;
+    double time; // in milli-seconds
+} overlap_output_search_step_t;
+
+// Evaluation of a given amount of injected work during the search of the overlap
+typedef struct overlap_output_probe
+{
+    int result; // Index of the result the probe contributed to
+    uint64_t n_elts;
+    int root;
+    int skew;
+    int64_t work;         // in nano-seconds under the time driven model, in work units under the data driven model
+    double time;          // in milli-seconds
+    double threshold;     // in milli-seconds, maximum time for the work to be considered overlapped
+    bool passed;          // true if the work was overlapped
+    int validation_count; // Number of consecutive failed runs, including this one (0 if passed), used to filter out jitter
+} overlap_output_probe_t;
+
+// Overlap of a given configuration. Values that are unknown, e.g., times under the data driven model, are negative
+typedef struct overlap_output_result
+{
+    uint64_t n_elts;
+    int n_iters;
+    double ref_time;  // in milli-seconds
+    double stdev;     // in milli-seconds
+    double work_time; // in milli-seconds
+    double wait_time; // in milli-seconds
+    double overlap;   // in percent
+    double completion_time; // in milli-seconds, across the ranks with window-based synchronization
+    bool completed;
+    int root;
+    int skew;       // in micro-seconds
+    int comm_split; // COMM_SPLIT_* of the communicator
+    int comm_size;
+    int elt_size;    // in bytes
+    int reduce_type; // REDUCE_TYPE_* of reductions, -1 for other operations
+    int reduce_op;   // REDUCE_OP_* of reductions, -1 for other operations
+    int n_pvars;
+    double pvars[MAX_PVARS]; // Performance variables, in the order of overlap_pvars
+    int cvar_setting;        // Index in the settings of the control variables, -1 outside of the sweep
+    bool has_inflation;
+    double inflation;        // Average slowdown of the computation with the communication in flight, in percent
+    double max_inflation;    // Highest slowdown of a rank, in percent
+    int max_inflation_rank;
+    double work_rate_min; // Work units per milli-second of the slowest rank, 0 if the work was not calibrated
+    double work_rate_max; // Work units per milli-second of the fastest rank
+    int slowest_rank;
+} overlap_output_result_t;
+
+// Overlap reported for a communicator other than MPI_COMM_WORLD
+typedef struct overlap_output_comm
+{
+    int comm_split;
+    int comm_size;
+    double overlap; // in percent
+} overlap_output_comm_t;
+
+// Overlap reported for a combination of datatype and operation of a reduction other than MPI_DOUBLE and MPI_SUM
+typedef struct overlap_output_reduction
+{
+    int reduce_type;
+    int reduce_op;
+    double overlap; // in percent
+} overlap_output_reduction_t;
+
+// Overlap reported for a setting of the control variables
+typedef struct overlap_output_cvar_setting
+{
+    char setting[MAX_CVAR_SETTING_LEN];
+    bool has_overlap;
+    double overlap; // in percent
+} overlap_output_cvar_setting_t;
+
+typedef struct overlap_output
+{
+    overlap_output_search_step_t *search_steps;
+    int n_search_steps;
+    int max_search_steps;
+    overlap_output_result_t *results;
+    int n_results;
+    int max_results;
+    overlap_output_probe_t *probes;
+    int n_probes;
+    int max_probes;
+    overlap_output_comm_t *comms;
+    int n_comms;
+    int max_comms;
+    overlap_output_reduction_t *reductions;
+    int n_reductions;
+    int max_reductions;
+    overlap_output_cvar_setting_t *cvar_settings;
+    int n_cvar_settings;
+    int max_cvar_settings;
+    // Overlap reported as the final result of the benchmark ("Overlap: " line), if any
+    bool has_overlap;
+    double overlap;
+    // Compute inflation reported with the final result of the benchmark, if any
+    bool has_inflation;
+    double inflation;
+} overlap_output_t;
+
+// Only one benchmark per binary, the record is therefore global
+static overlap_output_t overlap_output = {NULL, 0, 0, NULL, 0, 0, NULL, 0, 0, NULL, 0, 0, NULL, 0, 0, NULL, 0, 0, false, 0.0, false, 0.0};
+
+// GROW_ARRAY makes sure an array has room for one more element, doubling its capacity when required
+#define GROW_ARRAY(_array, _n, _max, _type)                                                \
+    do                                                                                     \
+    {                                                                                      \
+        if (_n == _max)                                                                    \
+        {                                                                                  \
+            int _new_max = _max == 0 ? 16 : _max * 2;                                      \
+            _type *_new_array = (_type *)realloc(_array, _new_max * sizeof(_type));        \
+            if (_new_array == NULL)                                                        \
+            {                                                                              \
+                fprintf(stderr, "Out of resource (size=%ld)\n", _new_max * sizeof(_type)); \
+                return;                                                                    \
+            }                                                                              \
+            _array = _new_array;                                                           \
+            _max = _new_max;                                                               \
+        }                                                                                  \
+    } while (0)
+
+static inline void overlap_output_add_search_step(uint64_t n_elts, double time)
+{
+    GROW_ARRAY(overlap_output.search_steps, overlap_output.n_search_steps, overlap_output.max_search_steps, overlap_output_search_step_t);
+    overlap_output.search_steps[overlap_output.n_search_steps].n_elts = n_elts;
+    overlap_output.search_steps[overlap_output.n_search_steps].time = time;
+    overlap_output.n_search_steps++;
+}
+
+static inline void overlap_output_add_result(overlap_params_t *params, overlap_output_result_t *res)
+{
+    GROW_ARRAY(overlap_output.results, overlap_output.n_results, overlap_output.max_results, overlap_output_result_t);
+    overlap_output.results[overlap_output.n_results] = *res;
+    overlap_output.results[overlap_output.n_results].root = params->root;
+    overlap_output.results[overlap_output.n_results].skew = params->skew;
+    overlap_output.results[overlap_output.n_results].comm_split = params->comm_split;
+    overlap_output.results[overlap_output.n_results].comm_size = params->world_size;
+    overlap_output.results[overlap_output.n_results].elt_size = overlap_elt_size(params);
+    overlap_output.results[overlap_output.n_results].reduce_type = params->reduce_type;
+    overlap_output.results[overlap_output.n_results].reduce_op = params->reduce_op;
+    overlap_output.results[overlap_output.n_results].cvar_setting = params->cvar_setting;
+    overlap_output.n_results++;
+}
+
+static inline void overlap_output_add_probe(overlap_params_t *params, uint64_t n_elts, int64_t work, double time, double threshold, bool passed, int validation_count)
+{
+    overlap_output_probe_t *p;
+    GROW_ARRAY(overlap_output.probes, overlap_output.n_probes, overlap_output.max_probes, overlap_output_probe_t);
+    p = &overlap_output.probes[overlap_output.n_probes];
+    p->result = overlap_output.n_results; // Results are added once their search is over
+    p->n_elts = n_elts;
+    p->root = params->root;
+    p->skew = params->skew;
+    p->work = work;
+    p->time = time;
+    p->threshold = threshold;
+    p->passed = passed;
+    p->validation_count = passed ? 0 : validation_count;
+    overlap_output.n_probes++;
+}
+
+// overlap_output_add_cvar_setting adds a setting of the control variables, returns its index or -1 on error
+static inline int overlap_output_add_cvar_setting(const char *setting)
+{
+    if (overlap_output.n_cvar_settings == overlap_output.max_cvar_settings)
+    {
+        int new_max = overlap_output.max_cvar_settings == 0 ? 16 : overlap_output.max_cvar_settings * 2;
+        overlap_output_cvar_setting_t *new_array = (overlap_output_cvar_setting_t *)realloc(overlap_output.cvar_settings, new_max * sizeof(overlap_output_cvar_setting_t));
+        if (new_array == NULL)
+            return -1;
+        overlap_output.cvar_settings = new_array;
+        overlap_output.max_cvar_settings = new_max;
+    }
+    strncpy(overlap_output.cvar_settings[overlap_output.n_cvar_settings].setting, setting, MAX_CVAR_SETTING_LEN - 1);
+    overlap_output.cvar_settings[overlap_output.n_cvar_settings].setting[MAX_CVAR_SETTING_LEN - 1] = '\0';
+    overlap_output.cvar_settings[overlap_output.n_cvar_settings].has_overlap = false;
+    return overlap_output.n_cvar_settings++;
+}
+
+// overlap_output_set_overlap records the final overlap of the benchmark, or the overlap of a communicator other than
+// MPI_COMM_WORLD, or the overlap of a reduction with a datatype and an operation other than MPI_DOUBLE and MPI_SUM, or
+// the overlap of a setting of the control variables
+static inline void overlap_output_set_overlap(overlap_params_t *params, double overlap)
+{
+    if (params->cvar_setting >= 0)
+    {
+        overlap_output.cvar_settings[params->cvar_setting].has_overlap = true;
+        overlap_output.cvar_settings[params->cvar_setting].overlap = overlap;
+        return;
+    }
+
+    if (params->comm_split == COMM_SPLIT_NONE && (params->reduce_type > REDUCE_TYPE_DOUBLE || params->reduce_op > REDUCE_OP_SUM))
+    {
+        GROW_ARRAY(overlap_output.reductions, overlap_output.n_reductions, overlap_output.max_reductions, overlap_output_reduction_t);
+        overlap_output.reductions[overlap_output.n_reductions].reduce_type = params->reduce_type;
+        overlap_output.reductions[overlap_output.n_reductions].reduce_op = params->reduce_op;
+        overlap_output.reductions[overlap_output.n_reductions].overlap = overlap;
+        overlap_output.n_reductions++;
+        return;
+    }
+
+    if (params->comm_split == COMM_SPLIT_NONE)
+    {
+        overlap_output.has_overlap = true;
+        overlap_output.overlap = overlap;
+        return;
+    }
+
+    GROW_ARRAY(overlap_output.comms, overlap_output.n_comms, overlap_output.max_comms, overlap_output_comm_t);
+    overlap_output.comms[overlap_output.n_comms].comm_split = params->comm_split;
+    overlap_output.comms[overlap_output.n_comms].comm_size = params->world_size;
+    overlap_output.comms[overlap_output.n_comms].overlap = overlap;
+    overlap_output.n_comms++;
+}
+
+// overlap_output_set_inflation records the compute inflation of the final result of the benchmark; the inflation of
+// the other results is only reported with the results
+static inline void overlap_output_set_inflation(overlap_params_t *params, double inflation)
+{
+    if (params->cvar_setting >= 0 || params->comm_split != COMM_SPLIT_NONE || params->reduce_type > REDUCE_TYPE_DOUBLE ||
+        params->reduce_op > REDUCE_OP_SUM)
+        return;
+    overlap_output.has_inflation = true;
+    overlap_output.inflation = inflation;
+}
+
+// overlap_output_get_comm_overlap gets the last overlap recorded for a communicator, returns false if there is none
+static inline bool overlap_output_get_comm_overlap(int comm_split, int comm_size, double *overlap)
+{
+    int i;
+    for (i = overlap_output.n_comms - 1; i >= 0; i--)
+    {
+        if (overlap_output.comms[i].comm_split == comm_split && overlap_output.comms[i].comm_size == comm_size)
+        {
+            *overlap = overlap_output.comms[i].overlap;
+            return true;
+        }
+    }
+    return false;
+}
+
+// overlap_output_get_reduce_overlap gets the last overlap recorded for a reduction, returns false if there is none
+static inline bool overlap_output_get_reduce_overlap(int reduce_type, int reduce_op, double *overlap)
+{
+    int i;
+    if (reduce_type == REDUCE_TYPE_DOUBLE && reduce_op == REDUCE_OP_SUM)
+    {
+        *overlap = overlap_output.overlap;
+        return overlap_output.has_overlap;
+    }
+    for (i = overlap_output.n_reductions - 1; i >= 0; i--)
+    {
+        if (overlap_output.reductions[i].reduce_type == reduce_type && overlap_output.reductions[i].reduce_op == reduce_op)
+        {
+            *overlap = overlap_output.reductions[i].overlap;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char *overlap_output_benchmark_name(overlap_params_t *params)
+{
+    const char *name = params->name != NULL ? params->name : "";
+    const char *base = strrchr(name, '/');
+    return base != NULL ? base + 1 : name;
+}
+
+// overlap_output_json_string writes a string with the characters that are special to JSON escaped
+static void overlap_output_json_string(FILE *f, const char *str)
+{
+    const char *c;
+    fputc('"', f);
+    for (c = str; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            fprintf(f, "\\%c", *c);
+        else if ((unsigned char)*c < 0x20)
+            fprintf(f, "\\u%04x", (unsigned char)*c);
+        else
+            fputc(*c, f);
+    }
+    fputc('"', f);
+}
+
+// Writes a time or a percentage, null if unknown
+static void overlap_output_json_value(FILE *f, double value)
+{
+    if (value < 0)
+        fprintf(f, "null");
+    else
+        fprintf(f, "%.9g", value);
+}
+
+// overlap_output_record_header opens the JSON record of a benchmark with the fields identifying it; the caller writes
+// its own fields, without a leading comma, and closes the record
+static inline void overlap_output_record_header(FILE *f, const char *format, int version, const char *benchmark,
+                                                int world_size)
+{
+    fprintf(f, "{\"format\":\"%s\",\"version\":%d,\"benchmark\":", format, version);
+    overlap_output_json_string(f, benchmark);
+    fprintf(f, ",\"world_size\":%d,", world_size);
+}
+
+static void overlap_output_write_json(overlap_params_t *params, FILE *f)
+{
+    const char *patterns[] = {"late", "ramp", "random"};
+    const char *datatypes[] = {"contiguous", "vector", "indexed", "subarray"};
+    int i, j;
+
+    overlap_output_record_header(f, OVERLAP_OUTPUT_FORMAT, OVERLAP_OUTPUT_VERSION, overlap_output_benchmark_name(params),
+                                 params->world_size);
+    fprintf(f, "\"model\":\"%s\"", params->data_driven_model ? "ddm" : "tdm");
+
+    fprintf(f, ",\"params\":{\"min_elts\":%" PRIu64 ",\"max_elts\":%" PRIu64 ",\"validation_steps\":%d,\"cutoff_time\":%d"
+               ",\"n_iters\":%d,\"overlap_threshold\":%d,\"max_iters\":%d,\"time_budget\":%d,\"seed_elts\":%" PRIu64,
+            params->min_elts, params->max_elts, params->validation_steps, params->cutoff_time,
+            params->n_iters, params->overlap_threshold, params->max_iters, params->time_budget, params->seed_elts);
+    fprintf(f, ",\"skew_pattern\":\"%s\",\"skew_seed\":%" PRIu64 ",\"sync\":\"%s\",\"sync_window\":%d",
+            patterns[params->skew_pattern], params->skew_seed,
+            params->sync_mode == SYNC_MODE_WINDOW ? "window" : "barrier", params->sync_window);
+    fprintf(f, ",\"concurrency\":%d,\"datatype\":\"%s\",\"block_len\":%d,\"stride\":%d,\"compute_inflation\":%s",
+            params->concurrency, datatypes[params->datatype], params->block_len, params->stride,
+            params->compute_inflation ? "true" : "false");
+    fprintf(f, ",\"work_kernel\":\"%s\",\"work_cycles\":%" PRId64 "}",
+            params->work_kernel == WORK_KERNEL_CYCLES ? "cycles" : "flops", params->work_cycles);
+
+    fprintf(f, ",\"size_search\":[");
+    for (i = 0; i < overlap_output.n_search_steps; i++)
+    {
+        fprintf(f, "%s{\"n_elts\":%" PRIu64 ",\"time\":", i > 0 ? "," : "", overlap_output.search_steps[i].n_elts);
+        overlap_output_json_value(f, overlap_output.search_steps[i].time);
+        fprintf(f, "}");
+    }
+    fprintf(f, "]");
+
+    fprintf(f, ",\"results\":[");
+    for (i = 0; i < overlap_output.n_results; i++)
+    {
+        overlap_output_result_t *r = &overlap_output.results[i];
+        fprintf(f, "%s{\"n_elts\":%" PRIu64 ",\"data_size\":%" PRIu64 ",\"n_iters\":%d,\"ref_time\":",
+                i > 0 ? "," : "", r->n_elts, r->n_elts * r->elt_size, r->n_iters);
+        overlap_output_json_value(f, r->ref_time);
+        fprintf(f, ",\"stdev\":");
+        overlap_output_json_value(f, r->stdev);
+        fprintf(f, ",\"work_time\":");
+        overlap_output_json_value(f, r->work_time);
+        fprintf(f, ",\"wait_time\":");
+        overlap_output_json_value(f, r->wait_time);
+        fprintf(f, ",\"overlap\":");
+        overlap_output_json_value(f, r->overlap);
+        if (r->completion_time >= 0)
+            fprintf(f, ",\"completion_time\":%.9g", r->completion_time);
+        fprintf(f, ",\"completed\":%s,\"root\":%d,\"skew\":%d,\"comm\":\"%s\",\"comm_size\":%d",
+                r->completed ? "true" : "false", r->root, r->skew, comm_split_name(r->comm_split), r->comm_size);
+        if (r->reduce_type >= 0)
+            fprintf(f, ",\"reduce_type\":\"%s\",\"reduce_op\":\"%s\"", reduce_type_names[r->reduce_type], reduce_op_names[r->reduce_op]);
+        if (r->cvar_setting >= 0)
+        {
+            fprintf(f, ",\"cvar_setting\":");
+            overlap_output_json_string(f, overlap_output.cvar_settings[r->cvar_setting].setting);
+        }
+        if (r->n_pvars > 0)
+        {
+            fprintf(f, ",\"pvars\":{");
+            for (j = 0; j < r->n_pvars; j++)
+            {
+                fprintf(f, "%s", j > 0 ? "," : "");
+                overlap_output_json_string(f, overlap_pvars.pvars[j].name);
+                fprintf(f, ":%.9g", r->pvars[j]);
+            }
+            fprintf(f, "}");
+        }
+        if (r->has_inflation)
+            fprintf(f, ",\"compute_inflation\":%.9g,\"max_compute_inflation\":%.9g,\"max_compute_inflation_rank\":%d",
+                    r->inflation, r->max_inflation, r->max_inflation_rank);
+        if (r->work_rate_max > 0)
+            fprintf(f, ",\"work_rate_min\":%.9g,\"work_rate_max\":%.9g,\"work_rate_spread\":%.9g,\"slowest_rank\":%d",
+                    r->work_rate_min, r->work_rate_max, (r->work_rate_max - r->work_rate_min) * 100 / r->work_rate_max,
+                    r->slowest_rank);
+        fprintf(f, "}");
+    }
+    fprintf(f, "]");
+
+    fprintf(f, ",\"probes\":[");
+    for (i = 0; i < overlap_output.n_probes; i++)
+    {
+        overlap_output_probe_t *p = &overlap_output.probes[i];
+        fprintf(f, "%s{\"result\":%d,\"n_elts\":%" PRIu64 ",\"root\":%d,\"skew\":%d,\"work\":%" PRId64 ",\"time\":",
+                i > 0 ? "," : "", p->result, p->n_elts, p->root, p->skew, p->work);
+        overlap_output_json_value(f, p->time);
+        fprintf(f, ",\"threshold\":");
+        overlap_output_json_value(f, p->threshold);
+        fprintf(f, ",\"passed\":%s,\"validation_count\":%d}", p->passed ? "true" : "false", p->validation_count);
+    }
+    fprintf(f, "]");
+
+    fprintf(f, ",\"comms\":[");
+    for (i = 0; i < overlap_output.n_comms; i++)
+    {
+        overlap_output_comm_t *c = &overlap_output.comms[i];
+        fprintf(f, "%s{\"comm\":\"%s\",\"comm_size\":%d,\"overlap\":", i > 0 ? "," : "", comm_split_name(c->comm_split), c->comm_size);
+        overlap_output_json_value(f, c->overlap);
+        fprintf(f, "}");
+    }
+    fprintf(f, "]");
+
+    fprintf(f, ",\"reductions\":[");
+    for (i = 0; i < overlap_output.n_reductions; i++)
+    {
+        overlap_output_reduction_t *red = &overlap_output.reductions[i];
+        fprintf(f, "%s{\"reduce_type\":\"%s\",\"reduce_op\":\"%s\",\"overlap\":", i > 0 ? "," : "",
+                reduce_type_names[red->reduce_type], reduce_op_names[red->reduce_op]);
+        overlap_output_json_value(f, red->overlap);
+        fprintf(f, "}");
+    }
+    fprintf(f, "]");
+
+    fprintf(f, ",\"cvar_settings\":[");
+    for (i = 0; i < overlap_output.n_cvar_settings; i++)
+    {
+        fprintf(f, "%s{\"setting\":", i > 0 ? "," : "");
+        overlap_output_json_string(f, overlap_output.cvar_settings[i].setting);
+        fprintf(f, ",\"overlap\":");
+        if (overlap_output.cvar_settings[i].has_overlap)
+            overlap_output_json_value(f, overlap_output.cvar_settings[i].overlap);
+        else
+            fprintf(f, "null");
+        fprintf(f, "}");
+    }
+    fprintf(f, "]");
+
+    fprintf(f, ",\"overlap\":");
+    if (overlap_output.has_overlap)
+        overlap_output_json_value(f, overlap_output.overlap);
+    else
+        fprintf(f, "null");
+    // The inflation can be slightly negative because of the variability of the measurements
+    fprintf(f, ",\"compute_inflation\":");
+    if (overlap_output.has_inflation)
+        fprintf(f, "%.9g", overlap_output.inflation);
+    else
+        fprintf(f, "null");
+    fprintf(f, "}\n");
+}
+
+static void overlap_output_write_csv(overlap_params_t *params, FILE *f)
+{
+    int i;
+
+    fprintf(f, "version,benchmark,model,world_size,n_elts,data_size,n_iters,ref_time,stdev,work_time,wait_time,overlap,completed,root,skew,comm,comm_size,reduce_type,reduce_op,cvar_setting\n");
+    for (i = 0; i < overlap_output.n_results; i++)
+    {
+        overlap_output_result_t *r = &overlap_output.results[i];
+        fprintf(f, "%d,%s,%s,%d,%" PRIu64 ",%" PRIu64 ",%d,%.9g,%.9g,%.9g,%.9g,%.9g,%d,%d,%d,%s,%d,%s,%s,%s\n", OVERLAP_OUTPUT_VERSION,
+                overlap_output_benchmark_name(params), params->data_driven_model ? "ddm" : "tdm", params->world_size,
+                r->n_elts, r->n_elts * r->elt_size, r->n_iters, r->ref_time, r->stdev, r->work_time, r->wait_time,
+                r->overlap, r->completed ? 1 : 0, r->root, r->skew, comm_split_name(r->comm_split), r->comm_size,
+                r->reduce_type >= 0 ? reduce_type_names[r->reduce_type] : "",
+                r->reduce_op >= 0 ? reduce_op_names[r->reduce_op] : "",
+                r->cvar_setting >= 0 ? overlap_output.cvar_settings[r->cvar_setting].setting : "");
+    }
+}
+
+// overlap_output_reset drops all the data recorded so far
+static inline void overlap_output_reset(void)
+{
+    free(overlap_output.search_steps);
+    free(overlap_output.results);
+    free(overlap_output.probes);
+    free(overlap_output.comms);
+    free(overlap_output.reductions);
+    free(overlap_output.cvar_settings);
+    overlap_output.search_steps = NULL;
+    overlap_output.results = NULL;
+    overlap_output.probes = NULL;
+    overlap_output.n_probes = overlap_output.max_probes = 0;
+    overlap_output.comms = NULL;
+    overlap_output.n_comms = overlap_output.max_comms = 0;
+    overlap_output.reductions = NULL;
+    overlap_output.n_reductions = overlap_output.max_reductions = 0;
+    overlap_output.cvar_settings = NULL;
+    overlap_output.n_cvar_settings = overlap_output.max_cvar_settings = 0;
+    overlap_output.n_search_steps = overlap_output.max_search_steps = 0;
+    overlap_output.n_results = overlap_output.max_results = 0;
+}
+
+// overlap_output_write writes the record on stdout and, when requested, to JSON and CSV files. It must be called
+// once, by all ranks, at the end of the benchmark
+static inline void overlap_output_write(overlap_params_t *params)
+{
+    char *json_file = getenv(OVERLAP_JSON_FILE_ENVVAR);
+    char *csv_file = getenv(OVERLAP_CSV_FILE_ENVVAR);
+    FILE *f;
+
+    if (params->world_rank == 0)
+    {
+        overlap_output_write_json(params, stdout);
+        fflush(stdout);
+
+        if (json_file != NULL && *json_file != '\0')
+        {
+            f = fopen(json_file, "w");
+            if (f == NULL)
+                fprintf(stderr, "Unable to open %s\n", json_file);
+            else
+            {
+                overlap_output_write_json(params, f);
+                fclose(f);
+            }
+        }
+
+        if (csv_file != NULL && *csv_file != '\0')
+        {
+            f = fopen(csv_file, "w");
+            if (f == NULL)
+                fprintf(stderr, "Unable to open %s\n", csv_file);
+            else
+            {
+                overlap_output_write_csv(params, f);
+                fclose(f);
+            }
+        }
+    }
+
+    overlap_output_reset();
+}
+
+#endif // OVERLAP_OUTPUT_H_
@@ -0,0 +1,370 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Pipelined conjugate gradient pattern. Krylov solvers need global dot products at every iteration, i.e., an allreduce
+// of a few doubles whose latency quickly dominates at scale. The pipelined CG recurrence (Ghysels and Vanroose)
+// rearranges the iteration so that the single MPI_Iallreduce() of an iteration is in flight while the rank computes
+// the sparse matrix-vector product of the next search direction. The benchmark solves a 3D Poisson problem (7-point
+// stencil on a n x n x n grid per rank, the subdomains being stacked along z, stored as a CSR matrix with a halo
+// exchange before every product) with that recurrence, once waiting for the reduction right after posting it and once
+// overlapping it with the product. It reports the iteration time, the exposed latency of the reduction, i.e., the time
+// spent in MPI_Wait(), and the share of the latency of the reduction alone that was hidden.
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+#define PCG_DEFAULT_SIZE (32) // Points of the grid of a rank in every dimension
+#define PCG_DEFAULT_ITERS (200)
+#define PCG_WARMUP_ITERS (10)
+#define PCG_N_DOTS (2) // (r, r) and (w, r)
+#define PCG_RECORD_FORMAT "openhpca_pcg"
+#define PCG_RECORD_VERSION (1)
+
+#define OVERLAP_PCG_SIZE_ENVVAR "OPENHPCA_OVERLAP_PCG_SIZE"
+#define OVERLAP_PCG_ITERS_ENVVAR "OPENHPCA_OVERLAP_PCG_ITERS"
+
+// Local rows of the Poisson matrix in CSR format; the columns index vectors extended with a ghost plane below and
+// above the planes of the rank
+typedef struct pcg_matrix
+{
+    int n;      // Points per dimension
+    int n_rows; // n * n * n
+    int plane;  // n * n, also the offset of the first local row in the extended vectors
+    int *row_ptr;
+    int *cols;
+    double *vals;
+} pcg_matrix_t;
+
+// Timings of a solve, averaged over the iterations
+typedef struct pcg_result
+{
+    double iter_time; // on the slowest rank
+    double wait_time; // average over the ranks
+    double residual;  // Norm of the residual at the end of the solve
+} pcg_result_t;
+
+// pcg_build_matrix generates the 7-point Laplacian of the local subdomain; the points outside of the global domain
+// are Dirichlet boundaries
+static int pcg_build_matrix(overlap_params_t *params, int n, pcg_matrix_t *A)
+{
+    int x, y, z, row, nnz = 0;
+
+    memset(A, 0, sizeof(*A));
+    A->n = n;
+    A->plane = n * n;
+    A->n_rows = n * n * n;
+    MEMALLOC(A->row_ptr, int, (A->n_rows + 1) * sizeof(int));
+    MEMALLOC(A->cols, int, 7 * A->n_rows * sizeof(int));
+    MEMALLOC(A->vals, double, 7 * A->n_rows * sizeof(double));
+
+    for (z = 0; z < n; z++)
+    {
+        for (y = 0; y < n; y++)
+        {
+            for (x = 0; x < n; x++)
+            {
+                // Index in the extended vectors
+                int col = A->plane + (z * n + y) * n + x;
+                row = (z * n + y) * n + x;
+                A->row_ptr[row] = nnz;
+                // Neighbors along z are in the ghost planes at the boundaries of the subdomain
+                if (z > 0 || params->world_rank > 0)
+                {
+                    A->cols[nnz] = col - A->plane;
+                    A->vals[nnz++] = -1.0;
+                }
+                if (y > 0)
+                {
+                    A->cols[nnz] = col - n;
+                    A->vals[nnz++] = -1.0;
+                }
+                if (x > 0)
+                {
+                    A->cols[nnz] = col - 1;
+                    A->vals[nnz++] = -1.0;
+                }
+                A->cols[nnz] = col;
+                A->vals[nnz++] = 6.0;
+                if (x < n - 1)
+                {
+                    A->cols[nnz] = col + 1;
+                    A->vals[nnz++] = -1.0;
+                }
+                if (y < n - 1)
+                {
+                    A->cols[nnz] = col + n;
+                    A->vals[nnz++] = -1.0;
+                }
+                if (z < n - 1 || params->world_rank < params->world_size - 1)
+                {
+                    A->cols[nnz] = col + A->plane;
+                    A->vals[nnz++] = -1.0;
+                }
+            }
+        }
+    }
+    A->row_ptr[A->n_rows] = nnz;
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+static void pcg_free_matrix(pcg_matrix_t *A)
+{
+    MEMFREE(A->row_ptr);
+    MEMFREE(A->cols);
+    MEMFREE(A->vals);
+}
+
+// pcg_spmv computes y = A x; the ghost planes of x are first exchanged with the ranks below and above
+static int pcg_spmv(overlap_params_t *params, pcg_matrix_t *A, double *x, double *y)
+{
+    MPI_Request reqs[4];
+    int n_reqs = 0, row, j;
+    double sum;
+
+    if (params->world_rank > 0)
+    {
+        MPI_CHECK(MPI_Irecv(x, A->plane, MPI_DOUBLE, params->world_rank - 1, 0, params->comm, &reqs[n_reqs++]));
+        MPI_CHECK(MPI_Isend(&x[A->plane], A->plane, MPI_DOUBLE, params->world_rank - 1, 0, params->comm,
+                            &reqs[n_reqs++]));
+    }
+    if (params->world_rank < params->world_size - 1)
+    {
+        MPI_CHECK(MPI_Irecv(&x[A->plane + A->n_rows], A->plane, MPI_DOUBLE, params->world_rank + 1, 0, params->comm,
+                            &reqs[n_reqs++]));
+        MPI_CHECK(MPI_Isend(&x[A->n_rows], A->plane, MPI_DOUBLE, params->world_rank + 1, 0, params->comm,
+                            &reqs[n_reqs++]));
+    }
+    MPI_CHECK(MPI_Waitall(n_reqs, reqs, MPI_STATUSES_IGNORE));
+
+    for (row = 0; row < A->n_rows; row++)
+    {
+        sum = 0.0;
+        for (j = A->row_ptr[row]; j < A->row_ptr[row + 1]; j++)
+            sum += A->vals[j] * x[A->cols[j]];
+        y[A->plane + row] = sum;
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// Vectors of the solver, extended with the ghost planes; the local part starts at A->plane
+enum
+{
+    PCG_X,
+    PCG_R,
+    PCG_W,
+    PCG_P,
+    PCG_S,
+    PCG_Z,
+    PCG_Q,
+    PCG_N_VECS
+};
+static double *vecs[PCG_N_VECS];
+
+// pcg_solve runs n_iters iterations of the pipelined CG recurrence on A x = b, b being all ones and x starting at 0.
+// With overlap false, the reduction of the dot products is completed before the matrix-vector product.
+static int pcg_solve(overlap_params_t *params, pcg_matrix_t *A, int n_iters, bool overlap, pcg_result_t *res)
+{
+    double *x = vecs[PCG_X], *r = vecs[PCG_R], *w = vecs[PCG_W], *p = vecs[PCG_P];
+    double *s = vecs[PCG_S], *z = vecs[PCG_Z], *q = vecs[PCG_Q];
+    double local[PCG_N_DOTS], global[PCG_N_DOTS];
+    double alpha = 0.0, beta, gamma, gamma_old = 0.0, delta, rr;
+    double start, wait_start, iter_time, wait_time = 0.0;
+    MPI_Request req;
+    int i, k, lo = A->plane, hi = A->plane + A->n_rows;
+
+    for (k = 0; k < PCG_N_VECS; k++)
+        memset(vecs[k], 0, (A->n_rows + 2 * A->plane) * sizeof(double));
+    // r = b - A x = b since x = 0, w = A r
+    for (k = lo; k < hi; k++)
+        r[k] = 1.0;
+    if (pcg_spmv(params, A, r, w))
+        goto exit_error;
+
+    MPI_CHECK(MPI_Barrier(params->comm));
+    start = MPI_Wtime();
+    for (i = 0; i < n_iters; i++)
+    {
+        local[0] = local[1] = 0.0;
+        for (k = lo; k < hi; k++)
+        {
+            local[0] += r[k] * r[k];
+            local[1] += w[k] * r[k];
+        }
+        MPI_CHECK(MPI_Iallreduce(local, global, PCG_N_DOTS, MPI_DOUBLE, MPI_SUM, params->comm, &req));
+        if (!overlap)
+        {
+            wait_start = MPI_Wtime();
+            MPI_CHECK(MPI_Wait(&req, MPI_STATUS_IGNORE));
+            wait_time += MPI_Wtime() - wait_start;
+        }
+        // q = A w, hidden behind the reduction in the pipelined recurrence
+        if (pcg_spmv(params, A, w, q))
+            goto exit_error;
+        if (overlap)
+        {
+            wait_start = MPI_Wtime();
+            MPI_CHECK(MPI_Wait(&req, MPI_STATUS_IGNORE));
+            wait_time += MPI_Wtime() - wait_start;
+        }
+
+        gamma = global[0];
+        delta = global[1];
+        if (i > 0)
+        {
+            beta = gamma / gamma_old;
+            alpha = gamma / (delta - beta * gamma / alpha);
+        }
+        else
+        {
+            beta = 0.0;
+            alpha = gamma / delta;
+        }
+        gamma_old = gamma;
+        for (k = lo; k < hi; k++)
+        {
+            z[k] = q[k] + beta * z[k];
+            s[k] = w[k] + beta * s[k];
+            p[k] = r[k] + beta * p[k];
+            x[k] += alpha * p[k];
+            r[k] -= alpha * s[k];
+            w[k] -= alpha * z[k];
+        }
+    }
+    iter_time = (MPI_Wtime() - start) / n_iters;
+    wait_time /= n_iters;
+
+    // Residual after the last update, outside of the timed iterations
+    local[0] = 0.0;
+    for (k = lo; k < hi; k++)
+        local[0] += r[k] * r[k];
+    MPI_CHECK(MPI_Allreduce(&local[0], &rr, 1, MPI_DOUBLE, MPI_SUM, params->comm));
+    res->residual = sqrt(rr);
+
+    MPI_CHECK(MPI_Reduce(&iter_time, &res->iter_time, 1, MPI_DOUBLE, MPI_MAX, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(&wait_time, &res->wait_time, 1, MPI_DOUBLE, MPI_SUM, 0, params->comm));
+    res->wait_time /= params->world_size;
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// pcg_latency returns the average latency of the reduction of the dot products alone over the ranks (on rank 0)
+static int pcg_latency(overlap_params_t *params, int n_iters, double *latency)
+{
+    double local[PCG_N_DOTS] = {1.0, 1.0}, global[PCG_N_DOTS];
+    double start, total;
+    MPI_Request req;
+    int i;
+
+    for (i = 0; i < PCG_WARMUP_ITERS; i++)
+    {
+        MPI_CHECK(MPI_Iallreduce(local, global, PCG_N_DOTS, MPI_DOUBLE, MPI_SUM, params->comm, &req));
+        MPI_CHECK(MPI_Wait(&req, MPI_STATUS_IGNORE));
+    }
+    MPI_CHECK(MPI_Barrier(params->comm));
+    start = MPI_Wtime();
+    for (i = 0; i < n_iters; i++)
+    {
+        MPI_CHECK(MPI_Iallreduce(local, global, PCG_N_DOTS, MPI_DOUBLE, MPI_SUM, params->comm, &req));
+        MPI_CHECK(MPI_Wait(&req, MPI_STATUS_IGNORE));
+    }
+    total = (MPI_Wtime() - start) / n_iters;
+    MPI_CHECK(MPI_Reduce(&total, latency, 1, MPI_DOUBLE, MPI_SUM, 0, params->comm));
+    *latency /= params->world_size;
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    pcg_matrix_t A;
+    pcg_result_t blocking, pipelined;
+    int n = PCG_DEFAULT_SIZE, n_iters = PCG_DEFAULT_ITERS;
+    double latency = 0.0, hidden;
+    int k;
+
+    memset(&A, 0, sizeof(A));
+    for (k = 0; k < PCG_N_VECS; k++)
+        vecs[k] = NULL;
+    INIT_OVERLAP_BENCH;
+
+    if (!calibrate(&params))
+        goto exit_error;
+
+    if (!overlap_getenv_int(&params, OVERLAP_PCG_SIZE_ENVVAR, 1, &n) ||
+        !overlap_getenv_int(&params, OVERLAP_PCG_ITERS_ENVVAR, 1, &n_iters))
+        goto exit_error;
+
+    if (pcg_build_matrix(&params, n, &A))
+        goto exit_error;
+    for (k = 0; k < PCG_N_VECS; k++)
+        MEMALLOC(vecs[k], double, (A.n_rows + 2 * A.plane) * sizeof(double));
+
+    if (params.world_rank == 0)
+        fprintf(stdout, "3D Poisson problem: %d x %d x %d points per rank (%d x %d x %d in total, %d non-zeros per "
+                        "rank), %d iterations on %d ranks\n",
+                n, n, n, n, n, n * params.world_size, A.row_ptr[A.n_rows], n_iters, params.world_size);
+
+    if (pcg_latency(&params, n_iters, &latency))
+        goto exit_error;
+    // The first solve also warms up the matrix and the vectors
+    if (pcg_solve(&params, &A, PCG_WARMUP_ITERS, false, &blocking))
+        goto exit_error;
+    if (pcg_solve(&params, &A, n_iters, false, &blocking))
+        goto exit_error;
+    if (pcg_solve(&params, &A, n_iters, true, &pipelined))
+        goto exit_error;
+
+    if (params.world_rank == 0)
+    {
+        hidden = latency > 0 ? (latency - pipelined.wait_time) * 100 / latency : 0.0;
+        if (hidden < 0)
+            hidden = 0.0;
+        fprintf(stdout, "Latency of the reduction of the dot products alone: %.2f us\n", latency * 1e6);
+        fprintf(stdout, "Iteration time without overlap: %.2f us (exposed reduction latency: %.2f us)\n",
+                blocking.iter_time * 1e6, blocking.wait_time * 1e6);
+        fprintf(stdout, "Iteration time of the pipelined recurrence: %.2f us (exposed reduction latency: %.2f us)\n",
+                pipelined.iter_time * 1e6, pipelined.wait_time * 1e6);
+        fprintf(stdout, "Hidden reduction latency: %.1f %%\n", hidden);
+        fprintf(stdout, "Residual norm after %d iterations: %e\n", n_iters, pipelined.residual);
+
+        overlap_output_record_header(stdout, PCG_RECORD_FORMAT, PCG_RECORD_VERSION, "overlap_pcg", params.world_size);
+        fprintf(stdout, "\"params\":{\"size\":%d,\"n_iters\":%d},\"rows\":%d,\"nnz\":%d,\"latency\":%.9g,", n, n_iters,
+                A.n_rows, A.row_ptr[A.n_rows], latency * 1e3);
+        fprintf(stdout, "\"blocking_iter_time\":%.9g,\"blocking_exposed_latency\":%.9g,", blocking.iter_time * 1e3,
+                blocking.wait_time * 1e3);
+        fprintf(stdout, "\"iter_time\":%.9g,\"exposed_latency\":%.9g,\"hidden\":%.9g,\"residual\":%.9g}\n",
+                pipelined.iter_time * 1e3, pipelined.wait_time * 1e3, hidden, pipelined.residual);
+    }
+
+    for (k = 0; k < PCG_N_VECS; k++)
+        MEMFREE(vecs[k]);
+    pcg_free_matrix(&A);
+    MPI_Finalize();
+    return EXIT_SUCCESS;
+
+exit_error:
+    for (k = 0; k < PCG_N_VECS; k++)
+        MEMFREE(vecs[k]);
+    pcg_free_matrix(&A);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    return EXIT_FAILURE;
+}
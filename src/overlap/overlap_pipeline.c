@@ -0,0 +1,410 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Pipelined chunked collective operations. Applications often split a large MPI_Iallreduce() or MPI_Ialltoall() into
+// k chunks and compute on chunk i while chunk i+1 is in flight. For every operation, size and number of chunks, the
+// benchmark measures the end-to-end time of that pipeline, the computation consuming the received data, and compares
+// it to the unchunked operation followed by the same computation. The speedup tells which chunk size the MPI library
+// and the fabric reward: too few chunks leave the communication exposed, too many pay the latency of every chunk.
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+#define PIPELINE_N_OPS (2)
+#define PIPELINE_OP_ALLREDUCE (0)
+#define PIPELINE_OP_ALLTOALL (1)
+#define PIPELINE_MAX_CHUNKS (64) // Maximum number of chunk counts and chunk sizes evaluated
+#define PIPELINE_DEFAULT_ITERS (20)
+#define PIPELINE_WARMUP_ITERS (2)
+#define PIPELINE_DEFAULT_COST (16) // Operations per received element of the computation
+#define PIPELINE_RECORD_FORMAT "openhpca_pipeline"
+#define PIPELINE_RECORD_VERSION (1)
+
+#define OVERLAP_PIPELINE_OPS_ENVVAR "OPENHPCA_OVERLAP_PIPELINE_OPS"
+#define OVERLAP_PIPELINE_CHUNKS_ENVVAR "OPENHPCA_OVERLAP_PIPELINE_CHUNKS"
+#define OVERLAP_PIPELINE_CHUNK_SIZES_ENVVAR "OPENHPCA_OVERLAP_PIPELINE_CHUNK_SIZES"
+#define OVERLAP_PIPELINE_ITERS_ENVVAR "OPENHPCA_OVERLAP_PIPELINE_ITERS"
+#define OVERLAP_PIPELINE_COST_ENVVAR "OPENHPCA_OVERLAP_PIPELINE_COST"
+
+static const char *pipeline_op_names[PIPELINE_N_OPS] = {"allreduce", "alltoall"};
+static const int default_chunks[] = {1, 2, 4, 8, 16, 32, 64};
+
+// Buffers used by the benchmark, allocated in main(). The sizes are the number of elements sent by every rank: the
+// all-to-all exchanges blocks of n_elts / world_size elements and every chunk covers the same range of elements in the
+// blocks of all the ranks
+static double *s_buf = NULL, *r_buf = NULL;
+static int *counts = NULL, *displs = NULL;
+static MPI_Request *reqs = NULL;
+static int pipeline_cost = PIPELINE_DEFAULT_COST;
+// Result of the computation, so that it cannot be optimized out
+static volatile double pipeline_sink = 0.0;
+
+// End-to-end time of an operation, a size and a number of chunks in seconds, on the slowest rank
+typedef struct pipeline_result
+{
+    int op;
+    uint64_t n_elts;
+    int n_chunks;
+    double time;
+    double speedup; // Compared to the unchunked operation
+} pipeline_result_t;
+
+// pipeline_compute consumes n elements of received data: every element goes through pipeline_cost dependent
+// multiply-adds, so the computation cannot start before the data is there
+static void pipeline_compute(const double *data, uint64_t n)
+{
+    double acc = 0.0, x;
+    uint64_t i;
+    int c;
+
+    for (i = 0; i < n; i++)
+    {
+        x = data[i];
+        for (c = 0; c < pipeline_cost; c++)
+            x = x * 0.999999 + 1e-6;
+        acc += x;
+    }
+    pipeline_sink += acc;
+}
+
+// pipeline_chunk returns the offset and the number of elements of a chunk, the first chunks getting the remainder
+static inline void pipeline_chunk(uint64_t n_elts, int n_chunks, int chunk, uint64_t *offset, uint64_t *len)
+{
+    uint64_t base = n_elts / n_chunks, rem = n_elts % n_chunks;
+
+    *len = base + ((uint64_t)chunk < rem ? 1 : 0);
+    *offset = chunk * base + ((uint64_t)chunk < rem ? (uint64_t)chunk : rem);
+}
+
+// pipeline_chunk_elts returns the number of elements split into chunks, i.e., the size of the blocks of the all-to-all
+static inline uint64_t pipeline_chunk_elts(overlap_params_t *params, int op, uint64_t n_elts)
+{
+    return op == PIPELINE_OP_ALLTOALL ? n_elts / params->world_size : n_elts;
+}
+
+static int pipeline_post(overlap_params_t *params, int op, uint64_t n_elts, int n_chunks, int chunk, MPI_Request *req)
+{
+    uint64_t block = pipeline_chunk_elts(params, op, n_elts);
+    uint64_t offset, len;
+    int i;
+
+    pipeline_chunk(block, n_chunks, chunk, &offset, &len);
+    if (op == PIPELINE_OP_ALLREDUCE)
+        return MPI_Iallreduce(&s_buf[offset], &r_buf[offset], len, MPI_DOUBLE, MPI_SUM, params->comm, req);
+
+    // Every chunk has its own counts and displacements since they must not change until the operation completes
+    for (i = 0; i < params->world_size; i++)
+    {
+        counts[chunk * params->world_size + i] = len;
+        displs[chunk * params->world_size + i] = i * block + offset;
+    }
+    return MPI_Ialltoallv(s_buf, &counts[chunk * params->world_size], &displs[chunk * params->world_size], MPI_DOUBLE,
+                          r_buf, &counts[chunk * params->world_size], &displs[chunk * params->world_size], MPI_DOUBLE,
+                          params->comm, req);
+}
+
+// pipeline_consume computes on the data received by a chunk
+static void pipeline_consume(overlap_params_t *params, int op, uint64_t n_elts, int n_chunks, int chunk)
+{
+    uint64_t block = pipeline_chunk_elts(params, op, n_elts);
+    uint64_t offset, len;
+    int i;
+
+    pipeline_chunk(block, n_chunks, chunk, &offset, &len);
+    if (op == PIPELINE_OP_ALLREDUCE)
+    {
+        pipeline_compute(&r_buf[offset], len);
+        return;
+    }
+    for (i = 0; i < params->world_size; i++)
+        pipeline_compute(&r_buf[i * block + offset], len);
+}
+
+// pipeline_run executes the pipeline once: chunk 0 is posted, then the computation on chunk i overlaps the
+// communication of chunk i+1. With a single chunk, this is the unchunked operation followed by the computation.
+static int pipeline_run(overlap_params_t *params, int op, uint64_t n_elts, int n_chunks)
+{
+    int chunk;
+
+    MPI_CHECK(pipeline_post(params, op, n_elts, n_chunks, 0, &reqs[0]));
+    for (chunk = 0; chunk < n_chunks; chunk++)
+    {
+        if (chunk + 1 < n_chunks)
+            MPI_CHECK(pipeline_post(params, op, n_elts, n_chunks, chunk + 1, &reqs[chunk + 1]));
+        MPI_CHECK(MPI_Wait(&reqs[chunk], MPI_STATUS_IGNORE));
+        pipeline_consume(params, op, n_elts, n_chunks, chunk);
+    }
+    return MPI_SUCCESS;
+
+exit_error:
+    return MPI_ERR_OTHER;
+}
+
+// pipeline_measure returns the average end-to-end time of the pipeline on the slowest rank (on rank 0)
+static int pipeline_measure(overlap_params_t *params, int op, uint64_t n_elts, int n_chunks, int n_iters, double *time)
+{
+    double start, total = 0.0;
+    int i;
+
+    for (i = 0; i < PIPELINE_WARMUP_ITERS; i++)
+        MPI_CHECK(pipeline_run(params, op, n_elts, n_chunks));
+    for (i = 0; i < n_iters; i++)
+    {
+        MPI_CHECK(MPI_Barrier(params->comm));
+        start = MPI_Wtime();
+        MPI_CHECK(pipeline_run(params, op, n_elts, n_chunks));
+        total += MPI_Wtime() - start;
+    }
+    total /= n_iters;
+    MPI_CHECK(MPI_Reduce(&total, time, 1, MPI_DOUBLE, MPI_MAX, 0, params->comm));
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// pipeline_add_chunks adds a number of chunks to the sorted list of chunk counts, ignoring duplicates
+static int pipeline_add_chunks(int *chunks, int n, int n_chunks)
+{
+    int i, j;
+
+    for (i = 0; i < n && chunks[i] < n_chunks; i++)
+        ;
+    if (i < n && chunks[i] == n_chunks)
+        return n;
+    for (j = n; j > i; j--)
+        chunks[j] = chunks[j - 1];
+    chunks[i] = n_chunks;
+    return n + 1;
+}
+
+// pipeline_find_best finds the fastest chunking of every operation and size. Results are grouped by operation and
+// size, every group starting with the unchunked operation; returns the number of groups
+static int pipeline_find_best(pipeline_result_t *results, int n_results, int *best)
+{
+    int i, n_best = 0;
+
+    for (i = 0; i < n_results; i++)
+    {
+        if (results[i].n_chunks == 1)
+            best[n_best++] = i;
+        else if (results[i].speedup > results[best[n_best - 1]].speedup)
+            best[n_best - 1] = i;
+    }
+    return n_best;
+}
+
+static void pipeline_write_json(overlap_params_t *params, pipeline_result_t *results, int n_results, int *best,
+                                int n_best, int n_iters, FILE *f)
+{
+    pipeline_result_t *res;
+    int i;
+
+    overlap_output_record_header(f, PIPELINE_RECORD_FORMAT, PIPELINE_RECORD_VERSION, "overlap_pipeline",
+                                 params->world_size);
+    fprintf(f, "\"params\":{\"n_iters\":%d,\"cost\":%d},\"results\":[", n_iters, pipeline_cost);
+    for (i = 0; i < n_results; i++)
+    {
+        res = &results[i];
+        fprintf(f, "%s{\"operation\":\"%s\",\"n_elts\":%" PRIu64 ",\"data_size\":%" PRIu64 ",\"chunks\":%d"
+                   ",\"chunk_size\":%" PRIu64 ",\"time\":%.9g,\"speedup\":%.9g}",
+                i > 0 ? "," : "", pipeline_op_names[res->op], res->n_elts, res->n_elts * sizeof(double), res->n_chunks,
+                res->n_elts / res->n_chunks * sizeof(double), res->time * 1e3, res->speedup);
+    }
+    fprintf(f, "],\"best\":[");
+    for (i = 0; i < n_best; i++)
+    {
+        res = &results[best[i]];
+        fprintf(f, "%s{\"operation\":\"%s\",\"data_size\":%" PRIu64 ",\"chunks\":%d,\"chunk_size\":%" PRIu64
+                   ",\"speedup\":%.9g}",
+                i > 0 ? "," : "", pipeline_op_names[res->op], res->n_elts * sizeof(double), res->n_chunks,
+                res->n_elts / res->n_chunks * sizeof(double), res->speedup);
+    }
+    fprintf(f, "]}\n");
+}
+
+int main(int argc, char **argv)
+{
+    char *ops_str, *chunks_str, *chunk_sizes_str;
+    int ops[PIPELINE_N_OPS];
+    int n_ops = PIPELINE_N_OPS;
+    int n_iters = PIPELINE_DEFAULT_ITERS;
+    uint64_t chunk_list[PIPELINE_MAX_CHUNKS], chunk_sizes[PIPELINE_MAX_CHUNKS];
+    int n_chunk_list = 0, n_chunk_sizes = 0;
+    uint64_t sizes[MAX_SWEEP_SIZES];
+    int n_sizes = 0;
+    int chunks[2 * PIPELINE_MAX_CHUNKS + 1];
+    int n_chunks, max_chunks = 1;
+    pipeline_result_t *results = NULL;
+    int n_results = 0;
+    int best[PIPELINE_N_OPS * MAX_SWEEP_SIZES];
+    int n_best;
+    double time, ref_time = 0.0;
+    int i, j, k;
+
+    INIT_OVERLAP_BENCH;
+
+    if (!calibrate(&params))
+        goto exit_error;
+
+    ops[0] = PIPELINE_OP_ALLREDUCE;
+    ops[1] = PIPELINE_OP_ALLTOALL;
+    ops_str = getenv(OVERLAP_PIPELINE_OPS_ENVVAR);
+    if (ops_str)
+        n_ops = parse_name_list(&params, ops_str, pipeline_op_names, PIPELINE_N_OPS, ops);
+    chunks_str = getenv(OVERLAP_PIPELINE_CHUNKS_ENVVAR);
+    if (chunks_str)
+        n_chunk_list = parse_uint_list(&params, chunks_str, 1, chunk_list, PIPELINE_MAX_CHUNKS);
+    else
+    {
+        for (i = 0; i < (int)(sizeof(default_chunks) / sizeof(default_chunks[0])); i++)
+            chunk_list[n_chunk_list++] = default_chunks[i];
+    }
+    chunk_sizes_str = getenv(OVERLAP_PIPELINE_CHUNK_SIZES_ENVVAR);
+    if (chunk_sizes_str)
+        n_chunk_sizes = parse_uint_list(&params, chunk_sizes_str, 1, chunk_sizes, PIPELINE_MAX_CHUNKS);
+    // The environment of rank 0 prevails
+    MPI_CHECK(MPI_Bcast(&n_ops, 1, MPI_INT, 0, params.comm));
+    MPI_CHECK(MPI_Bcast(ops, PIPELINE_N_OPS, MPI_INT, 0, params.comm));
+    MPI_CHECK(MPI_Bcast(&n_chunk_list, 1, MPI_INT, 0, params.comm));
+    MPI_CHECK(MPI_Bcast(chunk_list, PIPELINE_MAX_CHUNKS, MPI_UINT64_T, 0, params.comm));
+    MPI_CHECK(MPI_Bcast(&n_chunk_sizes, 1, MPI_INT, 0, params.comm));
+    MPI_CHECK(MPI_Bcast(chunk_sizes, PIPELINE_MAX_CHUNKS, MPI_UINT64_T, 0, params.comm));
+    if (!overlap_getenv_int(&params, OVERLAP_PIPELINE_ITERS_ENVVAR, 1, &n_iters) ||
+        !overlap_getenv_int(&params, OVERLAP_PIPELINE_COST_ENVVAR, 0, &pipeline_cost))
+        goto exit_error;
+
+    // Pipelining only pays off with large operations, the largest size is evaluated unless a sweep is set
+    if (params.sweep_n_sizes > 0)
+    {
+        for (i = 0; i < params.sweep_n_sizes; i++)
+        {
+            if (params.sweep_sizes[i] <= params.max_elts)
+                sizes[n_sizes++] = params.sweep_sizes[i];
+        }
+    }
+    else
+        sizes[n_sizes++] = params.max_elts;
+
+    // Chunk counts can be given directly or through chunk sizes (in bytes), the number of chunks being bounded by
+    // the number of elements
+    for (i = 0; i < n_chunk_list; i++)
+    {
+        if (chunk_list[i] > params.max_elts)
+            chunk_list[i] = params.max_elts;
+        if ((int)chunk_list[i] > max_chunks)
+            max_chunks = chunk_list[i];
+    }
+    for (i = 0; i < n_chunk_sizes; i++)
+    {
+        uint64_t n = (params.max_elts * sizeof(double) + chunk_sizes[i] - 1) / chunk_sizes[i];
+        if (n > params.max_elts)
+            n = params.max_elts;
+        if ((int)n > max_chunks)
+            max_chunks = n;
+    }
+
+    MEMALLOC(s_buf, double, params.max_elts * sizeof(double));
+    MEMALLOC(r_buf, double, params.max_elts * sizeof(double));
+    MEMALLOC(counts, int, max_chunks * params.world_size * sizeof(int));
+    MEMALLOC(displs, int, max_chunks * params.world_size * sizeof(int));
+    MEMALLOC(reqs, MPI_Request, max_chunks * sizeof(MPI_Request));
+    MEMALLOC(results, pipeline_result_t, n_ops * n_sizes * (n_chunk_list + n_chunk_sizes + 1) * sizeof(pipeline_result_t));
+    for (i = 0; i < (int)params.max_elts; i++)
+        s_buf[i] = params.world_rank + i;
+
+    if (params.world_rank == 0)
+    {
+        fprintf(stdout, "End-to-end time of the chunked operations with the computation on chunk i overlapping chunk "
+                        "i+1, %d iterations on %d ranks, %d operations per element\n",
+                n_iters, params.world_size, pipeline_cost);
+        fprintf(stdout, "Operation\tSize (bytes)\tChunks\tChunk size (bytes)\tTime (ms)\tSpeedup\n");
+    }
+
+    for (i = 0; i < n_ops; i++)
+    {
+        for (j = 0; j < n_sizes; j++)
+        {
+            uint64_t chunk_elts = pipeline_chunk_elts(&params, ops[i], sizes[j]);
+
+            if (chunk_elts == 0)
+                continue; // Not enough elements for a block per rank
+            // The unchunked operation always comes first, it is the reference of the speedups
+            n_chunks = pipeline_add_chunks(chunks, 0, 1);
+            for (k = 0; k < n_chunk_list; k++)
+            {
+                if (chunk_list[k] <= chunk_elts)
+                    n_chunks = pipeline_add_chunks(chunks, n_chunks, chunk_list[k]);
+            }
+            for (k = 0; k < n_chunk_sizes; k++)
+            {
+                uint64_t n = (sizes[j] * sizeof(double) + chunk_sizes[k] - 1) / chunk_sizes[k];
+                if (n <= chunk_elts)
+                    n_chunks = pipeline_add_chunks(chunks, n_chunks, n);
+            }
+
+            for (k = 0; k < n_chunks; k++)
+            {
+                if (pipeline_measure(&params, ops[i], sizes[j], chunks[k], n_iters, &time))
+                    goto exit_error;
+                if (params.world_rank != 0)
+                    continue;
+                if (chunks[k] == 1)
+                    ref_time = time;
+                results[n_results].op = ops[i];
+                results[n_results].n_elts = sizes[j];
+                results[n_results].n_chunks = chunks[k];
+                results[n_results].time = time;
+                results[n_results].speedup = time > 0 ? ref_time / time : 0.0;
+                fprintf(stdout, "%s\t%" PRIu64 "\t%d\t%" PRIu64 "\t%.3f\t%.2f\n", pipeline_op_names[ops[i]],
+                        sizes[j] * sizeof(double), chunks[k], sizes[j] / chunks[k] * sizeof(double), time * 1e3,
+                        results[n_results].speedup);
+                n_results++;
+            }
+        }
+    }
+
+    if (params.world_rank == 0)
+    {
+        pipeline_result_t *res;
+
+        n_best = pipeline_find_best(results, n_results, best);
+        fprintf(stdout, "\n");
+        for (i = 0; i < n_best; i++)
+        {
+            res = &results[best[i]];
+            fprintf(stdout, "Best chunking for %s of %" PRIu64 " bytes: %d chunks of %" PRIu64 " bytes (speedup: %.2f)\n",
+                    pipeline_op_names[res->op], res->n_elts * sizeof(double), res->n_chunks,
+                    res->n_elts / res->n_chunks * sizeof(double), res->speedup);
+        }
+        pipeline_write_json(&params, results, n_results, best, n_best, n_iters, stdout);
+    }
+
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    MEMFREE(counts);
+    MEMFREE(displs);
+    MEMFREE(reqs);
+    MEMFREE(results);
+    MPI_Finalize();
+    return EXIT_SUCCESS;
+
+exit_error:
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    MEMFREE(counts);
+    MEMFREE(displs);
+    MEMFREE(reqs);
+    MEMFREE(results);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,726 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// PMPI interposition library (libopenhpca_pmpi.so) measuring the overlap that applications get from their non-blocking
+// operations. Loaded with LD_PRELOAD, it intercepts the non-blocking collective and point-to-point operations, and the
+// MPI_Wait and MPI_Test families. For every operation, it measures, with PMPI_Wtime() and the definitions of the
+// benchmarks (see overlap_stats.h):
+// - the post time, spent in the MPI_I* call,
+// - the compute gap, between the end of the post and the first MPI_Wait or MPI_Test call on the request, during which
+//   the application computes while the operation is expected to progress,
+// - the wait time, spent in the MPI_Wait and MPI_Test calls involving the request until its completion.
+// Measurements are aggregated per call site, operation and communicator, in per-thread buffers that do not require any
+// lock, and rank 0 writes a JSON summary, which the OpenHPCA tools display with the benchmark results, in MPI_Finalize.
+// A request must be completed by the thread that posted it to be accounted for.
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <dlfcn.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "overlap_stats.h"
+
+#define PMPI_FILE_ENVVAR "OPENHPCA_PMPI_FILE"
+#define PMPI_DEFAULT_FILE "openhpca_pmpi.json"
+#define PMPI_OUTPUT_FORMAT "openhpca_pmpi"
+#define PMPI_OUTPUT_VERSION (1)
+
+#define PMPI_MAX_SITES (1024)    // Per thread, must be a power of 2
+#define PMPI_MAX_REQUESTS (4096) // Per thread, must be a power of 2
+#define PMPI_MAX_SITE_LEN (160)
+#define PMPI_MAX_COMM_LEN (64)
+#define PMPI_STACK_REQUESTS (64) // Number of requests of the MPI_Wait/MPI_Test calls copied on the stack
+
+#define PMPI_OPS                                      \
+    PMPI_OP(IBARRIER, "MPI_Ibarrier")                 \
+    PMPI_OP(IBCAST, "MPI_Ibcast")                     \
+    PMPI_OP(IGATHER, "MPI_Igather")                   \
+    PMPI_OP(IGATHERV, "MPI_Igatherv")                 \
+    PMPI_OP(ISCATTER, "MPI_Iscatter")                 \
+    PMPI_OP(ISCATTERV, "MPI_Iscatterv")               \
+    PMPI_OP(IALLGATHER, "MPI_Iallgather")             \
+    PMPI_OP(IALLGATHERV, "MPI_Iallgatherv")           \
+    PMPI_OP(IALLTOALL, "MPI_Ialltoall")               \
+    PMPI_OP(IALLTOALLV, "MPI_Ialltoallv")             \
+    PMPI_OP(IALLTOALLW, "MPI_Ialltoallw")             \
+    PMPI_OP(IREDUCE, "MPI_Ireduce")                   \
+    PMPI_OP(IALLREDUCE, "MPI_Iallreduce")             \
+    PMPI_OP(IREDUCE_SCATTER, "MPI_Ireduce_scatter")   \
+    PMPI_OP(IREDUCE_SCATTER_BLOCK, "MPI_Ireduce_scatter_block") \
+    PMPI_OP(ISCAN, "MPI_Iscan")                       \
+    PMPI_OP(IEXSCAN, "MPI_Iexscan")                   \
+    PMPI_OP(ISEND, "MPI_Isend")                       \
+    PMPI_OP(IBSEND, "MPI_Ibsend")                     \
+    PMPI_OP(ISSEND, "MPI_Issend")                     \
+    PMPI_OP(IRSEND, "MPI_Irsend")                     \
+    PMPI_OP(IRECV, "MPI_Irecv")
+
+#define PMPI_OP(_id, _name) PMPI_OP_##_id,
+enum
+{
+    PMPI_OPS PMPI_N_OPS
+};
+#undef PMPI_OP
+
+#define PMPI_OP(_id, _name) _name,
+static const char *pmpi_op_names[PMPI_N_OPS] = {PMPI_OPS};
+#undef PMPI_OP
+
+// Measurements of a call site, for a given operation and communicator; times are in seconds
+typedef struct pmpi_site
+{
+    void *addr; // NULL if the entry is free
+    int op;
+    MPI_Comm comm;
+    char comm_name[PMPI_MAX_COMM_LEN];
+    int comm_size;
+    uint64_t count; // Number of completed operations
+    double post_time;
+    double gap_time;
+    double wait_time;
+} pmpi_site_t;
+
+// Operation in flight
+typedef struct pmpi_request
+{
+    bool used;
+    MPI_Request req;
+    pmpi_site_t *site;
+    double post_time;
+    double post_end;
+    double first_call; // Start of the first MPI_Wait/MPI_Test call on the request, negative until then
+    double wait_time;
+} pmpi_request_t;
+
+typedef struct pmpi_thread
+{
+    pmpi_site_t sites[PMPI_MAX_SITES];
+    pmpi_request_t reqs[PMPI_MAX_REQUESTS];
+    uint64_t dropped; // Operations that could not be tracked because the tables were full
+    struct pmpi_thread *next;
+} pmpi_thread_t;
+
+// Aggregated measurements, exchanged between the ranks at the end of the execution
+typedef struct pmpi_record
+{
+    char site[PMPI_MAX_SITE_LEN];
+    char comm[PMPI_MAX_COMM_LEN];
+    int op;
+    int comm_size;
+    uint64_t count;
+    double post_time;
+    double gap_time;
+    double wait_time;
+} pmpi_record_t;
+
+static __thread pmpi_thread_t *pmpi_thread = NULL;
+// List of the buffers of all the threads, only modified with atomic operations
+static pmpi_thread_t *pmpi_threads = NULL;
+
+static pmpi_thread_t *pmpi_get_thread()
+{
+    pmpi_thread_t *t = pmpi_thread;
+    if (t != NULL)
+        return t;
+
+    t = (pmpi_thread_t *)calloc(1, sizeof(pmpi_thread_t));
+    if (t == NULL)
+        return NULL;
+    t->next = __atomic_load_n(&pmpi_threads, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&pmpi_threads, &t->next, t, false, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+        ;
+    pmpi_thread = t;
+    return t;
+}
+
+static inline uint64_t pmpi_hash(const void *key, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    uint64_t h = 14695981039346656037ULL; // FNV-1a
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static pmpi_site_t *pmpi_get_site(pmpi_thread_t *t, void *addr, int op, MPI_Comm comm)
+{
+    struct
+    {
+        void *addr;
+        int op;
+        MPI_Comm comm;
+    } key;
+    uint64_t i, n;
+    int len = 0;
+
+    memset(&key, 0, sizeof(key));
+    key.addr = addr;
+    key.op = op;
+    key.comm = comm;
+    i = pmpi_hash(&key, sizeof(key)) & (PMPI_MAX_SITES - 1);
+    for (n = 0; n < PMPI_MAX_SITES; n++, i = (i + 1) & (PMPI_MAX_SITES - 1))
+    {
+        pmpi_site_t *s = &t->sites[i];
+        if (s->addr == addr && s->op == op && s->comm == comm)
+            return s;
+        if (s->addr == NULL)
+        {
+            // The communicator may be freed before the end of the execution, it is described right away
+            s->addr = addr;
+            s->op = op;
+            s->comm = comm;
+            PMPI_Comm_get_name(comm, s->comm_name, &len);
+            PMPI_Comm_size(comm, &s->comm_size);
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static inline uint64_t pmpi_request_slot(MPI_Request req)
+{
+    return pmpi_hash(&req, sizeof(MPI_Request)) & (PMPI_MAX_REQUESTS - 1);
+}
+
+static pmpi_request_t *pmpi_find_request(pmpi_thread_t *t, MPI_Request req)
+{
+    uint64_t i = pmpi_request_slot(req), n;
+    for (n = 0; n < PMPI_MAX_REQUESTS && t->reqs[i].used; n++, i = (i + 1) & (PMPI_MAX_REQUESTS - 1))
+    {
+        if (memcmp(&t->reqs[i].req, &req, sizeof(MPI_Request)) == 0)
+            return &t->reqs[i];
+    }
+    return NULL;
+}
+
+// pmpi_remove_request removes an entry of the open-addressing table, moving back the entries that follow it so that
+// no lookup is broken
+static void pmpi_remove_request(pmpi_thread_t *t, pmpi_request_t *r)
+{
+    uint64_t i = r - t->reqs, j = i, k;
+    for (;;)
+    {
+        j = (j + 1) & (PMPI_MAX_REQUESTS - 1);
+        if (!t->reqs[j].used)
+            break;
+        k = pmpi_request_slot(t->reqs[j].req);
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+        t->reqs[i] = t->reqs[j];
+        i = j;
+    }
+    t->reqs[i].used = false;
+}
+
+static void pmpi_post(int op, void *addr, MPI_Comm comm, MPI_Request req, double start, double end)
+{
+    pmpi_thread_t *t = pmpi_get_thread();
+    pmpi_site_t *site;
+    uint64_t i, n;
+
+    if (t == NULL)
+        return;
+    site = pmpi_get_site(t, addr, op, comm);
+    if (site == NULL)
+    {
+        t->dropped++;
+        return;
+    }
+    i = pmpi_request_slot(req);
+    for (n = 0; n < PMPI_MAX_REQUESTS && t->reqs[i].used; n++)
+        i = (i + 1) & (PMPI_MAX_REQUESTS - 1);
+    if (n == PMPI_MAX_REQUESTS)
+    {
+        t->dropped++;
+        return;
+    }
+    t->reqs[i].used = true;
+    t->reqs[i].req = req;
+    t->reqs[i].site = site;
+    t->reqs[i].post_time = end - start;
+    t->reqs[i].post_end = end;
+    t->reqs[i].first_call = -1.0;
+    t->reqs[i].wait_time = 0.0;
+}
+
+// pmpi_complete accounts for a MPI_Wait/MPI_Test call involving a request, completed or not
+static void pmpi_complete(MPI_Request req, bool completed, double start, double end)
+{
+    pmpi_thread_t *t = pmpi_thread;
+    pmpi_request_t *r;
+
+    if (t == NULL || req == MPI_REQUEST_NULL)
+        return;
+    r = pmpi_find_request(t, req);
+    if (r == NULL)
+        return;
+    if (r->first_call < 0)
+        r->first_call = start;
+    r->wait_time += end - start;
+    if (!completed)
+        return;
+
+    r->site->count++;
+    r->site->post_time += r->post_time;
+    r->site->gap_time += r->first_call - r->post_end;
+    r->site->wait_time += r->wait_time;
+    pmpi_remove_request(t, r);
+}
+
+// PMPI_POST times a non-blocking operation and records it with the call site of the application
+#define PMPI_POST(_op, _comm, _request, _call)                                       \
+    do                                                                               \
+    {                                                                                \
+        void *_addr = __builtin_return_address(0);                                   \
+        double _start = PMPI_Wtime();                                                \
+        int _rc = _call;                                                             \
+        if (_rc == MPI_SUCCESS)                                                      \
+            pmpi_post(_op, _addr, _comm, *(_request), _start, PMPI_Wtime());         \
+        return _rc;                                                                  \
+    } while (0)
+
+int MPI_Ibarrier(MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IBARRIER, comm, request, PMPI_Ibarrier(comm, request));
+}
+
+int MPI_Ibcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IBCAST, comm, request, PMPI_Ibcast(buffer, count, datatype, root, comm, request));
+}
+
+int MPI_Igather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IGATHER, comm, request,
+              PMPI_Igather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm, request));
+}
+
+int MPI_Igatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                 const int displs[], MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IGATHERV, comm, request,
+              PMPI_Igatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm, request));
+}
+
+int MPI_Iscatter(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                 MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_ISCATTER, comm, request,
+              PMPI_Iscatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm, request));
+}
+
+int MPI_Iscatterv(const void *sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype,
+                  void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_ISCATTERV, comm, request,
+              PMPI_Iscatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm, request));
+}
+
+int MPI_Iallgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                   MPI_Datatype recvtype, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IALLGATHER, comm, request,
+              PMPI_Iallgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm, request));
+}
+
+int MPI_Iallgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                    const int displs[], MPI_Datatype recvtype, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IALLGATHERV, comm, request,
+              PMPI_Iallgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm, request));
+}
+
+int MPI_Ialltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                  MPI_Datatype recvtype, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IALLTOALL, comm, request,
+              PMPI_Ialltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm, request));
+}
+
+int MPI_Ialltoallv(const void *sendbuf, const int sendcounts[], const int sdispls[], MPI_Datatype sendtype,
+                   void *recvbuf, const int recvcounts[], const int rdispls[], MPI_Datatype recvtype, MPI_Comm comm,
+                   MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IALLTOALLV, comm, request,
+              PMPI_Ialltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf, recvcounts, rdispls, recvtype, comm, request));
+}
+
+int MPI_Ialltoallw(const void *sendbuf, const int sendcounts[], const int sdispls[], const MPI_Datatype sendtypes[],
+                   void *recvbuf, const int recvcounts[], const int rdispls[], const MPI_Datatype recvtypes[],
+                   MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IALLTOALLW, comm, request,
+              PMPI_Ialltoallw(sendbuf, sendcounts, sdispls, sendtypes, recvbuf, recvcounts, rdispls, recvtypes, comm, request));
+}
+
+int MPI_Ireduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root,
+                MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IREDUCE, comm, request, PMPI_Ireduce(sendbuf, recvbuf, count, datatype, op, root, comm, request));
+}
+
+int MPI_Iallreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+                   MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IALLREDUCE, comm, request, PMPI_Iallreduce(sendbuf, recvbuf, count, datatype, op, comm, request));
+}
+
+int MPI_Ireduce_scatter(const void *sendbuf, void *recvbuf, const int recvcounts[], MPI_Datatype datatype, MPI_Op op,
+                        MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IREDUCE_SCATTER, comm, request,
+              PMPI_Ireduce_scatter(sendbuf, recvbuf, recvcounts, datatype, op, comm, request));
+}
+
+int MPI_Ireduce_scatter_block(const void *sendbuf, void *recvbuf, int recvcount, MPI_Datatype datatype, MPI_Op op,
+                              MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IREDUCE_SCATTER_BLOCK, comm, request,
+              PMPI_Ireduce_scatter_block(sendbuf, recvbuf, recvcount, datatype, op, comm, request));
+}
+
+int MPI_Iscan(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+              MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_ISCAN, comm, request, PMPI_Iscan(sendbuf, recvbuf, count, datatype, op, comm, request));
+}
+
+int MPI_Iexscan(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+                MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IEXSCAN, comm, request, PMPI_Iexscan(sendbuf, recvbuf, count, datatype, op, comm, request));
+}
+
+int MPI_Isend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_ISEND, comm, request, PMPI_Isend(buf, count, datatype, dest, tag, comm, request));
+}
+
+int MPI_Ibsend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IBSEND, comm, request, PMPI_Ibsend(buf, count, datatype, dest, tag, comm, request));
+}
+
+int MPI_Issend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_ISSEND, comm, request, PMPI_Issend(buf, count, datatype, dest, tag, comm, request));
+}
+
+int MPI_Irsend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IRSEND, comm, request, PMPI_Irsend(buf, count, datatype, dest, tag, comm, request));
+}
+
+int MPI_Irecv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request *request)
+{
+    PMPI_POST(PMPI_OP_IRECV, comm, request, PMPI_Irecv(buf, count, datatype, source, tag, comm, request));
+}
+
+int MPI_Wait(MPI_Request *request, MPI_Status *status)
+{
+    MPI_Request req = *request;
+    double start = PMPI_Wtime();
+    int rc = PMPI_Wait(request, status);
+    pmpi_complete(req, rc == MPI_SUCCESS, start, PMPI_Wtime());
+    return rc;
+}
+
+int MPI_Test(MPI_Request *request, int *flag, MPI_Status *status)
+{
+    MPI_Request req = *request;
+    double start = PMPI_Wtime();
+    int rc = PMPI_Test(request, flag, status);
+    pmpi_complete(req, rc == MPI_SUCCESS && *flag, start, PMPI_Wtime());
+    return rc;
+}
+
+// A freed request completes without any MPI_Wait/MPI_Test call, its handle may be reused for another operation
+int MPI_Request_free(MPI_Request *request)
+{
+    pmpi_thread_t *t = pmpi_thread;
+    pmpi_request_t *r;
+
+    if (t != NULL && (r = pmpi_find_request(t, *request)) != NULL)
+        pmpi_remove_request(t, r);
+    return PMPI_Request_free(request);
+}
+
+// The requests of the calls completing several requests are copied since the completed ones are set to
+// MPI_REQUEST_NULL; completed[i] is set for the requests that completed
+#define PMPI_COMPLETE_MANY(_count, _requests, _call, _completed)                  \
+    do                                                                            \
+    {                                                                             \
+        MPI_Request _stack_reqs[PMPI_STACK_REQUESTS];                             \
+        MPI_Request *_reqs = _stack_reqs;                                         \
+        double _start, _end;                                                      \
+        int _rc, i;                                                               \
+        if ((_count) > PMPI_STACK_REQUESTS)                                       \
+            _reqs = (MPI_Request *)malloc((_count) * sizeof(MPI_Request));        \
+        if (_reqs != NULL && (_count) > 0)                                        \
+            memcpy(_reqs, _requests, (_count) * sizeof(MPI_Request));             \
+        _start = PMPI_Wtime();                                                    \
+        _rc = _call;                                                              \
+        _end = PMPI_Wtime();                                                      \
+        if (_reqs != NULL)                                                        \
+        {                                                                         \
+            for (i = 0; i < (_count); i++)                                        \
+                pmpi_complete(_reqs[i], _rc == MPI_SUCCESS && (_completed), _start, _end); \
+            if (_reqs != _stack_reqs)                                             \
+                free(_reqs);                                                      \
+        }                                                                         \
+        return _rc;                                                               \
+    } while (0)
+
+static inline bool pmpi_in_indices(int i, int outcount, const int indices[])
+{
+    int j;
+    if (outcount == MPI_UNDEFINED)
+        return false;
+    for (j = 0; j < outcount; j++)
+    {
+        if (indices[j] == i)
+            return true;
+    }
+    return false;
+}
+
+int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[])
+{
+    PMPI_COMPLETE_MANY(count, array_of_requests, PMPI_Waitall(count, array_of_requests, array_of_statuses), true);
+}
+
+int MPI_Waitany(int count, MPI_Request array_of_requests[], int *index, MPI_Status *status)
+{
+    PMPI_COMPLETE_MANY(count, array_of_requests, PMPI_Waitany(count, array_of_requests, index, status), *index == i);
+}
+
+int MPI_Waitsome(int incount, MPI_Request array_of_requests[], int *outcount, int array_of_indices[],
+                 MPI_Status array_of_statuses[])
+{
+    PMPI_COMPLETE_MANY(incount, array_of_requests,
+                       PMPI_Waitsome(incount, array_of_requests, outcount, array_of_indices, array_of_statuses),
+                       pmpi_in_indices(i, *outcount, array_of_indices));
+}
+
+int MPI_Testall(int count, MPI_Request array_of_requests[], int *flag, MPI_Status array_of_statuses[])
+{
+    PMPI_COMPLETE_MANY(count, array_of_requests, PMPI_Testall(count, array_of_requests, flag, array_of_statuses), *flag);
+}
+
+int MPI_Testany(int count, MPI_Request array_of_requests[], int *index, int *flag, MPI_Status *status)
+{
+    PMPI_COMPLETE_MANY(count, array_of_requests, PMPI_Testany(count, array_of_requests, index, flag, status),
+                       *flag && *index == i);
+}
+
+int MPI_Testsome(int incount, MPI_Request array_of_requests[], int *outcount, int array_of_indices[],
+                 MPI_Status array_of_statuses[])
+{
+    PMPI_COMPLETE_MANY(incount, array_of_requests,
+                       PMPI_Testsome(incount, array_of_requests, outcount, array_of_indices, array_of_statuses),
+                       pmpi_in_indices(i, *outcount, array_of_indices));
+}
+
+// pmpi_site_name describes a call site independently of the address the binary is loaded at, so that the call sites
+// of all the ranks can be merged
+static void pmpi_site_name(void *addr, char *name, size_t len)
+{
+    Dl_info info;
+    const char *module;
+
+    if (dladdr(addr, &info) == 0 || info.dli_fname == NULL)
+    {
+        snprintf(name, len, "%p", addr);
+        return;
+    }
+    module = strrchr(info.dli_fname, '/') != NULL ? strrchr(info.dli_fname, '/') + 1 : info.dli_fname;
+    if (info.dli_sname != NULL)
+        snprintf(name, len, "%s+0x%lx (%s)", info.dli_sname, (unsigned long)((char *)addr - (char *)info.dli_saddr), module);
+    else
+        snprintf(name, len, "%s+0x%lx", module, (unsigned long)((char *)addr - (char *)info.dli_fbase));
+}
+
+// pmpi_merge adds a record to an array of records, merging it with the record of the same call site, operation and
+// communicator if any; returns the new number of records
+static int pmpi_merge(pmpi_record_t *records, int n, pmpi_record_t *rec)
+{
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        if (records[i].op == rec->op && records[i].comm_size == rec->comm_size && strcmp(records[i].site, rec->site) == 0 &&
+            strcmp(records[i].comm, rec->comm) == 0)
+        {
+            records[i].count += rec->count;
+            records[i].post_time += rec->post_time;
+            records[i].gap_time += rec->gap_time;
+            records[i].wait_time += rec->wait_time;
+            return n;
+        }
+    }
+    records[n] = *rec;
+    return n + 1;
+}
+
+// Writes a time per operation in milli-seconds
+static void pmpi_write_time(FILE *f, const char *key, double total, uint64_t count)
+{
+    fprintf(f, ",\"%s\":%.9g", key, count > 0 ? total / count * 1000 : 0.0);
+}
+
+static void pmpi_write_summary(FILE *f, int world_size, pmpi_record_t *records, int n, uint64_t dropped)
+{
+    int i;
+    fprintf(f, "{\"format\":\"%s\",\"version\":%d,\"world_size\":%d,\"dropped\":%llu,\"calls\":[", PMPI_OUTPUT_FORMAT,
+            PMPI_OUTPUT_VERSION, world_size, (unsigned long long)dropped);
+    for (i = 0; i < n; i++)
+    {
+        pmpi_record_t *r = &records[i];
+        double active = r->gap_time + r->wait_time;
+        double overlap;
+        const char *c;
+
+        fprintf(f, "%s{\"site\":\"", i > 0 ? "," : "");
+        for (c = r->site; *c != '\0'; c++)
+            fprintf(f, (*c == '"' || *c == '\\') ? "\\%c" : "%c", *c);
+        fprintf(f, "\",\"operation\":\"%s\",\"comm\":\"", pmpi_op_names[r->op]);
+        for (c = r->comm; *c != '\0'; c++)
+            fprintf(f, (*c == '"' || *c == '\\') ? "\\%c" : "%c", *c);
+        fprintf(f, "\",\"comm_size\":%d,\"count\":%llu", r->comm_size, (unsigned long long)r->count);
+        pmpi_write_time(f, "post_time", r->post_time, r->count);
+        pmpi_write_time(f, "gap_time", r->gap_time, r->count);
+        pmpi_write_time(f, "wait_time", r->wait_time, r->count);
+        if (active > 0)
+        {
+            // The compute gap is the work overlapped with the operation, like the injected work of the benchmarks
+            GET_OVERLAP(overlap, active, r->gap_time);
+            fprintf(f, ",\"overlap\":%.9g}", overlap * 100);
+        }
+        else
+            fprintf(f, ",\"overlap\":null}");
+    }
+    fprintf(f, "]}\n");
+}
+
+// MPI_Finalize gathers the measurements of all the ranks on rank 0, which writes the summary
+int MPI_Finalize(void)
+{
+    pmpi_record_t *records = NULL, *all_records = NULL;
+    int *counts = NULL, *displs = NULL;
+    int world_rank, world_size, n = 0, n_all = 0, i, j, failed, any_failed;
+    uint64_t dropped = 0, total_dropped = 0;
+    pmpi_thread_t *t;
+    pmpi_record_t rec;
+    char *file;
+    FILE *f;
+
+    PMPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    PMPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    for (t = __atomic_load_n(&pmpi_threads, __ATOMIC_ACQUIRE); t != NULL; t = t->next)
+    {
+        for (i = 0; i < PMPI_MAX_SITES; i++)
+            n += t->sites[i].addr != NULL && t->sites[i].count > 0;
+        dropped += t->dropped;
+    }
+    records = (pmpi_record_t *)calloc(n > 0 ? n : 1, sizeof(pmpi_record_t));
+    counts = (int *)calloc(world_size, sizeof(int));
+    displs = (int *)calloc(world_size, sizeof(int));
+    // All the ranks must agree before entering the collective operations, otherwise the ranks that could allocate
+    // their buffers would wait forever for the ones that could not
+    failed = records == NULL || counts == NULL || displs == NULL;
+    PMPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (any_failed)
+    {
+        if (world_rank == 0)
+            fprintf(stderr, "[openhpca_pmpi] Out of resource, no summary written\n");
+        goto exit;
+    }
+
+    n = 0;
+    for (t = __atomic_load_n(&pmpi_threads, __ATOMIC_ACQUIRE); t != NULL; t = t->next)
+    {
+        for (i = 0; i < PMPI_MAX_SITES; i++)
+        {
+            pmpi_site_t *s = &t->sites[i];
+            if (s->addr == NULL || s->count == 0)
+                continue;
+            memset(&rec, 0, sizeof(rec));
+            pmpi_site_name(s->addr, rec.site, PMPI_MAX_SITE_LEN);
+            if (s->comm_name[0] != '\0')
+                snprintf(rec.comm, PMPI_MAX_COMM_LEN, "%s", s->comm_name);
+            else
+                snprintf(rec.comm, PMPI_MAX_COMM_LEN, "unnamed");
+            rec.op = s->op;
+            rec.comm_size = s->comm_size;
+            rec.count = s->count;
+            rec.post_time = s->post_time;
+            rec.gap_time = s->gap_time;
+            rec.wait_time = s->wait_time;
+            n = pmpi_merge(records, n, &rec);
+        }
+    }
+
+    // The records are exchanged as bytes, all the ranks run the same library
+    n *= sizeof(pmpi_record_t);
+    PMPI_Gather(&n, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    PMPI_Reduce(&dropped, &total_dropped, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (world_rank == 0)
+    {
+        for (i = 0; i < world_size; i++)
+        {
+            displs[i] = n_all;
+            n_all += counts[i];
+        }
+        all_records = (pmpi_record_t *)malloc(n_all > 0 ? n_all : 1);
+        failed = all_records == NULL;
+        if (failed)
+            fprintf(stderr, "[openhpca_pmpi] Out of resource, no summary written\n");
+    }
+    // Only rank 0 receives the records, the other ranks skip the gather with it when it cannot
+    PMPI_Bcast(&failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (failed)
+        goto exit;
+    PMPI_Gatherv(records, n, MPI_BYTE, all_records, counts, displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+
+    if (world_rank == 0)
+    {
+        n_all /= sizeof(pmpi_record_t);
+        for (i = 0, j = 0; i < n_all; i++)
+            j = pmpi_merge(all_records, j, &all_records[i]);
+
+        file = getenv(PMPI_FILE_ENVVAR);
+        if (file == NULL || *file == '\0')
+            file = PMPI_DEFAULT_FILE;
+        f = fopen(file, "w");
+        if (f == NULL)
+            fprintf(stderr, "[openhpca_pmpi] Unable to open %s\n", file);
+        else
+        {
+            pmpi_write_summary(f, world_size, all_records, j, total_dropped);
+            fclose(f);
+            fprintf(stderr, "[openhpca_pmpi] Overlap summary of %d call sites written to %s\n", j, file);
+        }
+    }
+
+exit:
+    free(all_records);
+    free(records);
+    free(counts);
+    free(displs);
+    return PMPI_Finalize();
+}
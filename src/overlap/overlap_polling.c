@@ -0,0 +1,344 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Cost of polling a non-blocking collective operation. Applications overlapping their communication with computation
+// must call MPI_Test() to progress it, or block in MPI_Wait(); every call to MPI_Test() is time taken from the
+// computation. For every operation and size, the benchmark measures:
+// - the distribution of the cost of a MPI_Test() call, as a histogram of power-of-two buckets of nanoseconds, and the
+//   cost of the call completing the operation;
+// - the number of MPI_Test() calls until the completion of the operation;
+// - the time to complete the operation when spinning on MPI_Test() against the time when blocking in MPI_Wait().
+// Results of all the ranks are aggregated on rank 0, which also writes a JSON record (format "openhpca_polling").
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "overlap.h"
+#include "overlap_pvar.h"
+#include "overlap_cvar.h"
+#include "overlap_output.h"
+#include "overlap_tdm.h"
+
+#define POLLING_N_OPS (5)
+#define POLLING_OP_IBARRIER (4)
+#define POLLING_DEFAULT_ITERS (100)
+#define POLLING_WARMUP_ITERS (10)
+#define POLLING_SIZE_FACTOR (8) // Sizes are multiplied by that factor from min_elts to max_elts unless a sweep is set
+#define POLLING_N_BUCKETS (32)  // Bucket i gathers the calls that took [2^i, 2^(i+1)) nanoseconds
+#define POLLING_RECORD_FORMAT "openhpca_polling"
+#define POLLING_RECORD_VERSION (1)
+
+#define OVERLAP_POLLING_OPS_ENVVAR "OPENHPCA_OVERLAP_POLLING_OPS"
+#define OVERLAP_POLLING_ITERS_ENVVAR "OPENHPCA_OVERLAP_POLLING_ITERS"
+
+static const char *polling_op_names[POLLING_N_OPS] = {"iallreduce", "ibcast", "iallgather", "ialltoall", "ibarrier"};
+
+// Buffers used by the benchmark, allocated in main()
+static double *s_buf = NULL, *r_buf = NULL;
+
+// Measurements of an operation and a size; times are in seconds. Once aggregated on rank 0, sums are over all the
+// ranks and all the iterations, minimums and maximums over all the ranks.
+typedef struct polling_result
+{
+    double test_time;       // Sum of the costs of the MPI_Test() calls
+    double test_min;        // Cost of the cheapest MPI_Test() call
+    double test_max;        // Cost of the most expensive MPI_Test() call
+    double completing_time; // Sum of the costs of the MPI_Test() calls completing the operation
+    double spin_time;       // Sum of the times from the post to the completion with MPI_Test()
+    double wait_time;       // Sum of the times from the post to the completion with MPI_Wait()
+    uint64_t n_tests;
+    uint64_t max_tests; // Highest number of MPI_Test() calls to complete an operation
+    uint64_t buckets[POLLING_N_BUCKETS];
+} polling_result_t;
+
+static int polling_post(overlap_params_t *params, int op, uint64_t n_elts, MPI_Request *req)
+{
+    switch (op)
+    {
+    case 0:
+        return MPI_Iallreduce(s_buf, r_buf, n_elts, MPI_DOUBLE, MPI_SUM, params->comm, req);
+    case 1:
+        return MPI_Ibcast(r_buf, n_elts, MPI_DOUBLE, 0, params->comm, req);
+    case 2:
+        return MPI_Iallgather(s_buf, n_elts, MPI_DOUBLE, r_buf, n_elts, MPI_DOUBLE, params->comm, req);
+    case 3:
+        return MPI_Ialltoall(s_buf, n_elts, MPI_DOUBLE, r_buf, n_elts, MPI_DOUBLE, params->comm, req);
+    default:
+        return MPI_Ibarrier(params->comm, req);
+    }
+}
+
+static inline int polling_bucket(double cost)
+{
+    double ns = cost * 1e9;
+    int i = 0;
+
+    while (i < POLLING_N_BUCKETS - 1 && ns >= (double)(UINT64_C(2) << i))
+        i++;
+    return i;
+}
+
+// polling_percentile returns the upper bound, in seconds, of the bucket including the given percentile of the calls,
+// capped by the most expensive call
+static double polling_percentile(polling_result_t *res, double percentile)
+{
+    double bound;
+    uint64_t target = (uint64_t)(res->n_tests * percentile / 100);
+    uint64_t count = 0;
+    int i;
+
+    for (i = 0; i < POLLING_N_BUCKETS; i++)
+    {
+        count += res->buckets[i];
+        if (count > target)
+            break;
+    }
+    if (i == POLLING_N_BUCKETS)
+        i--;
+    bound = (double)(UINT64_C(2) << i) / 1e9;
+    return bound < res->test_max ? bound : res->test_max;
+}
+
+// polling_measure measures the cost of completing n_iters operations with MPI_Test() and with MPI_Wait() on the
+// calling rank; it must be called by all the ranks of params->comm
+static int polling_measure(overlap_params_t *params, int op, uint64_t n_elts, int n_iters, polling_result_t *res)
+{
+    MPI_Request req;
+    double start, now, before, cost = 0.0;
+    uint64_t n_tests;
+    int completed;
+    int i;
+
+    memset(res, 0, sizeof(polling_result_t));
+    res->test_min = 1e9;
+
+    for (i = 0; i < POLLING_WARMUP_ITERS; i++)
+    {
+        MPI_CHECK(polling_post(params, op, n_elts, &req));
+        MPI_CHECK(MPI_Wait(&req, MPI_STATUS_IGNORE));
+    }
+
+    for (i = 0; i < n_iters; i++)
+    {
+        MPI_CHECK(MPI_Barrier(params->comm));
+        start = MPI_Wtime();
+        MPI_CHECK(polling_post(params, op, n_elts, &req));
+        now = MPI_Wtime();
+        n_tests = 0;
+        do
+        {
+            before = now;
+            MPI_CHECK(MPI_Test(&req, &completed, MPI_STATUS_IGNORE));
+            now = MPI_Wtime();
+            cost = now - before;
+            res->test_time += cost;
+            if (cost < res->test_min)
+                res->test_min = cost;
+            if (cost > res->test_max)
+                res->test_max = cost;
+            res->buckets[polling_bucket(cost)]++;
+            n_tests++;
+        } while (!completed);
+        res->completing_time += cost;
+        res->spin_time += now - start;
+        res->n_tests += n_tests;
+        if (n_tests > res->max_tests)
+            res->max_tests = n_tests;
+    }
+
+    for (i = 0; i < n_iters; i++)
+    {
+        MPI_CHECK(MPI_Barrier(params->comm));
+        start = MPI_Wtime();
+        MPI_CHECK(polling_post(params, op, n_elts, &req));
+        MPI_CHECK(MPI_Wait(&req, MPI_STATUS_IGNORE));
+        res->wait_time += MPI_Wtime() - start;
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// polling_aggregate gathers the measurements of all the ranks on rank 0
+static int polling_aggregate(overlap_params_t *params, polling_result_t *local, polling_result_t *res)
+{
+    double sums[4] = {local->test_time, local->completing_time, local->spin_time, local->wait_time};
+    double global_sums[4];
+    uint64_t counts[POLLING_N_BUCKETS + 1];
+    uint64_t global_counts[POLLING_N_BUCKETS + 1];
+
+    memcpy(counts, local->buckets, POLLING_N_BUCKETS * sizeof(uint64_t));
+    counts[POLLING_N_BUCKETS] = local->n_tests;
+    memset(res, 0, sizeof(polling_result_t));
+
+    MPI_CHECK(MPI_Reduce(sums, global_sums, 4, MPI_DOUBLE, MPI_SUM, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(counts, global_counts, POLLING_N_BUCKETS + 1, MPI_UINT64_T, MPI_SUM, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(&local->test_min, &res->test_min, 1, MPI_DOUBLE, MPI_MIN, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(&local->test_max, &res->test_max, 1, MPI_DOUBLE, MPI_MAX, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(&local->max_tests, &res->max_tests, 1, MPI_UINT64_T, MPI_MAX, 0, params->comm));
+
+    if (params->world_rank == 0)
+    {
+        res->test_time = global_sums[0];
+        res->completing_time = global_sums[1];
+        res->spin_time = global_sums[2];
+        res->wait_time = global_sums[3];
+        memcpy(res->buckets, global_counts, POLLING_N_BUCKETS * sizeof(uint64_t));
+        res->n_tests = global_counts[POLLING_N_BUCKETS];
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+static void polling_display(overlap_params_t *params, int op, uint64_t n_elts, int n_iters, polling_result_t *res)
+{
+    double n_ops = (double)n_iters * params->world_size;
+    double spin_time = res->spin_time / n_ops;
+    double wait_time = res->wait_time / n_ops;
+
+    // Operation, size, MPI_Test() cost (ns): average, median, 99th percentile, max, completing call; MPI_Test() calls:
+    // average, max; completion time (us): MPI_Test() spin, MPI_Wait(), share of the spin spent in MPI_Test()
+    fprintf(stdout, "%s\t%" PRIu64 "\t%.0f\t%.0f\t%.0f\t%.0f\t%.0f\t%.1f\t%" PRIu64 "\t%.2f\t%.2f\t%.1f\n",
+            polling_op_names[op], n_elts * sizeof(double),
+            res->n_tests > 0 ? res->test_time * 1e9 / res->n_tests : 0.0,
+            polling_percentile(res, 50) * 1e9, polling_percentile(res, 99) * 1e9, res->test_max * 1e9,
+            res->completing_time * 1e9 / n_ops, (double)res->n_tests / n_ops, res->max_tests, spin_time * 1e6,
+            wait_time * 1e6, res->spin_time > 0 ? res->test_time * 100 / res->spin_time : 0.0);
+}
+
+static void polling_write_json(overlap_params_t *params, int op, uint64_t n_elts, int n_iters, polling_result_t *res,
+                               FILE *f)
+{
+    double n_ops = (double)n_iters * params->world_size;
+    int i;
+
+    fprintf(f, "{\"operation\":\"%s\",\"n_elts\":%" PRIu64 ",\"data_size\":%" PRIu64 ",\"n_iters\":%d,", polling_op_names[op],
+            n_elts, n_elts * sizeof(double), n_iters);
+    fprintf(f, "\"test_time\":%.9g,\"test_p50\":%.9g,\"test_p99\":%.9g,\"test_min\":%.9g,\"test_max\":%.9g,"
+               "\"completing_test_time\":%.9g,",
+            res->n_tests > 0 ? res->test_time * 1e3 / res->n_tests : 0.0, polling_percentile(res, 50) * 1e3,
+            polling_percentile(res, 99) * 1e3, res->test_min * 1e3, res->test_max * 1e3,
+            res->completing_time * 1e3 / n_ops);
+    fprintf(f, "\"test_calls\":%.9g,\"max_test_calls\":%" PRIu64 ",\"spin_time\":%.9g,\"wait_time\":%.9g,\"buckets\":[",
+            (double)res->n_tests / n_ops, res->max_tests, res->spin_time * 1e3 / n_ops, res->wait_time * 1e3 / n_ops);
+    for (i = 0; i < POLLING_N_BUCKETS; i++)
+        fprintf(f, "%s%" PRIu64, i > 0 ? "," : "", res->buckets[i]);
+    fprintf(f, "]}");
+}
+
+int main(int argc, char **argv)
+{
+    char *ops_str;
+    int ops[POLLING_N_OPS];
+    int n_ops = POLLING_N_OPS;
+    int n_iters = POLLING_DEFAULT_ITERS;
+    uint64_t sizes[MAX_SWEEP_SIZES];
+    int n_sizes = 0;
+    polling_result_t local, *results = NULL;
+    uint64_t n_elts;
+    int n_results = 0;
+    int i, j;
+
+    INIT_OVERLAP_BENCH;
+
+    if (!calibrate(&params))
+        goto exit_error;
+
+    for (i = 0; i < POLLING_N_OPS; i++)
+        ops[i] = i;
+    ops_str = getenv(OVERLAP_POLLING_OPS_ENVVAR);
+    if (ops_str)
+        n_ops = parse_name_list(&params, ops_str, polling_op_names, POLLING_N_OPS, ops);
+    // The environment of rank 0 prevails
+    MPI_CHECK(MPI_Bcast(&n_ops, 1, MPI_INT, 0, params.comm));
+    MPI_CHECK(MPI_Bcast(ops, POLLING_N_OPS, MPI_INT, 0, params.comm));
+    if (!overlap_getenv_int(&params, OVERLAP_POLLING_ITERS_ENVVAR, 1, &n_iters))
+        goto exit_error;
+
+    if (params.sweep_n_sizes > 0)
+    {
+        for (i = 0; i < params.sweep_n_sizes; i++)
+        {
+            if (params.sweep_sizes[i] <= params.max_elts)
+                sizes[n_sizes++] = params.sweep_sizes[i];
+        }
+    }
+    else
+    {
+        for (n_elts = params.min_elts; n_elts <= params.max_elts && n_sizes < MAX_SWEEP_SIZES; n_elts *= POLLING_SIZE_FACTOR)
+            sizes[n_sizes++] = n_elts;
+    }
+
+    MEMALLOC(s_buf, double, params.world_size * params.max_elts * sizeof(double));
+    MEMALLOC(r_buf, double, params.world_size * params.max_elts * sizeof(double));
+    memset(s_buf, 0, params.world_size * params.max_elts * sizeof(double));
+    MEMALLOC(results, polling_result_t, n_ops * n_sizes * sizeof(polling_result_t));
+
+    if (params.world_rank == 0)
+    {
+        fprintf(stdout, "MPI_Test() and MPI_Wait() cost, %d iterations per operation and size on %d ranks\n", n_iters,
+                params.world_size);
+        fprintf(stdout, "Operation\tSize (bytes)\tTest avg (ns)\tTest p50 (ns)\tTest p99 (ns)\tTest max (ns)\t"
+                        "Completing test (ns)\tTests avg\tTests max\tTest spin (us)\tWait (us)\tPolling (%%)\n");
+    }
+
+    for (i = 0; i < n_ops; i++)
+    {
+        for (j = 0; j < n_sizes; j++)
+        {
+            // The size does not matter for MPI_Ibarrier()
+            n_elts = ops[i] == POLLING_OP_IBARRIER ? 0 : sizes[j];
+            if (ops[i] == POLLING_OP_IBARRIER && j > 0)
+                break;
+
+            if (polling_measure(&params, ops[i], n_elts, n_iters, &local))
+                goto exit_error;
+            if (polling_aggregate(&params, &local, &results[n_results]))
+                goto exit_error;
+            if (params.world_rank == 0)
+                polling_display(&params, ops[i], n_elts, n_iters, &results[n_results]);
+            n_results++;
+        }
+    }
+
+    if (params.world_rank == 0)
+    {
+        overlap_output_record_header(stdout, POLLING_RECORD_FORMAT, POLLING_RECORD_VERSION, "overlap_polling",
+                                     params.world_size);
+        fprintf(stdout, "\"params\":{\"n_iters\":%d},\"results\":[", n_iters);
+        n_results = 0;
+        for (i = 0; i < n_ops; i++)
+        {
+            for (j = 0; j < n_sizes; j++)
+            {
+                if (ops[i] == POLLING_OP_IBARRIER && j > 0)
+                    break;
+                if (n_results > 0)
+                    fprintf(stdout, ",");
+                polling_write_json(&params, ops[i], ops[i] == POLLING_OP_IBARRIER ? 0 : sizes[j], n_iters,
+                                   &results[n_results], stdout);
+                n_results++;
+            }
+        }
+        fprintf(stdout, "]}\n");
+    }
+
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    MEMFREE(results);
+    MPI_Finalize();
+    return EXIT_SUCCESS;
+
+exit_error:
+    MEMFREE(s_buf);
+    MEMFREE(r_buf);
+    MEMFREE(results);
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    return EXIT_FAILURE;
+}
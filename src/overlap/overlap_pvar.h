@@ -0,0 +1,425 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+#ifndef OVERLAP_PVAR_H_
+#define OVERLAP_PVAR_H_
+
+// Sampling of the MPI_T performance variables (pvars) of the MPI implementation. The same overlap can be the result of
+// very different behaviors, e.g., an operation offloaded to the network card or a software fallback progressed by the
+// calls to MPI; the pvars exposed by the implementation, e.g., the length of the unexpected message queue, the number
+// of calls to the progress engine or the number of bytes sent, help telling them apart. When requested, the selected
+// pvars are read around every batch of iterations of the search of the overlap (time driven model only) and reported
+// with the overlap. Pvars bound to a communicator are bound to the communicator of the first operation in flight.
+
+#define OVERLAP_PVARS_ENVVAR "OPENHPCA_OVERLAP_PVARS"
+
+#define MAX_PVARS (64)
+#define MAX_PVAR_NAME_LEN (128)
+
+typedef struct overlap_pvar
+{
+    char name[MAX_PVAR_NAME_LEN];
+    int var_class;         // MPI_T_PVAR_CLASS_*
+    MPI_Datatype datatype; // Datatype of the value, converted to a double
+    bool valid;            // false if the pvar is not available on this rank
+    int index;
+    int bind;              // MPI_T_BIND_NO_OBJECT or MPI_T_BIND_MPI_COMM
+    bool continuous;
+    int count;             // Number of values, e.g., one per peer, which are summed
+    void *buf;             // Buffer of count values of datatype
+    MPI_Comm comm;         // Communicator the handle is bound to, MPI_COMM_NULL if no handle is allocated
+    MPI_T_pvar_handle handle;
+    double start; // Value at the beginning of the current batch
+    double value; // Accumulated difference, or extreme value, since the last reset
+} overlap_pvar_t;
+
+typedef struct overlap_pvars
+{
+    bool enabled;
+    MPI_T_pvar_session session;
+    int n_pvars;
+    overlap_pvar_t pvars[MAX_PVARS];
+    int64_t n_iters; // Number of iterations sampled since the last reset
+} overlap_pvars_t;
+
+// Only one benchmark per binary, the pvars are therefore global
+static overlap_pvars_t overlap_pvars;
+
+static inline const char *overlap_pvar_class_name(int var_class)
+{
+    switch (var_class)
+    {
+    case MPI_T_PVAR_CLASS_COUNTER:
+        return "counter";
+    case MPI_T_PVAR_CLASS_TIMER:
+        return "timer";
+    case MPI_T_PVAR_CLASS_AGGREGATE:
+        return "aggregate";
+    case MPI_T_PVAR_CLASS_LEVEL:
+        return "level";
+    case MPI_T_PVAR_CLASS_SIZE:
+        return "size";
+    case MPI_T_PVAR_CLASS_HIGHWATERMARK:
+        return "highwatermark";
+    case MPI_T_PVAR_CLASS_LOWWATERMARK:
+        return "lowwatermark";
+    default:
+        return "unknown";
+    }
+}
+
+// Counters, timers and aggregates are reported as the difference between the end and the beginning of the batches.
+// For the other classes, e.g., the length of a queue, the difference between two reads is meaningless and the extreme
+// value read at the end of the batches is reported instead.
+#define PVAR_REPORT_DELTA (0)
+#define PVAR_REPORT_MAX (1)
+#define PVAR_REPORT_MIN (2)
+
+static const char *pvar_report_names[] = {"", " (maximum)", " (minimum)"};
+
+static inline int overlap_pvar_report(int var_class)
+{
+    switch (var_class)
+    {
+    case MPI_T_PVAR_CLASS_COUNTER:
+    case MPI_T_PVAR_CLASS_TIMER:
+    case MPI_T_PVAR_CLASS_AGGREGATE:
+        return PVAR_REPORT_DELTA;
+    case MPI_T_PVAR_CLASS_LOWWATERMARK:
+        return PVAR_REPORT_MIN;
+    default:
+        return PVAR_REPORT_MAX;
+    }
+}
+
+static inline bool overlap_pvar_supported(int var_class, MPI_Datatype datatype, int bind)
+{
+    if (bind != MPI_T_BIND_NO_OBJECT && bind != MPI_T_BIND_MPI_COMM)
+        return false;
+    if (var_class == MPI_T_PVAR_CLASS_STATE || var_class == MPI_T_PVAR_CLASS_PERCENTAGE || var_class == MPI_T_PVAR_CLASS_GENERIC)
+        return false;
+    return datatype == MPI_UNSIGNED || datatype == MPI_UNSIGNED_LONG || datatype == MPI_UNSIGNED_LONG_LONG ||
+           datatype == MPI_COUNT || datatype == MPI_INT || datatype == MPI_DOUBLE;
+}
+
+// overlap_pvar_selected returns true if the name of a pvar matches the selection of OPENHPCA_OVERLAP_PVARS, i.e.,
+// "all" or a comma-separated list of substrings of the names
+static inline bool overlap_pvar_selected(const char *selection, const char *name)
+{
+    char token[MAX_PVAR_NAME_LEN];
+    const char *s = selection;
+    size_t len;
+
+    if (strcmp(selection, "all") == 0)
+        return true;
+    while (*s != '\0')
+    {
+        len = strcspn(s, ",");
+        if (len > 0 && len < MAX_PVAR_NAME_LEN)
+        {
+            memcpy(token, s, len);
+            token[len] = '\0';
+            if (strstr(name, token) != NULL)
+                return true;
+        }
+        s += len;
+        if (*s == ',')
+            s++;
+    }
+    return false;
+}
+
+static inline int overlap_pvar_read(overlap_pvar_t *pvar, double *value)
+{
+    int i, rc = MPI_T_pvar_read(overlap_pvars.session, pvar->handle, pvar->buf);
+    if (rc != MPI_SUCCESS)
+        return rc;
+
+    *value = 0.0;
+    for (i = 0; i < pvar->count; i++)
+    {
+        if (pvar->datatype == MPI_UNSIGNED)
+            *value += ((unsigned *)pvar->buf)[i];
+        else if (pvar->datatype == MPI_UNSIGNED_LONG)
+            *value += ((unsigned long *)pvar->buf)[i];
+        else if (pvar->datatype == MPI_UNSIGNED_LONG_LONG)
+            *value += ((unsigned long long *)pvar->buf)[i];
+        else if (pvar->datatype == MPI_COUNT)
+            *value += ((MPI_Count *)pvar->buf)[i];
+        else if (pvar->datatype == MPI_INT)
+            *value += ((int *)pvar->buf)[i];
+        else
+            *value += ((double *)pvar->buf)[i];
+    }
+    return MPI_SUCCESS;
+}
+
+// overlap_pvar_unbind_one frees the handle of a pvar, if any
+static inline void overlap_pvar_unbind_one(overlap_pvar_t *pvar)
+{
+    if (pvar->comm == MPI_COMM_NULL)
+        return;
+    MPI_T_pvar_handle_free(overlap_pvars.session, &pvar->handle);
+    free(pvar->buf);
+    pvar->buf = NULL;
+    pvar->comm = MPI_COMM_NULL;
+}
+
+// overlap_pvar_bind allocates and starts the handle of a pvar, bound to a communicator if required. The pvar is marked
+// as invalid if the handle cannot be allocated.
+static inline void overlap_pvar_bind(overlap_pvar_t *pvar, MPI_Comm comm)
+{
+    int size, rc;
+
+    overlap_pvar_unbind_one(pvar);
+    pvar->valid = false;
+    if (MPI_T_pvar_handle_alloc(overlap_pvars.session, pvar->index, pvar->bind == MPI_T_BIND_MPI_COMM ? &comm : NULL,
+                                &pvar->handle, &pvar->count) != MPI_SUCCESS)
+        return;
+    MPI_Type_size(pvar->datatype, &size);
+    pvar->buf = malloc((pvar->count > 0 ? pvar->count : 1) * size);
+    if (pvar->buf == NULL)
+    {
+        MPI_T_pvar_handle_free(overlap_pvars.session, &pvar->handle);
+        return;
+    }
+    if (!pvar->continuous)
+    {
+        rc = MPI_T_pvar_start(overlap_pvars.session, pvar->handle);
+        if (rc != MPI_SUCCESS && rc != MPI_T_ERR_PVAR_NO_STARTSTOP)
+        {
+            MPI_T_pvar_handle_free(overlap_pvars.session, &pvar->handle);
+            free(pvar->buf);
+            pvar->buf = NULL;
+            return;
+        }
+    }
+    pvar->comm = comm;
+    pvar->valid = true;
+}
+
+// overlap_pvar_lookup finds the pvar of a given name, which is marked as invalid if it does not exist on this rank or
+// cannot be read. Pvars that are not bound to an object get their handle immediately.
+static inline void overlap_pvar_lookup(overlap_pvar_t *pvar, int num_pvars)
+{
+    char name[MAX_PVAR_NAME_LEN], desc[1];
+    int i, name_len, desc_len, verbosity, var_class, bind, readonly, continuous, atomic;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+
+    pvar->valid = false;
+    pvar->comm = MPI_COMM_NULL;
+    pvar->buf = NULL;
+    for (i = 0; i < num_pvars; i++)
+    {
+        name_len = MAX_PVAR_NAME_LEN;
+        desc_len = 0;
+        if (MPI_T_pvar_get_info(i, name, &name_len, &verbosity, &var_class, &datatype, &enumtype, desc, &desc_len,
+                                &bind, &readonly, &continuous, &atomic) != MPI_SUCCESS ||
+            strcmp(name, pvar->name) != 0)
+            continue;
+        if (!overlap_pvar_supported(var_class, datatype, bind))
+            return;
+        pvar->index = i;
+        pvar->var_class = var_class;
+        pvar->datatype = datatype;
+        pvar->bind = bind;
+        pvar->continuous = continuous;
+        pvar->valid = true;
+        if (bind == MPI_T_BIND_NO_OBJECT)
+            overlap_pvar_bind(pvar, MPI_COMM_WORLD);
+        return;
+    }
+}
+
+// overlap_pvar_init selects the pvars matching OPENHPCA_OVERLAP_PVARS. The selection is performed by rank 0 and the
+// names are broadcast to the other ranks so that all the ranks report the same pvars in the same order. It must be
+// called by all the ranks of MPI_COMM_WORLD.
+static inline int overlap_pvar_init(overlap_params_t *params)
+{
+    char *selection = getenv(OVERLAP_PVARS_ENVVAR);
+    char name[MAX_PVAR_NAME_LEN], desc[1];
+    int i, name_len, desc_len, verbosity, var_class, bind, readonly, continuous, atomic, provided;
+    int num_pvars = 0, n_selected = 0, enabled;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+
+    // The selection of rank 0 is used by all the ranks
+    overlap_pvars.enabled = false;
+    overlap_pvars.n_pvars = 0;
+    enabled = selection != NULL && *selection != '\0';
+    MPI_CHECK(MPI_Bcast(&enabled, 1, MPI_INT, 0, MPI_COMM_WORLD));
+    if (!enabled)
+        return 0;
+
+    MPI_CHECK(MPI_T_init_thread(MPI_THREAD_SINGLE, &provided));
+    MPI_CHECK(MPI_T_pvar_get_num(&num_pvars));
+
+    if (params->world_rank == 0)
+    {
+        for (i = 0; i < num_pvars; i++)
+        {
+            name_len = MAX_PVAR_NAME_LEN;
+            desc_len = 0;
+            if (MPI_T_pvar_get_info(i, name, &name_len, &verbosity, &var_class, &datatype, &enumtype, desc, &desc_len,
+                                    &bind, &readonly, &continuous, &atomic) != MPI_SUCCESS)
+                continue;
+            if (!overlap_pvar_supported(var_class, datatype, bind) || !overlap_pvar_selected(selection, name))
+                continue;
+            if (n_selected == MAX_PVARS)
+            {
+                fprintf(stderr, "Too many performance variables, only the first %d are sampled\n", MAX_PVARS);
+                break;
+            }
+            strcpy(overlap_pvars.pvars[n_selected].name, name);
+            n_selected++;
+        }
+    }
+    MPI_CHECK(MPI_Bcast(&n_selected, 1, MPI_INT, 0, MPI_COMM_WORLD));
+    for (i = 0; i < n_selected; i++)
+        MPI_CHECK(MPI_Bcast(overlap_pvars.pvars[i].name, MAX_PVAR_NAME_LEN, MPI_CHAR, 0, MPI_COMM_WORLD));
+
+    MPI_CHECK(MPI_T_pvar_session_create(&overlap_pvars.session));
+    for (i = 0; i < n_selected; i++)
+        overlap_pvar_lookup(&overlap_pvars.pvars[i], num_pvars);
+    overlap_pvars.n_pvars = n_selected;
+    overlap_pvars.enabled = true;
+
+    if (params->world_rank == 0)
+    {
+        fprintf(stdout, "Sampled performance variables: %d\n", n_selected);
+        for (i = 0; i < n_selected; i++)
+            fprintf(stdout, "  %s (%s)\n", overlap_pvars.pvars[i].name,
+                    overlap_pvars.pvars[i].valid ? overlap_pvar_class_name(overlap_pvars.pvars[i].var_class) : "unavailable");
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+static inline void overlap_pvar_fini()
+{
+    int i;
+    if (!overlap_pvars.enabled)
+        return;
+    for (i = 0; i < overlap_pvars.n_pvars; i++)
+        overlap_pvar_unbind_one(&overlap_pvars.pvars[i]);
+    MPI_T_pvar_session_free(&overlap_pvars.session);
+    MPI_T_finalize();
+    overlap_pvars.enabled = false;
+}
+
+// overlap_pvar_unbind frees the handles bound to a communicator, it must be called before freeing the communicators
+static inline void overlap_pvar_unbind()
+{
+    int i;
+    for (i = 0; i < overlap_pvars.n_pvars; i++)
+    {
+        if (overlap_pvars.pvars[i].bind == MPI_T_BIND_MPI_COMM)
+            overlap_pvar_unbind_one(&overlap_pvars.pvars[i]);
+    }
+}
+
+// overlap_pvar_reset starts a new accumulation, e.g., for a new result, and binds the pvars bound to a communicator
+// to the communicator of the first operation in flight
+static inline void overlap_pvar_reset(overlap_params_t *params)
+{
+    MPI_Comm comm = params->concurrency > 1 ? params->comm_dups[0] : params->comm;
+    overlap_pvar_t *pvar;
+    int i;
+    for (i = 0; i < overlap_pvars.n_pvars; i++)
+    {
+        pvar = &overlap_pvars.pvars[i];
+        pvar->value = 0.0;
+        if (pvar->bind == MPI_T_BIND_MPI_COMM && pvar->valid && pvar->comm != comm)
+            overlap_pvar_bind(pvar, comm);
+    }
+    overlap_pvars.n_iters = 0;
+}
+
+// overlap_pvar_begin reads the pvars at the beginning of a batch of iterations
+static inline void overlap_pvar_begin()
+{
+    int i;
+    if (!overlap_pvars.enabled)
+        return;
+    for (i = 0; i < overlap_pvars.n_pvars; i++)
+    {
+        if (overlap_pvars.pvars[i].comm != MPI_COMM_NULL)
+            overlap_pvar_read(&overlap_pvars.pvars[i], &overlap_pvars.pvars[i].start);
+    }
+}
+
+// overlap_pvar_end reads the pvars at the end of a batch of n_iters iterations and accumulates the differences
+static inline void overlap_pvar_end(int n_iters)
+{
+    overlap_pvar_t *pvar;
+    double value;
+    int i;
+    if (!overlap_pvars.enabled)
+        return;
+    for (i = 0; i < overlap_pvars.n_pvars; i++)
+    {
+        pvar = &overlap_pvars.pvars[i];
+        if (pvar->comm == MPI_COMM_NULL || overlap_pvar_read(pvar, &value) != MPI_SUCCESS)
+            continue;
+        if (overlap_pvar_report(pvar->var_class) == PVAR_REPORT_MAX)
+            pvar->value = value > pvar->value ? value : pvar->value;
+        else if (overlap_pvar_report(pvar->var_class) == PVAR_REPORT_MIN)
+            pvar->value = overlap_pvars.n_iters == 0 || value < pvar->value ? value : pvar->value;
+        else
+            pvar->value += value - pvar->start;
+    }
+    overlap_pvars.n_iters += n_iters;
+}
+
+// overlap_pvar_collect gathers on rank 0 the values accumulated since the last reset: the differences are summed
+// across the ranks and divided by the number of iterations, the other values are the extreme values across the ranks.
+// It must be called by all the ranks of params->comm.
+static inline int overlap_pvar_collect(overlap_params_t *params, double *values)
+{
+    double local[MAX_PVARS], sums[MAX_PVARS], maxs[MAX_PVARS], mins[MAX_PVARS];
+    int i, n = overlap_pvars.n_pvars;
+
+    if (!overlap_pvars.enabled || n == 0)
+        return 0;
+    for (i = 0; i < n; i++)
+        local[i] = overlap_pvars.pvars[i].value;
+    MPI_CHECK(MPI_Reduce(local, sums, n, MPI_DOUBLE, MPI_SUM, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(local, maxs, n, MPI_DOUBLE, MPI_MAX, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(local, mins, n, MPI_DOUBLE, MPI_MIN, 0, params->comm));
+    for (i = 0; i < n; i++)
+    {
+        if (overlap_pvar_report(overlap_pvars.pvars[i].var_class) == PVAR_REPORT_MAX)
+            values[i] = maxs[i];
+        else if (overlap_pvar_report(overlap_pvars.pvars[i].var_class) == PVAR_REPORT_MIN)
+            values[i] = mins[i];
+        else
+            values[i] = overlap_pvars.n_iters > 0 ? sums[i] / overlap_pvars.n_iters : 0.0;
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// overlap_pvar_display displays the values gathered by overlap_pvar_collect()
+static inline void overlap_pvar_display(double *values)
+{
+    int i;
+    if (!overlap_pvars.enabled || overlap_pvars.n_pvars == 0)
+        return;
+    fprintf(stdout, "Performance variables (differences per iteration summed across ranks, or extreme values):\n");
+    for (i = 0; i < overlap_pvars.n_pvars; i++)
+    {
+        if (overlap_pvars.pvars[i].valid)
+            fprintf(stdout, "  %s: %g%s\n", overlap_pvars.pvars[i].name, values[i],
+                    pvar_report_names[overlap_pvar_report(overlap_pvars.pvars[i].var_class)]);
+    }
+}
+
+#endif // OVERLAP_PVAR_H_
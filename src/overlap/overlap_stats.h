@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+// Statistics shared by the benchmarks and libopenhpca_pmpi.so, which cannot include overlap.h. Times are measured with
+// MPI_Wtime() (PMPI_Wtime() in libopenhpca_pmpi.so, which must not go through the interposed symbols of another tool)
+// in seconds and converted to milli-seconds.
+
+#ifndef OVERLAP_STATS_H
+#define OVERLAP_STATS_H
+
+#include <math.h>
+#include <stdint.h>
+
+#define STDEV_UINT64(array, size, stdev)        \
+    do                                          \
+    {                                           \
+        uint64_t _sum = 0;                      \
+        double _mean;                           \
+        stdev = 0.0;                            \
+        int _i;                                 \
+        for (_i = 1; _i < size; _i++)           \
+            _sum += array[_i];                  \
+        _mean = (double)_sum / size;            \
+        for (_i = 0; _i < size; _i++)           \
+        {                                       \
+            stdev += pow(array[_i] - _mean, 2); \
+        }                                       \
+        stdev = sqrt(stdev / size);             \
+    } while (0)
+
+#define STDEV(array, size, stdev)               \
+    do                                          \
+    {                                           \
+        double _sum = 0.0;                      \
+        double _mean;                           \
+        stdev = 0.0;                            \
+        int _i;                                 \
+        for (_i = 1; _i < size; _i++)           \
+            _sum += array[_i];                  \
+        _mean = _sum / size;                    \
+        for (_i = 0; _i < size; _i++)           \
+            stdev += pow(array[_i] - _mean, 2); \
+        stdev = sqrt(stdev / size);             \
+    } while (0)
+
+// Overlap is defined as the ratio between the time spent
+// to the work over the time spent to do the work in addition
+// of the time for communication
+#define GET_OVERLAP(_overlap, _total_time, _work_time) \
+    do                                                 \
+    {                                                  \
+        _overlap = _work_time / _total_time;           \
+    } while (0)
+
+#endif // OVERLAP_STATS_H
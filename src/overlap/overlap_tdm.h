@@ -7,8 +7,162 @@
 #ifndef OVERLAP_TDM_H_
 #define OVERLAP_TDM_H_
 
-#define TDM_VARIABLES \
-    int done = 0;
+#define TDM_SWEEP_PILOT_ITERS (10)
+#define TDM_SWEEP_MIN_ITERS (5)
+// Estimate of how many times the configuration of a given size is executed during a search (reference time,
+// probes and validation steps); used to predict how long a search takes
+#define TDM_SWEEP_PROBE_FACTOR (20)
+// Parameters of the search of the size matching the cutoff time
+#define TDM_SIZE_SEARCH_TARGET_MARGIN (1.2)   // The search aims 20% above the cutoff time so a noisy prediction still lands above it
+#define TDM_SIZE_SEARCH_MAX_OVERSHOOT (2.0)   // Sizes giving more than twice the cutoff time are refined
+#define TDM_SIZE_SEARCH_MAX_GROWTH (64)       // Maximum factor applied to the size between two steps
+#define TDM_SIZE_SEARCH_MIN_SLOPE (0.05)      // Flat (latency bound) regions are extrapolated with this log-log slope
+#define TDM_SIZE_SEARCH_MAX_REFINEMENTS (4)
+#define TDM_WORK_CALIBRATION_RUNS (3) // The rate of a rank is the best of these runs of the calibrated amount of work
+
+// Function posting the non-blocking collective operation being evaluated for a given number of elements
+typedef int (*tdm_post_fn_t)(overlap_params_t *params, uint64_t n_elts, MPI_Request *req);
+
+// tdm_post posts the params->concurrency operations of an iteration, each one on its own duplicate of the communicator
+// and with its own slot of buffers, or the communication of the application when the search is driven through
+// libopenhpca_overlap
+static int
+tdm_post(overlap_params_t *params, tdm_post_fn_t post, uint64_t n_elts, MPI_Request *reqs)
+{
+    MPI_Comm comm = params->comm;
+    int rc = MPI_SUCCESS;
+
+    if (params->callbacks != NULL)
+        return params->callbacks->post(params->callbacks->arg);
+
+    if (params->concurrency == 1)
+        return post(params, n_elts, reqs);
+
+    for (params->slot = 0; params->slot < params->concurrency && rc == MPI_SUCCESS; params->slot++)
+    {
+        params->comm = params->comm_dups[params->slot];
+        rc = post(params, n_elts, &reqs[params->slot]);
+    }
+    params->comm = comm;
+    params->slot = 0;
+    return rc;
+}
+
+// tdm_wait completes the operations posted by tdm_post()
+static inline int
+tdm_wait(overlap_params_t *params, MPI_Request *reqs)
+{
+    if (params->callbacks != NULL)
+        return params->callbacks->wait(params->callbacks->arg);
+    return MPI_Waitall(params->concurrency, reqs, MPI_STATUSES_IGNORE);
+}
+
+// tdm_dup_comms duplicates the communicator for every concurrent operation, so that operations in flight at the same
+// time are independent from each other
+static int
+tdm_dup_comms(overlap_params_t *params)
+{
+    int i;
+
+    if (params->concurrency == 1)
+        return 0;
+
+    for (i = 0; i < params->concurrency; i++)
+        MPI_CHECK(MPI_Comm_dup(params->comm, &params->comm_dups[i]));
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+static void
+tdm_free_comms(overlap_params_t *params)
+{
+    int i;
+
+    overlap_pvar_unbind();
+    if (params->concurrency == 1)
+        return;
+
+    for (i = 0; i < params->concurrency; i++)
+        MPI_Comm_free(&params->comm_dups[i]);
+}
+
+// Final numbers of a time driven overlap search, only meaningful on rank 0
+typedef struct tdm_result
+{
+    uint64_t n_elts;
+    int n_iters;
+    double ref_time;  // in milli-seconds
+    double stdev;     // in milli-seconds
+    double work_time; // in milli-seconds
+    double wait_time; // in milli-seconds, time spent in MPI_Wait() with the injected work
+    double overlap;   // in percent
+    double completion_time;  // in milli-seconds, across the ranks with window-based synchronization, negative otherwise
+    bool completed;   // false if the search was interrupted because the time budget was exhausted
+    double pvars[MAX_PVARS]; // Performance variables sampled during the search, see overlap_pvar_collect()
+    bool has_inflation;      // false if the compute inflation was not measured
+    double inflation;        // in percent, average over the ranks, see tdm_compute_inflation()
+    double max_inflation;    // in percent
+    int max_inflation_rank;
+    double work_rate_min; // Work units per milli-second of the slowest rank, see tdm_calibrate_work()
+    double work_rate_max; // Work units per milli-second of the fastest rank
+    int slowest_rank;
+} tdm_result_t;
+
+// tdm_work_units converts an amount of work expressed in nano-seconds into the work units of the calling rank
+static inline int64_t tdm_work_units(overlap_params_t *params, int64_t work)
+{
+    return (int64_t)(work * params->work_rate + 0.5);
+}
+
+// tdm_calibrate_work calibrates the work units of the calling rank against the reference time. The search of the time
+// driven model runs in nano-seconds of work and every rank converts them into its own units, so that the ranks of
+// heterogeneous nodes (e.g., mixed generations of processors or cores of different types) all compute for the same
+// time. The slowest and fastest rates (in work units per milli-second) are reported on rank 0.
+static int
+tdm_calibrate_work(overlap_params_t *params, double ref_time, tdm_result_t *res)
+{
+    struct
+    {
+        double value;
+        int rank;
+    } rate, min_rate, max_rate;
+    double best = 0.0, t, start;
+    int64_t work;
+    int i;
+
+    GET_WORK_EQUIVALENCE(params, ref_time, work);
+    // The equivalence may exceed the reference time by up to 50%, the rate is measured on the amount of work it found
+    for (i = 0; i < TDM_WORK_CALIBRATION_RUNS; i++)
+    {
+        start = MPI_Wtime();
+        overlap_work(params, work);
+        t = (MPI_Wtime() - start) * 1000;
+        if (i == 0 || t < best)
+            best = t;
+    }
+    if (best <= 0)
+        best = ref_time;
+    params->work_rate = best > 0 ? work / (best * 1e6) : 1.0;
+
+    rate.value = params->work_rate * 1e6;
+    rate.rank = params->world_rank;
+    MPI_CHECK(MPI_Reduce(&rate, &min_rate, 1, MPI_DOUBLE_INT, MPI_MINLOC, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(&rate, &max_rate, 1, MPI_DOUBLE_INT, MPI_MAXLOC, 0, params->comm));
+    if (params->world_rank == 0)
+    {
+        res->work_rate_min = min_rate.value;
+        res->work_rate_max = max_rate.value;
+        res->slowest_rank = min_rate.rank;
+        OVERLAP_DEBUG(params, "Work calibration: %f to %f units per milli-second (slowest rank: %d)\n", min_rate.value,
+                      max_rate.value, min_rate.rank);
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
 
 #define TDM_SET_ITERS_AND_ELTS                                                                                                                     \
     if (params->world_rank == 0)                                                                                                                   \
@@ -20,20 +174,24 @@
         goto exit_error;                                                                                                                           \
     }                                                                                                                                              \
                                                                                                                                                    \
+    /* Every rank calibrates its own work units against the reference time of rank 0 */                                                          \
+    MPI_CHECK(MPI_Bcast(&ref_time, 1, MPI_DOUBLE, 0, params->comm));                                                                               \
     if (params->world_rank == 0)                                                                                                                   \
-    {                                                                                                                                              \
         OVERLAP_DEBUG(params, "Getting work equivalence for time of %f\n", ref_time);                                                              \
-        GET_WORK_EQUIVALENCE(x, y, a, b, ref_time, work);                                                                                          \
-        OVERLAP_DEBUG(params, "Work equivalent is %" PRId64 " units of work (time = %f)\n", work, ref_time);                                       \
-    }                                                                                                                                              \
-    MPI_CHECK(MPI_Bcast(&work, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD));                                                                                 \
-    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));                                                                                                        \
+    if (tdm_calibrate_work(params, ref_time, res))                                                                                                 \
+        goto exit_error;                                                                                                                           \
+    work = (int64_t)(ref_time * 1e6); /* The search runs in nano-seconds of work */                                                                \
+    if (params->world_rank == 0)                                                                                                                   \
+        OVERLAP_DEBUG(params, "Work equivalent is %" PRId64 " nano-seconds of work (time = %f)\n", work, ref_time);                                \
+    MPI_CHECK(MPI_Barrier(params->comm));                                                                                                          \
     ref_work = work;
 
 #define TDM_PROCESS_DATA                                                                                                                              \
     if (params->world_rank == 0)                                                                                                                      \
     {                                                                                                                                                 \
         total_time /= n_iters;                                                                                                                        \
+        int64_t _probe_work = work;                                                                                                                   \
+        int _probe_validations = overlap_status.validation_count;                                                                                     \
         OVERLAP_DEBUG(params, "Processing data: ref_time = %f; current time = %f, stdev = %f\n", ref_time, total_time, stdev);                        \
         PROCESS_DATA;                                                                                                                                 \
                                                                                                                                                       \
@@ -45,12 +203,14 @@
                 OVERLAP_DEBUG(params, "Overlap okay with work = %" PRId64 " and ref work = %" PRId64 "\n", work, ref_work);                           \
                 overlap = 100;                                                                                                                        \
                 final_work_time = work_time;                                                                                                          \
+                final_wait_time = wait_time;                                                                                                          \
                 work = -1; /* This means we are done and will stop all the ranks */                                                                   \
             }                                                                                                                                         \
             else                                                                                                                                      \
             {                                                                                                                                         \
                 /* Overlap okay, refining results */                                                                                                  \
                 final_work_time = work_time;                                                                                                          \
+                final_wait_time = wait_time;                                                                                                          \
                 work = updated_overlap_status(params, &overlap_status, total_time, ref_time + stdev, true, work);                                     \
                 OVERLAP_DEBUG(params, "Overlap okay, refining results with %" PRId64 " units\n", work);                                               \
             }                                                                                                                                         \
@@ -68,12 +228,17 @@
                 work = -1;                                                                                                                            \
             }                                                                                                                                         \
         }                                                                                                                                             \
+        overlap_output_add_probe(params, n_elts, _probe_work, total_time, ref_time + stdev, total_time <= ref_time + stdev,                           \
+                                 _probe_validations + 1);                                                                                             \
     }
 
 #define TDM_COMPUTE_OVERLAP                                                                                                             \
     if (params->world_rank == 0)                                                                                                        \
     {                                                                                                                                   \
         final_work_time /= n_iters;                                                                                                     \
+        if (final_wait_time < 0)                                                                                                        \
+            final_wait_time = wait_time; /* No amount of work was overlapped, we report the last run */                                 \
+        final_wait_time /= n_iters;                                                                                                     \
         if (overlap != 100)                                                                                                             \
         {                                                                                                                               \
             GET_OVERLAP(overlap, ref_time, final_work_time);                                                                            \
@@ -81,10 +246,1051 @@
             if (overlap > 100)                                                                                                          \
                 overlap = 100; /* This is possible when more work than the initial estimated time is injected because of variability */ \
         }                                                                                                                               \
-        fprintf(stdout, "Data size exchanged per rank: %" PRIu64 " bytes\n", n_elts * 8);                                               \
-        fprintf(stdout, "Injected work time: %f milli-seconds\n", final_work_time);                                                     \
-        fprintf(stdout, "Reference time: %f milli-seconds (stdev: %f)\n", ref_time, stdev);                                             \
-        fprintf(stdout, "Overlap: %.0f %%\n", overlap);                                                                                 \
+        res->n_elts = n_elts;                                                                                                           \
+        res->n_iters = n_iters;                                                                                                         \
+        res->ref_time = ref_time;                                                                                                       \
+        res->stdev = stdev;                                                                                                             \
+        res->work_time = final_work_time;                                                                                               \
+        res->wait_time = final_wait_time;                                                                                               \
+        res->overlap = overlap;                                                                                                         \
+    }
+
+// tdm_get_coll_config_info measures the average execution time of an operation and its standard deviation (in
+// milli-seconds) on the calling rank. With window-based synchronization and completion_time not NULL, the average
+// completion time of the operation across the ranks, i.e., from the beginning of the window to the completion on the
+// last rank, is also returned on rank 0; it is negative otherwise.
+static int
+tdm_get_coll_config_info(overlap_params_t *params, tdm_post_fn_t post, double *data, uint64_t n_elts, int num_iters, int64_t work, double *op_stdev, double *avg_time, double *completion_time)
+{
+    double stdev, time_sum = 0;
+    double work_start_time, end_time;
+    double *completion_times = NULL;
+    int i;
+    MPI_Request reqs[MAX_CONCURRENCY];
+    double expected_time = 0.0;
+
+    if (completion_time != NULL)
+        *completion_time = -1.0;
+    if (params->sync_mode == SYNC_MODE_WINDOW)
+    {
+        MEMALLOC(completion_times, double, 2 * num_iters * sizeof(double));
+        if (params->prev_n_elts > 0)
+            expected_time = params->prev_time * (n_elts > params->prev_n_elts ? (double)n_elts / params->prev_n_elts : 1.0);
+    }
+
+    MPI_CHECK(overlap_sync_start(params, expected_time));
+    for (i = 0; i < num_iters; i++)
+    {
+        if (i > 0)
+            MPI_CHECK(overlap_sync_next(params));
+        inject_skew(params);
+        MPI_CHECK(tdm_post(params, post, n_elts, reqs));
+        work_start_time = MPI_Wtime();
+        overlap_work(params, work);
+        MPI_CHECK(tdm_wait(params, reqs));
+        end_time = MPI_Wtime();
+        data[i] = (end_time - work_start_time) * 1000; // In milli-seconds
+        time_sum += end_time - work_start_time;
+        if (completion_times != NULL)
+            completion_times[i] = global_time(params) - (params->window_start + params->window_idx * params->window_len);
+    }
+    time_sum *= 1000; // To milliseconds
+
+    STDEV(data, num_iters, stdev);
+    *op_stdev = stdev;
+    *avg_time = time_sum / num_iters;
+    params->prev_time = *avg_time;
+    params->prev_n_elts = n_elts;
+
+    if (completion_times != NULL)
+    {
+        // With synchronized clocks, the completion time of the operation is the time between the start of the
+        // window and the completion on the last rank
+        double total_completion_time = 0.0;
+        MPI_CHECK(MPI_Reduce(completion_times, &completion_times[num_iters], num_iters, MPI_DOUBLE, MPI_MAX, 0, params->comm));
+        if (params->world_rank == 0)
+        {
+            for (i = 0; i < num_iters; i++)
+                total_completion_time += completion_times[num_iters + i];
+            total_completion_time = total_completion_time * 1000 / num_iters; // Average in milli-seconds
+            OVERLAP_DEBUG(params, "Completion time across ranks: %f ms (local time: %f ms, %d late arrivals)\n",
+                          total_completion_time, *avg_time, params->window_late);
+            if (completion_time != NULL)
+                *completion_time = total_completion_time;
+        }
+        MEMFREE(completion_times);
+    }
+    return 0;
+exit_error:
+    MEMFREE(completion_times);
+    return 1;
+}
+
+// tdm_next_search_size predicts, from the measured points, the number of elements giving an execution time slightly
+// above the cutoff time. Points are fitted on a log-log scale (t = c * n^slope); while no point above the cutoff
+// is known, the execution time is assumed to be at most linear with the size (slope = 1 when only one point is
+// available), which means the prediction cannot undershoot, and the jump is bounded by TDM_SIZE_SEARCH_MAX_GROWTH.
+static uint64_t
+tdm_next_search_size(overlap_params_t *params, uint64_t lo_n, double lo_t, uint64_t prev_n, double prev_t, uint64_t hi_n, double hi_t)
+{
+    double target = params->cutoff_time * TDM_SIZE_SEARCH_TARGET_MARGIN;
+    double slope = 1.0, next;
+
+    if (hi_n == 0)
+    {
+        // Growing: extrapolate from the last two points below the cutoff
+        if (prev_n != 0 && prev_n < lo_n && prev_t > 0 && lo_t > 0)
+            slope = log(lo_t / prev_t) / log((double)lo_n / (double)prev_n);
+        if (slope < TDM_SIZE_SEARCH_MIN_SLOPE)
+            slope = TDM_SIZE_SEARCH_MIN_SLOPE;
+        if (slope > 1.0)
+            slope = 1.0;
+        if (lo_t > 0)
+            next = lo_n * pow(target / lo_t, 1.0 / slope);
+        else
+            next = (double)lo_n * TDM_SIZE_SEARCH_MAX_GROWTH;
+        if (next < lo_n * 2.0)
+            next = lo_n * 2.0;
+        if (next > (double)lo_n * TDM_SIZE_SEARCH_MAX_GROWTH)
+            next = (double)lo_n * TDM_SIZE_SEARCH_MAX_GROWTH;
+        return (uint64_t)next;
+    }
+
+    if (lo_n == 0)
+    {
+        // Shrinking without a point below the cutoff, assuming a linear behavior cannot go below the cutoff
+        next = hi_n * (target / hi_t);
+        if (next < 1)
+            next = 1;
+        return (uint64_t)next;
+    }
+
+    // Refining: interpolate between the two points surrounding the cutoff
+    if (lo_t > 0 && hi_t > lo_t)
+    {
+        slope = log(hi_t / lo_t) / log((double)hi_n / (double)lo_n);
+        next = lo_n * pow(target / lo_t, 1.0 / slope);
+    }
+    else
+    {
+        next = sqrt((double)lo_n * (double)hi_n);
+    }
+    if (next <= lo_n)
+        next = lo_n + 1;
+    if (next >= hi_n)
+        next = hi_n - 1;
+    return (uint64_t)next;
+}
+
+// tdm_required_iters returns the number of iterations giving statistically relevant results for an execution time
+// and a standard deviation, i.e., an error below 10% of the execution time with a 90% confidence
+static inline double
+tdm_required_iters(double stdev, double avg_time)
+{
+    // 1.645 is the critical value for a 90% confidence
+    return pow((1.645 * stdev) / (avg_time / 10), 2);
+}
+
+// tdm_find_size finds the number of elements and iterations that give an execution time close to the cutoff time
+// and statistically relevant results. The search starts from the size specified by the user (e.g., the one picked
+// by a previous run) or from a single element and jumps toward the cutoff based on the points already measured.
+static int
+tdm_find_size(overlap_params_t *params, tdm_post_fn_t post, double *data, uint64_t *elts, int *iters)
+{
+    double avg_wait_time = 0.0, stdev, required_iters = 0.0;
+    double lo_t = 0.0, prev_t = 0.0, hi_t = 0.0;
+    uint64_t lo_n = 0, prev_n = 0, hi_n = 0;
+    uint64_t limit = params->max_elts / 2;
+    uint64_t n_elts = 1;
+    int n_iters = TDM_DEFAULT_N_ITERS;
+    int n_steps = 0, n_refinements = 0;
+    bool done = false;
+
+    if (params->seed_elts > 0)
+        n_elts = params->seed_elts;
+    if (n_elts > limit)
+        n_elts = limit > 0 ? limit : 1;
+
+    // Find the size that gives an execution time close to the cutoff
+    do
+    {
+        if (tdm_get_coll_config_info(params, post, data, n_elts, 5, 0, &stdev, &avg_wait_time, NULL))
+            goto exit_error;
+        n_steps++;
+        if (params->world_rank == 0)
+        {
+            OVERLAP_DEBUG(params, "Size search step %d: %" PRIu64 " elts, time = %f\n", n_steps, n_elts, avg_wait_time);
+            overlap_output_add_search_step(n_elts, avg_wait_time);
+            if (avg_wait_time < params->cutoff_time)
+            {
+                prev_n = lo_n;
+                prev_t = lo_t;
+                lo_n = n_elts;
+                lo_t = avg_wait_time;
+            }
+            else
+            {
+                hi_n = n_elts;
+                hi_t = avg_wait_time;
+            }
+
+            if (hi_n == 0)
+            {
+                n_elts = tdm_next_search_size(params, lo_n, lo_t, prev_n, prev_t, hi_n, hi_t);
+                if (n_elts > limit)
+                    n_elts = limit;
+                if (n_elts <= lo_n)
+                    CHECK_N_ELTS(lo_n, params->max_elts, avg_wait_time);
+            }
+            else if (hi_t <= params->cutoff_time * TDM_SIZE_SEARCH_MAX_OVERSHOOT || n_refinements >= TDM_SIZE_SEARCH_MAX_REFINEMENTS ||
+                     hi_n <= lo_n + 1 || hi_n == 1)
+            {
+                // Close enough to the cutoff (or cannot get any closer), we use the smallest size above the cutoff
+                n_elts = hi_n;
+                avg_wait_time = hi_t;
+                done = true;
+            }
+            else
+            {
+                n_elts = tdm_next_search_size(params, lo_n, lo_t, prev_n, prev_t, hi_n, hi_t);
+                n_refinements++;
+            }
+        }
+
+        MPI_CHECK(MPI_Bcast(&done, 1, MPI_C_BOOL, 0, params->comm));
+        MPI_CHECK(MPI_Bcast(&n_elts, 1, MPI_UINT64_T, 0, params->comm));
+    } while (!done);
+
+    if (params->world_rank == 0)
+        OVERLAP_DEBUG(params, "Size search converged after %d steps (%d refinements)\n", n_steps, n_refinements);
+    if (params->world_rank == 0)
+        OVERLAP_DEBUG(params, "Will be using %" PRIu64 " elts (time = %f)\n", n_elts, avg_wait_time);
+
+    do
+    {
+        // We gather some basic data using the default amount of iterations.
+        // Based on the resulting execution time and standard deviation, we calculate how much iterations would
+        // be necessary to have relevant results. If the number of iterations is within our limit, we use that
+        // configuration, otherwise we recursively increase the amount of data.
+        if (tdm_get_coll_config_info(params, post, data, n_elts, n_iters, 0, &stdev, &avg_wait_time, NULL))
+            goto exit_error;
+        if (params->world_rank == 0)
+        {
+            required_iters = tdm_required_iters(stdev, avg_wait_time);
+            OVERLAP_DEBUG(params, "Required number of iterations = %.0f (%" PRIu64 " elts)\n", required_iters, n_elts);
+            if (required_iters > MAX_NUM_CALIBRATION_POINTS)
+            {
+                CHECK_N_ELTS(n_elts, params->max_elts, avg_wait_time);
+                n_elts *= 2;
+            }
+            else
+            {
+                if (required_iters > n_iters)
+                    n_iters = (int)required_iters;
+                if (required_iters > params->max_iters)
+                    n_iters = params->max_iters;
+            }
+        }
+
+        MPI_CHECK(MPI_Bcast(&required_iters, 1, MPI_DOUBLE, 0, params->comm));
+        MPI_CHECK(MPI_Bcast(&n_iters, 1, MPI_INT, 0, params->comm));
+        MPI_CHECK(MPI_Bcast(&n_elts, 1, MPI_UINT64_T, 0, params->comm));
+    } while (required_iters > MAX_NUM_CALIBRATION_POINTS);
+
+    if (n_iters > MAX_NUM_CALIBRATION_POINTS)
+        goto exit_error;
+
+    *elts = n_elts;
+    *iters = n_iters;
+    return 0;
+exit_error:
+    return 1;
+}
+
+// tdm_compute_inflation measures how much the communication in flight slows down the computation. The overlap assumes
+// that the injected work runs at full speed while the operations progress, but memory bandwidth, cache pollution and
+// progress threads are shared with the computation. Every iteration times the same amount of work, equivalent to the
+// reference time, once alone and once with the operations in flight; the inflation of a rank is the increase of its
+// compute time in percent. The average over the ranks and the highest inflation are reported on rank 0. work is in
+// nano-seconds, see tdm_calibrate_work().
+static int
+tdm_compute_inflation(overlap_params_t *params, tdm_post_fn_t post, uint64_t n_elts, int n_iters, int64_t work, tdm_result_t *res)
+{
+    MPI_Request reqs[MAX_CONCURRENCY];
+    double alone_time = 0.0, busy_time = 0.0, start;
+    double inflation_sum;
+    struct
+    {
+        double value;
+        int rank;
+    } inflation, max_inflation;
+    int n;
+
+    res->has_inflation = false;
+    if (!params->compute_inflation || work <= 0)
+        return 0;
+
+    // Every iteration computes twice for about the reference time; res->ref_time is only valid on rank 0 while work,
+    // derived from the reference time broadcast by TDM_SET_ITERS_AND_ELTS, is the same on all the ranks
+    MPI_CHECK(overlap_sync_start(params, 2 * work / 1e6));
+    work = tdm_work_units(params, work);
+    for (n = 0; n < n_iters; n++)
+    {
+        // Both measurements are interleaved so that a drift of the node affects them the same way
+        start = MPI_Wtime();
+        overlap_work(params, work);
+        alone_time += MPI_Wtime() - start;
+
+        MPI_CHECK(tdm_post(params, post, n_elts, reqs));
+        start = MPI_Wtime();
+        overlap_work(params, work);
+        busy_time += MPI_Wtime() - start;
+        MPI_CHECK(tdm_wait(params, reqs));
+        MPI_CHECK(overlap_sync_next(params));
+    }
+
+    inflation.value = alone_time > 0 ? (busy_time - alone_time) * 100 / alone_time : 0.0;
+    inflation.rank = params->world_rank;
+    MPI_CHECK(MPI_Reduce(&inflation.value, &inflation_sum, 1, MPI_DOUBLE, MPI_SUM, 0, params->comm));
+    MPI_CHECK(MPI_Reduce(&inflation, &max_inflation, 1, MPI_DOUBLE_INT, MPI_MAXLOC, 0, params->comm));
+    if (params->world_rank == 0)
+    {
+        res->has_inflation = true;
+        res->inflation = inflation_sum / params->world_size;
+        res->max_inflation = max_inflation.value;
+        res->max_inflation_rank = max_inflation.rank;
+        OVERLAP_DEBUG(params, "Compute inflation: %f %% (max %f %% on rank %d)\n", res->inflation, res->max_inflation,
+                      res->max_inflation_rank);
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// tdm_max_across_ranks replaces, on rank 0, the n timings of values by their maximum across the ranks. With a list of
+// roots, rank 0 is a leaf of the collective operation for all roots but itself; the searches of the rooted collective
+// operations therefore rely on the slowest rank, the root included, rather than on the timings of rank 0.
+static int tdm_max_across_ranks(overlap_params_t *params, double *values, int n)
+{
+    if (params->n_roots == 0)
+        return 0;
+    MPI_CHECK(MPI_Reduce(params->world_rank == 0 ? MPI_IN_PLACE : values, values, n, MPI_DOUBLE, MPI_MAX, 0, params->comm));
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// tdm_record_result adds a result to the structured output of the benchmark
+static void tdm_record_result(overlap_params_t *params, tdm_result_t *res)
+{
+    overlap_output_result_t r;
+    r.n_elts = res->n_elts;
+    r.n_iters = res->n_iters;
+    r.ref_time = res->ref_time;
+    r.stdev = res->stdev;
+    r.work_time = res->work_time;
+    r.wait_time = res->wait_time;
+    r.overlap = res->overlap;
+    r.completion_time = res->completion_time;
+    r.completed = res->completed;
+    r.n_pvars = overlap_pvars.n_pvars;
+    memcpy(r.pvars, res->pvars, overlap_pvars.n_pvars * sizeof(double));
+    r.has_inflation = res->has_inflation;
+    r.inflation = res->inflation;
+    r.max_inflation = res->max_inflation;
+    r.max_inflation_rank = res->max_inflation_rank;
+    r.work_rate_min = res->work_rate_min;
+    r.work_rate_max = res->work_rate_max;
+    r.slowest_rank = res->slowest_rank;
+    overlap_output_add_result(params, &r);
+}
+
+// tdm_overlap calculates the overlap for a given number of elements and iterations. If deadline is not 0,
+// the search stops when MPI_Wtime() goes beyond it and the best known result is reported.
+static int
+tdm_overlap(overlap_params_t *params, tdm_post_fn_t post, uint64_t target_n_elts, int target_n_iters, double deadline, tdm_result_t *res)
+{
+    double work_time, final_work_time = 0.0;
+    double wait_time = 0.0, final_wait_time = -1.0;
+    double *calibration_data = NULL;
+    int64_t ref_work;
+    MPI_Request reqs[MAX_CONCURRENCY];
+    INIT_OVERLAP_VARIABLES
+    MEMALLOC(calibration_data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
+    n_elts = target_n_elts;
+    n_iters = target_n_iters;
+    overlap = 0.0;
+    res->completed = true;
+    INIT_OVERLAP_STATUS(params, (&overlap_status));
+    overlap_pvar_reset(params);
+
+    // Get the reference time and stdev based on the final configuration
+    if (tdm_get_coll_config_info(params, post, calibration_data, n_elts, n_iters, 0, &stdev, &ref_time, &res->completion_time))
+        goto exit_error;
+    double ref_times[2] = {ref_time, stdev};
+    if (tdm_max_across_ranks(params, ref_times, 2))
+        goto exit_error;
+    ref_time = ref_times[0];
+    stdev = ref_times[1];
+    TDM_SET_ITERS_AND_ELTS
+
+    // Run the benchmark loop
+    while (work > 0)
+    {
+        // Actual benchmarking loop
+        if (params->world_rank == 0)
+            OVERLAP_DEBUG(params, "Benchmark loop for work = %" PRId64 "\n", work);
+        total_time = 0.0;
+        work_time = 0.0;
+        wait_time = 0.0;
+        MPI_CHECK(overlap_sync_start(params, ref_time)); // Make sure to sync ranks before moving on, we don't want late arrivals
+        overlap_pvar_begin();
+        for (n = 0; n < n_iters; n++)
+        {
+            inject_skew(params);
+            MPI_CHECK(tdm_post(params, post, n_elts, reqs));
+            start_work = MPI_Wtime();
+            overlap_work(params, tdm_work_units(params, work));
+            end_work = MPI_Wtime();
+            MPI_CHECK(tdm_wait(params, reqs));
+            end_time = MPI_Wtime();
+            total_time += end_time - start_work;
+            work_time += end_work - start_work;
+            wait_time += end_time - end_work;
+            MPI_CHECK(overlap_sync_next(params)); // Make sure to sync ranks before moving on, we don't want late arrivals
+        }
+        overlap_pvar_end(n_iters);
+        total_time *= 1000; // To milliseconds
+        work_time *= 1000;  // To milliseconds
+        wait_time *= 1000;  // To milliseconds
+        double times[3] = {total_time, work_time, wait_time};
+        if (tdm_max_across_ranks(params, times, 3))
+            goto exit_error;
+        total_time = times[0];
+        work_time = times[1];
+        wait_time = times[2];
+
+        TDM_PROCESS_DATA
+        if (params->world_rank == 0 && work > 0 && deadline > 0 && MPI_Wtime() > deadline)
+        {
+            OVERLAP_DEBUG(params, "Time budget exhausted, stopping the search with %" PRId64 " units\n", overlap_status.max_valid_overlap_work_units);
+            res->completed = false;
+            work = -1;
+        }
+        MPI_CHECK(MPI_Bcast(&work, 1, MPI_INT64_T, 0, params->comm));
+    }
+
+    TDM_COMPUTE_OVERLAP
+    MPI_CHECK(overlap_pvar_collect(params, res->pvars));
+    if (tdm_compute_inflation(params, post, n_elts, n_iters, ref_work, res))
+        goto exit_error;
+    if (params->world_rank == 0)
+        tdm_record_result(params, res);
+    FINI_OVERLAP_BENCH;
+    MEMFREE(calibration_data);
+    return 0;
+
+exit_error:
+    FINI_OVERLAP_BENCH;
+    MEMFREE(calibration_data);
+    return 1;
+}
+
+static void tdm_display_result(overlap_params_t *params, tdm_result_t *res)
+{
+    if (params->world_rank != 0)
+        return;
+
+    fprintf(stdout, "Data size exchanged per rank: %" PRIu64 " bytes\n", res->n_elts * overlap_elt_size(params));
+    fprintf(stdout, "Injected work time: %f milli-seconds\n", res->work_time);
+    fprintf(stdout, "Reference time: %f milli-seconds (stdev: %f)\n", res->ref_time, res->stdev);
+    if (res->completion_time >= 0)
+        fprintf(stdout, "Completion time across ranks: %f milli-seconds\n", res->completion_time);
+    fprintf(stdout, "Overlap: %.0f %%\n", res->overlap);
+    if (res->work_rate_max > 0)
+        fprintf(stdout, "Work calibration: %.0f to %.0f work units per milli-second (spread: %.1f %%, slowest rank: %d)\n",
+                res->work_rate_min, res->work_rate_max, (res->work_rate_max - res->work_rate_min) * 100 / res->work_rate_max,
+                res->slowest_rank);
+    if (res->has_inflation)
+    {
+        fprintf(stdout, "Compute inflation: %.1f %% (max: %.1f %% on rank %d)\n", res->inflation, res->max_inflation,
+                res->max_inflation_rank);
+        overlap_output_set_inflation(params, res->inflation);
+    }
+    overlap_pvar_display(res->pvars);
+    overlap_output_set_overlap(params, res->overlap);
+}
+
+// tdm_sweep_allocate_iters spreads the remaining time budget (in milli-seconds) across the sizes that still need
+// to be evaluated, starting at the index first. The number of iterations for each size is based on its measured
+// variability, using the same criteria than tdm_find_size() and the same limit of MAX_NUM_CALIBRATION_POINTS
+// iterations; if the budget is not large enough, all the sizes are scaled down proportionally.
+static void
+tdm_sweep_allocate_iters(overlap_params_t *params, int first, double *means, double *stdevs, double remaining_time, int *iters)
+{
+    double required[MAX_SWEEP_SIZES];
+    double total_cost = 0.0, scale = 1.0;
+    int max_iters = params->max_iters < MAX_NUM_CALIBRATION_POINTS ? params->max_iters : MAX_NUM_CALIBRATION_POINTS;
+    int i;
+
+    for (i = first; i < params->sweep_n_sizes; i++)
+    {
+        if (means[i] > 0)
+            required[i] = tdm_required_iters(stdevs[i], means[i]);
+        else
+            required[i] = max_iters;
+        if (required[i] < TDM_SWEEP_MIN_ITERS)
+            required[i] = TDM_SWEEP_MIN_ITERS;
+        if (required[i] > max_iters)
+            required[i] = max_iters;
+        total_cost += required[i] * means[i] * TDM_SWEEP_PROBE_FACTOR;
+    }
+
+    if (total_cost > remaining_time)
+        scale = remaining_time / total_cost;
+
+    for (i = first; i < params->sweep_n_sizes; i++)
+    {
+        iters[i] = (int)(required[i] * scale);
+        if (iters[i] < TDM_SWEEP_MIN_ITERS)
+            iters[i] = TDM_SWEEP_MIN_ITERS;
+        OVERLAP_DEBUG(params, "Sweep: %d iterations for %" PRIu64 " elts (mean = %f, stdev = %f)\n", iters[i], params->sweep_sizes[i], means[i], stdevs[i]);
     }
+}
+
+// tdm_sweep calculates the overlap for all the sizes specified by the user while trying to stay within the time budget.
+// The first size is always evaluated; the results of the size with the lowest overlap are returned in worst, they are
+// the overlap reported for the benchmark.
+static int
+tdm_sweep(overlap_params_t *params, tdm_post_fn_t post, tdm_result_t *worst)
+{
+    double means[MAX_SWEEP_SIZES], stdevs[MAX_SWEEP_SIZES];
+    int iters[MAX_SWEEP_SIZES];
+    tdm_result_t results[MAX_SWEEP_SIZES];
+    double *data = NULL;
+    double start = MPI_Wtime();
+    double deadline = start + params->time_budget;
+    int n_done = 0, lowest = 0;
+    int i;
+
+    MEMALLOC(data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
+
+    // Pilot runs giving a first estimate of the execution time and variability of every size
+    for (i = 0; i < params->sweep_n_sizes; i++)
+    {
+        if (tdm_get_coll_config_info(params, post, data, params->sweep_sizes[i], TDM_SWEEP_PILOT_ITERS, 0, &stdevs[i], &means[i], NULL))
+            goto exit_error;
+    }
+
+    for (i = 0; i < params->sweep_n_sizes; i++)
+    {
+        double remaining_time = (deadline - MPI_Wtime()) * 1000; // To milliseconds
+        if (params->world_rank == 0)
+            tdm_sweep_allocate_iters(params, i, means, stdevs, remaining_time, iters);
+        MPI_CHECK(MPI_Bcast(&remaining_time, 1, MPI_DOUBLE, 0, params->comm));
+        MPI_CHECK(MPI_Bcast(&iters[i], 1, MPI_INT, 0, params->comm));
+        if (remaining_time <= 0 && i > 0)
+            break;
+
+        if (tdm_overlap(params, post, params->sweep_sizes[i], iters[i], deadline, &results[i]))
+            goto exit_error;
+        n_done++;
+    }
+
+    if (params->world_rank == 0)
+    {
+        fprintf(stdout, "Data size (bytes)\tIterations\tReference time (ms)\tStdev (ms)\tInjected work time (ms)\tOverlap (%%)\n");
+        for (i = 0; i < params->sweep_n_sizes; i++)
+        {
+            if (i >= n_done)
+            {
+                fprintf(stdout, "%" PRIu64 "\tskipped (time budget exhausted)\n", params->sweep_sizes[i] * overlap_elt_size(params));
+                continue;
+            }
+            fprintf(stdout, "%" PRIu64 "\t%d\t%f\t%f\t%f\t%.1f%s\n", results[i].n_elts * overlap_elt_size(params), results[i].n_iters,
+                    results[i].ref_time, results[i].stdev, results[i].work_time, results[i].overlap,
+                    results[i].completed ? "" : " (partial)");
+            if (results[i].overlap < results[lowest].overlap)
+                lowest = i;
+        }
+        fprintf(stdout, "Sweep execution time: %f seconds\n", MPI_Wtime() - start);
+        fprintf(stdout, "Lowest overlap: %" PRIu64 " bytes\n", results[lowest].n_elts * overlap_elt_size(params));
+        *worst = results[lowest];
+    }
+
+    MEMFREE(data);
+    return 0;
+exit_error:
+    MEMFREE(data);
+    return 1;
+}
+
+// tdm_skew_sweep calculates the overlap for all the skews specified by the user. The size is found without skew so
+// all the skews are evaluated with the same size; the results of the first skew are then displayed as usual.
+static int
+tdm_skew_sweep(overlap_params_t *params, tdm_post_fn_t post)
+{
+    tdm_result_t results[MAX_SKEWS];
+    double *data = NULL;
+    uint64_t n_elts;
+    int n_iters;
+    int i;
+
+    MEMALLOC(data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
+    params->skew = 0;
+    if (tdm_find_size(params, post, data, &n_elts, &n_iters))
+        goto exit_error;
+    MEMFREE(data);
+
+    for (i = 0; i < params->n_skews; i++)
+    {
+        params->skew = params->skews[i];
+        if (params->world_rank == 0)
+            OVERLAP_DEBUG(params, "Evaluating overlap with a skew of %d micro-seconds\n", params->skew);
+        if (tdm_overlap(params, post, n_elts, n_iters, 0, &results[i]))
+            goto exit_error;
+    }
+
+    if (params->world_rank == 0)
+    {
+        fprintf(stdout, "Skew (us)\tReference time (ms)\tStdev (ms)\tInjected work time (ms)\tWait time (ms)\tOverlap (%%)\n");
+        for (i = 0; i < params->n_skews; i++)
+            fprintf(stdout, "%d\t%f\t%f\t%f\t%f\t%.1f\n", params->skews[i], results[i].ref_time, results[i].stdev,
+                    results[i].work_time, results[i].wait_time, results[i].overlap);
+    }
+    params->skew = params->skews[0];
+    tdm_display_result(params, &results[0]);
+    return 0;
+
+exit_error:
+    MEMFREE(data);
+    return 1;
+}
+
+static int
+tdm_init(overlap_params_t *params)
+{
+    if (params->verbose && params->world_rank == 0)
+        display_overlap_params(params, sizeof(double));
+
+    if (!calibrate(params))
+    {
+        fprintf(stderr, "Calibration failed\n");
+        return 1;
+    }
+    return overlap_pvar_init(params) || overlap_cvar_init(params);
+}
+
+// tdm_run evaluates the overlap with the current parameters, either for a single size or for a sweep
+static int
+tdm_run(overlap_params_t *params, tdm_post_fn_t post)
+{
+    tdm_result_t res;
+    double *data = NULL;
+    uint64_t n_elts;
+    int n_iters;
+
+    if (params->sweep_n_sizes > 0)
+    {
+        if (tdm_sweep(params, post, &res))
+            return 1;
+        tdm_display_result(params, &res);
+        return 0;
+    }
+
+    if (params->n_skews > 1)
+        return tdm_skew_sweep(params, post);
+
+    MEMALLOC(data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
+    if (tdm_find_size(params, post, data, &n_elts, &n_iters))
+        goto exit_error;
+    MEMFREE(data);
+
+    if (tdm_overlap(params, post, n_elts, n_iters, 0, &res))
+        goto exit_error;
+    tdm_display_result(params, &res);
+    return 0;
+
+exit_error:
+    MEMFREE(data);
+    return 1;
+}
+
+// tdm_rooted_run evaluates the overlap of a rooted collective operation. When a list of roots is specified, the
+// overlap is evaluated for every root with the same size, i.e., the one found with the first root, and the worst
+// root is reported. The timings are the maximum across the ranks, see tdm_max_across_ranks(). In sweep mode, every
+// root sweeps all the sizes and the worst root is the one with the lowest overlap over its sizes.
+static int
+tdm_rooted_run(overlap_params_t *params, tdm_post_fn_t post)
+{
+    tdm_result_t results[MAX_ROOTS];
+    double *data = NULL;
+    uint64_t n_elts;
+    int n_iters;
+    int i, worst = 0;
+
+    if (params->n_roots == 0)
+        return tdm_run(params, post);
+
+    if (params->sweep_n_sizes > 0)
+    {
+        for (i = 0; i < params->n_roots; i++)
+        {
+            params->root = params->roots[i];
+            if (params->world_rank == 0)
+                fprintf(stdout, "Root: %d\n", params->root);
+            if (tdm_sweep(params, post, &results[i]))
+                return 1;
+            if (params->world_rank == 0 && results[i].overlap < results[worst].overlap)
+                worst = i;
+        }
+
+        if (params->world_rank == 0)
+        {
+            fprintf(stdout, "Root\tLowest overlap data size (bytes)\tOverlap (%%)\n");
+            for (i = 0; i < params->n_roots; i++)
+                fprintf(stdout, "%d\t%" PRIu64 "\t%.1f\n", params->roots[i], results[i].n_elts * overlap_elt_size(params),
+                        results[i].overlap);
+            fprintf(stdout, "Worst root: %d\n", params->roots[worst]);
+        }
+        tdm_display_result(params, &results[worst]);
+        return 0;
+    }
+
+    MEMALLOC(data, double, MAX_NUM_CALIBRATION_POINTS * sizeof(double));
+    params->root = params->roots[0];
+    if (tdm_find_size(params, post, data, &n_elts, &n_iters))
+        goto exit_error;
+    MEMFREE(data);
+
+    for (i = 0; i < params->n_roots; i++)
+    {
+        params->root = params->roots[i];
+        if (params->world_rank == 0)
+            OVERLAP_DEBUG(params, "Evaluating overlap with root %d\n", params->root);
+        if (tdm_overlap(params, post, n_elts, n_iters, 0, &results[i]))
+            goto exit_error;
+        if (params->world_rank == 0 && results[i].overlap < results[worst].overlap)
+            worst = i;
+    }
+
+    if (params->world_rank == 0)
+    {
+        fprintf(stdout, "Root\tReference time (ms)\tStdev (ms)\tInjected work time (ms)\tOverlap (%%)\n");
+        for (i = 0; i < params->n_roots; i++)
+            fprintf(stdout, "%d\t%f\t%f\t%f\t%.1f\n", params->roots[i], results[i].ref_time, results[i].stdev,
+                    results[i].work_time, results[i].overlap);
+        fprintf(stdout, "Worst root: %d\n", params->roots[worst]);
+    }
+    tdm_display_result(params, &results[worst]);
+    return 0;
+
+exit_error:
+    MEMFREE(data);
+    return 1;
+}
+
+typedef int (*tdm_run_fn_t)(overlap_params_t *params, tdm_post_fn_t post);
+
+// tdm_comm_run evaluates the overlap on a sub-communicator of MPI_COMM_WORLD, with a copy of the parameters where
+// world_size and world_rank are relative to the sub-communicator. Rank 0 of MPI_COMM_WORLD must be rank 0 of the
+// sub-communicator so it remains the rank reporting the results. Roots that are not part of the sub-communicator are
+// dropped.
+static int
+tdm_comm_run(overlap_params_t *params, tdm_post_fn_t post, tdm_run_fn_t run, MPI_Comm comm, int comm_split)
+{
+    overlap_params_t comm_params = *params;
+    int rc, i;
+
+    comm_params.comm = comm;
+    comm_params.comm_split = comm_split;
+    MPI_CHECK(MPI_Comm_size(comm, &comm_params.world_size));
+    MPI_CHECK(MPI_Comm_rank(comm, &comm_params.world_rank));
+
+    comm_params.n_roots = 0;
+    for (i = 0; i < params->n_roots; i++)
+    {
+        if (params->roots[i] < comm_params.world_size)
+            comm_params.roots[comm_params.n_roots++] = params->roots[i];
+    }
+    if (comm_params.root >= comm_params.world_size)
+        comm_params.root = 0;
+
+    if (comm_params.world_rank == 0)
+        fprintf(stdout, "\nCommunicator: %s (%d ranks)\n", comm_split_name(comm_split), comm_params.world_size);
+    if (comm_params.world_size < 2)
+    {
+        if (comm_params.world_rank == 0)
+            fprintf(stdout, "Skipped, at least 2 ranks are required\n");
+        return 0;
+    }
+    if (tdm_dup_comms(&comm_params))
+        return 1;
+    rc = run(&comm_params, post);
+    tdm_free_comms(&comm_params);
+    return rc;
+
+exit_error:
+    return 1;
+}
+
+// tdm_comm_splits_run evaluates the overlap on the communicators requested with OPENHPCA_OVERLAP_COMM_SPLITS, to
+// separate the shared-memory part of the collective operations from their network part. The node communicator only
+// includes the ranks of the node of rank 0, the ranks of the other nodes wait for the end of the evaluation so that no
+// other traffic interferes with the measurement; the leaders communicator includes the lowest rank of every node.
+static int
+tdm_comm_splits_run(overlap_params_t *params, tdm_post_fn_t post, tdm_run_fn_t run)
+{
+    MPI_Comm node_comm = MPI_COMM_NULL, leaders_comm = MPI_COMM_NULL;
+    int node_rank, node_leader;
+    int rc = 0;
+
+    if (params->comm_splits == 0)
+        return 0;
+
+    MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, params->world_rank, MPI_INFO_NULL, &node_comm));
+    MPI_CHECK(MPI_Comm_rank(node_comm, &node_rank));
+    // The leader of a node is its lowest rank in MPI_COMM_WORLD, i.e., 0 on the node of rank 0
+    MPI_CHECK(MPI_Allreduce(&params->world_rank, &node_leader, 1, MPI_INT, MPI_MIN, node_comm));
+
+    if (params->comm_splits & (1 << COMM_SPLIT_NODE))
+    {
+        if (node_leader == 0)
+            rc = tdm_comm_run(params, post, run, node_comm, COMM_SPLIT_NODE);
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        if (rc)
+            goto exit_error;
+    }
+
+    if (params->comm_splits & (1 << COMM_SPLIT_LEADERS))
+    {
+        MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, params->world_rank, &leaders_comm));
+        if (leaders_comm != MPI_COMM_NULL)
+            rc = tdm_comm_run(params, post, run, leaders_comm, COMM_SPLIT_LEADERS);
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        if (rc)
+            goto exit_error;
+        if (leaders_comm != MPI_COMM_NULL)
+            MPI_Comm_free(&leaders_comm);
+    }
+
+    MPI_Comm_free(&node_comm);
+    return 0;
+
+exit_error:
+    if (leaders_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&leaders_comm);
+    if (node_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&node_comm);
+    return 1;
+}
+
+// tdm_comm_sizes_run evaluates the overlap on communicators made of the first ranks of MPI_COMM_WORLD, for each size
+// requested with OPENHPCA_OVERLAP_COMM_SIZES, and displays the overlap against the number of ranks. The ranks that are
+// not part of a communicator wait for the end of its evaluation.
+static int
+tdm_comm_sizes_run(overlap_params_t *params, tdm_post_fn_t post, tdm_run_fn_t run)
+{
+    MPI_Comm comm = MPI_COMM_NULL;
+    double overlap;
+    int rc = 0;
+    int i;
+
+    if (params->n_comm_sizes == 0)
+        return 0;
+
+    for (i = 0; i < params->n_comm_sizes; i++)
+    {
+        MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, params->world_rank < params->comm_sizes[i] ? 0 : MPI_UNDEFINED, params->world_rank, &comm));
+        if (comm != MPI_COMM_NULL)
+        {
+            rc = tdm_comm_run(params, post, run, comm, COMM_SPLIT_SUBSET);
+            MPI_Comm_free(&comm);
+        }
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        if (rc)
+            return 1;
+    }
+
+    if (params->world_rank == 0)
+    {
+        fprintf(stdout, "\nRanks\tOverlap (%%)\n");
+        for (i = 0; i < params->n_comm_sizes; i++)
+        {
+            if (overlap_output_get_comm_overlap(COMM_SPLIT_SUBSET, params->comm_sizes[i], &overlap))
+                fprintf(stdout, "%d\t%.1f\n", params->comm_sizes[i], overlap);
+            else
+                fprintf(stdout, "%d\tn/a\n", params->comm_sizes[i]);
+        }
+        if (overlap_output.has_overlap)
+            fprintf(stdout, "%d\t%.1f\n", params->world_size, overlap_output.overlap);
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// tdm_reduce_sweep evaluates the overlap of a reduction for every combination of the datatypes and operations requested
+// with OPENHPCA_OVERLAP_REDUCE_TYPES and OPENHPCA_OVERLAP_REDUCE_OPS, MPI_DOUBLE and MPI_SUM being used when only one of
+// the lists is specified, and displays the overlap of every combination. The combination of MPI_DOUBLE and MPI_SUM is
+// the one of the main run and is not evaluated again.
+static int
+tdm_reduce_sweep(overlap_params_t *params, tdm_post_fn_t post, tdm_run_fn_t run)
+{
+    int default_type = REDUCE_TYPE_DOUBLE, default_op = REDUCE_OP_SUM;
+    int *types = params->n_reduce_types > 0 ? params->reduce_types : &default_type;
+    int *ops = params->n_reduce_ops > 0 ? params->reduce_ops : &default_op;
+    int n_types = params->n_reduce_types > 0 ? params->n_reduce_types : 1;
+    int n_ops = params->n_reduce_ops > 0 ? params->n_reduce_ops : 1;
+    double overlap;
+    int rc = 0;
+    int t, o;
+
+    if (params->reduce_type < 0 || (params->n_reduce_types == 0 && params->n_reduce_ops == 0))
+        return 0;
+
+    MPI_CHECK(overlap_reduce_create_op(params));
+    for (t = 0; t < n_types && rc == 0; t++)
+    {
+        for (o = 0; o < n_ops && rc == 0; o++)
+        {
+            if ((types[t] == REDUCE_TYPE_DOUBLE && ops[o] == REDUCE_OP_SUM) || !overlap_reduce_supported(types[t], ops[o]))
+                continue;
+            params->reduce_type = types[t];
+            params->reduce_op = ops[o];
+            if (params->world_rank == 0)
+                fprintf(stdout, "\nReduction: %s %s\n", reduce_type_names[types[t]], reduce_op_names[ops[o]]);
+            rc = run(params, post);
+        }
+    }
+    params->reduce_type = REDUCE_TYPE_DOUBLE;
+    params->reduce_op = REDUCE_OP_SUM;
+    overlap_reduce_free_op();
+    if (rc)
+        return 1;
+
+    if (params->world_rank == 0)
+    {
+        fprintf(stdout, "\nDatatype\tOperation\tOverlap (%%)\n");
+        for (t = 0; t < n_types; t++)
+        {
+            for (o = 0; o < n_ops; o++)
+            {
+                fprintf(stdout, "%s\t%s\t", reduce_type_names[types[t]], reduce_op_names[ops[o]]);
+                if (!overlap_reduce_supported(types[t], ops[o]))
+                    fprintf(stdout, "unsupported\n");
+                else if (overlap_output_get_reduce_overlap(types[t], ops[o], &overlap))
+                    fprintf(stdout, "%.1f\n", overlap);
+                else
+                    fprintf(stdout, "n/a\n");
+            }
+        }
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// tdm_cvar_sweep evaluates the overlap for every setting of the control variables requested with
+// OPENHPCA_OVERLAP_CVARS and displays the overlap of every setting. Implementations usually select the algorithms of
+// a communicator when it is created, every setting is therefore evaluated on a fresh duplicate of the communicator.
+static int
+tdm_cvar_sweep(overlap_params_t *params, tdm_post_fn_t post, tdm_run_fn_t run)
+{
+    overlap_params_t cvar_params;
+    char setting[MAX_CVAR_SETTING_LEN];
+    int first, i, rc = 0;
+
+    if (!overlap_cvars.enabled || overlap_cvars.n_cvars == 0)
+        return 0;
+
+    first = overlap_output.n_cvar_settings;
+    do
+    {
+        cvar_params = *params;
+        overlap_cvar_setting(setting, sizeof(setting));
+        if (params->world_rank == 0)
+        {
+            fprintf(stdout, "\nControl variables: %s\n", setting);
+            cvar_params.cvar_setting = overlap_output_add_cvar_setting(setting);
+        }
+        if (overlap_cvar_apply())
+            goto exit_error;
+        MPI_CHECK(MPI_Comm_dup(params->comm, &cvar_params.comm));
+        if (tdm_dup_comms(&cvar_params))
+            goto exit_error;
+        rc = run(&cvar_params, post);
+        tdm_free_comms(&cvar_params);
+        MPI_CHECK(MPI_Comm_free(&cvar_params.comm));
+    } while (rc == 0 && overlap_cvar_next());
+    if (overlap_cvar_restore() || rc)
+        return 1;
+
+    if (params->world_rank == 0)
+    {
+        fprintf(stdout, "\nControl variables\tOverlap (%%)\n");
+        if (overlap_output.has_overlap)
+            fprintf(stdout, "default\t%.1f\n", overlap_output.overlap);
+        for (i = first; i < overlap_output.n_cvar_settings; i++)
+        {
+            if (overlap_output.cvar_settings[i].has_overlap)
+                fprintf(stdout, "%s\t%.1f\n", overlap_output.cvar_settings[i].setting, overlap_output.cvar_settings[i].overlap);
+            else
+                fprintf(stdout, "%s\tn/a\n", overlap_output.cvar_settings[i].setting);
+        }
+    }
+    return 0;
+
+exit_error:
+    return 1;
+}
+
+// time_driven_loop is the entry point of the time driven model
+static inline int
+time_driven_loop(overlap_params_t *params, tdm_post_fn_t post)
+{
+    int rc;
+
+    if (tdm_init(params) || tdm_dup_comms(params))
+        return 1;
+    rc = tdm_run(params, post);
+    if (rc == 0)
+        rc = tdm_reduce_sweep(params, post, tdm_run);
+    if (rc == 0)
+        rc = tdm_cvar_sweep(params, post, tdm_run);
+    tdm_free_comms(params);
+    if (rc || tdm_comm_splits_run(params, post, tdm_run))
+        return 1;
+    rc = tdm_comm_sizes_run(params, post, tdm_run);
+    overlap_pvar_fini();
+    overlap_cvar_fini();
+    return rc;
+}
+
+// rooted_time_driven_loop is the entry point of the time driven model for rooted collective operations
+static inline int
+rooted_time_driven_loop(overlap_params_t *params, tdm_post_fn_t post)
+{
+    int rc;
+
+    if (tdm_init(params) || tdm_dup_comms(params))
+        return 1;
+    rc = tdm_rooted_run(params, post);
+    if (rc == 0)
+        rc = tdm_reduce_sweep(params, post, tdm_rooted_run);
+    if (rc == 0)
+        rc = tdm_cvar_sweep(params, post, tdm_rooted_run);
+    tdm_free_comms(params);
+    if (rc || tdm_comm_splits_run(params, post, tdm_rooted_run))
+        return 1;
+    rc = tdm_comm_sizes_run(params, post, tdm_rooted_run);
+    overlap_pvar_fini();
+    overlap_cvar_fini();
+    return rc;
+}
 
-#endif // OVERLAP_TDM_H_
\ No newline at end of file
+#endif // OVERLAP_TDM_H_
@@ -29,6 +29,7 @@ import (
 	"github.com/openucx/openhpca/tools/internal/pkg/fileUtils"
 	"github.com/openucx/openhpca/tools/internal/pkg/overlap"
 	"github.com/openucx/openhpca/tools/internal/pkg/report"
+	"github.com/openucx/openhpca/tools/internal/pkg/result"
 	"github.com/openucx/openhpca/tools/internal/pkg/score"
 	"github.com/openucx/openhpca/tools/internal/pkg/smb"
 )
@@ -308,6 +309,21 @@ func main() {
 		os.Exit(1)
 	}
 
+	// exportEnv makes sure an environment variable is set for all the ranks of an experiment
+	// todo: find a better way to abtract this, i.e., make sure it is set correctly for all MPI implementations
+	exportEnv := func(e *experiments.Experiment, name string, value string) {
+		if localMPI.ID == implem.OMPI {
+			e.MpirunArgs = append(e.MpirunArgs, "-x "+name+"="+value)
+		}
+		if localMPI.ID == implem.MPICH || localMPI.ID == implem.MVAPICH2 {
+			e.MpirunArgs = append(e.MpirunArgs, "-genv "+name+"="+value)
+		}
+	}
+
+	// The size searches of the overlap benchmarks start from the sizes picked by the previous run, if any, unless a
+	// starting point is set by the calling process
+	previousSizes := result.GetPreviousOverlapSizes(cfg.GetRunDir())
+
 	for benchmarkName, installedBenchmark := range benchmarksToRun {
 		for _, subBenchmark := range installedBenchmark.SubBenchmarks {
 			e := new(experiments.Experiment)
@@ -334,7 +350,6 @@ func main() {
 			}
 
 			// Make sure to set special environment variables
-			// todo: find a better way to abtract this, i.e., make sure it is set correctly for all MPI implementations
 			// Data from the overlap configuration file always prevail on the environment variable from the calling
 			// process
 			overlapNumElts := os.Getenv(overlap.MaxNumEltsEnvVar)
@@ -342,12 +357,11 @@ func main() {
 				overlapNumElts = strconv.Itoa(overlapConfig.MaxNumEltsLookupTable[subBenchmark.BinName])
 			}
 			if overlapNumElts != "" && benchmarkName == "overlap" {
-				if localMPI.ID == implem.OMPI {
-					e.MpirunArgs = append(e.MpirunArgs, "-x "+overlap.MaxNumEltsEnvVar+"="+overlapNumElts)
-				}
-				if localMPI.ID == implem.MPICH || localMPI.ID == implem.MVAPICH2 {
-					e.MpirunArgs = append(e.MpirunArgs, "-genv "+overlap.MaxNumEltsEnvVar+"="+overlapNumElts)
-				}
+				exportEnv(e, overlap.MaxNumEltsEnvVar, overlapNumElts)
+			}
+			seedNumElts := previousSizes[subBenchmark.Name]
+			if seedNumElts > 0 && os.Getenv(overlap.SeedNumEltsEnvVar) == "" && benchmarkName == "overlap" {
+				exportEnv(e, overlap.SeedNumEltsEnvVar, strconv.FormatUint(seedNumElts, 10))
 			}
 
 			exps.List = append(exps.List, e)
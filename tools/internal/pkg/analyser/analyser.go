@@ -8,6 +8,7 @@ package analyser
 
 import (
 	"fmt"
+	"image/color"
 	"log"
 	"path/filepath"
 	"strings"
@@ -16,6 +17,7 @@ import (
 	"gonum.org/v1/plot/plotter"
 	"gonum.org/v1/plot/plotutil"
 	"gonum.org/v1/plot/vg"
+	"gonum.org/v1/plot/vg/draw"
 
 	osuresults "github.com/gvallee/go_osu/pkg/results"
 	"github.com/gvallee/go_util/pkg/util"
@@ -54,6 +56,72 @@ func PlotBenchmarkGraph(outputDir string, operationName string, x []float64, y [
 	return nil
 }
 
+// PlotConvergenceGraph plots the amount of work injected by every probe of the overlap search of a benchmark,
+// showing which probes were overlapped, as well as the revalidations triggered by jitter
+func PlotConvergenceGraph(outputDir string, benchmarkName string, record *result.OverlapRecord) error {
+	filePath := filepath.Join(outputDir, benchmarkName+"_convergence.png")
+	if util.FileExists(filePath) {
+		return nil
+	}
+
+	var passed, failed, revalidations plotter.XYs
+	all := make(plotter.XYs, len(record.Probes))
+	for i, probe := range record.Probes {
+		pt := plotter.XY{X: float64(i), Y: float64(probe.Work)}
+		all[i] = pt
+		if probe.Passed {
+			passed = append(passed, pt)
+		} else {
+			failed = append(failed, pt)
+		}
+		if probe.ValidationCount > 1 {
+			revalidations = append(revalidations, pt)
+		}
+	}
+
+	p := plot.New()
+	p.Title.Text = benchmarkName + " convergence"
+	p.X.Label.Text = "Probe"
+	if record.Model == "tdm" {
+		p.Y.Label.Text = "Injected work (ns)"
+	} else {
+		p.Y.Label.Text = "Injected work (units)"
+	}
+
+	line, err := plotter.NewLine(all)
+	if err != nil {
+		return err
+	}
+	p.Add(line)
+
+	series := []struct {
+		label string
+		pts   plotter.XYs
+		shape draw.GlyphDrawer
+		color color.Color
+	}{
+		{"overlapped", passed, draw.CircleGlyph{}, color.RGBA{G: 160, A: 255}},
+		{"not overlapped", failed, draw.CrossGlyph{}, color.RGBA{R: 200, A: 255}},
+		{"revalidation", revalidations, draw.RingGlyph{}, color.RGBA{B: 200, A: 255}},
+	}
+	for _, s := range series {
+		if len(s.pts) == 0 {
+			continue
+		}
+		scatter, err := plotter.NewScatter(s.pts)
+		if err != nil {
+			return err
+		}
+		scatter.GlyphStyle.Shape = s.shape
+		scatter.GlyphStyle.Color = s.color
+		scatter.GlyphStyle.Radius = vg.Points(4)
+		p.Add(scatter)
+		p.Legend.Add(s.label, scatter)
+	}
+
+	return p.Save(6*vg.Inch, 4*vg.Inch, filePath)
+}
+
 func Plot(r *result.Data, outputDir string) error {
 	for benchmarkName, benchmarkData := range r.OsuData {
 		if strings.HasPrefix(benchmarkName, "i") || strings.Contains(benchmarkName, "_i") {
@@ -84,5 +152,19 @@ func Plot(r *result.Data, outputDir string) error {
 		}
 	}
 
+	for benchmarkName, output := range r.OverlapData {
+		record, err := result.ParseOverlapRecord(output)
+		if err != nil {
+			return err
+		}
+		if record == nil || len(record.Probes) == 0 {
+			continue
+		}
+		err = PlotConvergenceGraph(outputDir, benchmarkName, record)
+		if err != nil {
+			return err
+		}
+	}
+
 	return nil
 }
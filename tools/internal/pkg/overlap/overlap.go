@@ -68,10 +68,37 @@ const (
 	overlapIgatherBinName     = "overlap_igather"
 	overlapIgathervID         = "overlap_igatherv"
 	overlapIgathervBinName    = "overlap_igatherv"
+	overlapNoiseBinName       = "overlap_noise"
+	overlapAsyncBinName       = "overlap_async"
+	overlapPipelineBinName    = "overlap_pipeline"
+	overlapDLTrainBinName     = "overlap_dltrain"
+	overlapPCGBinName         = "overlap_pcg"
+
+	// NoiseID is the OS noise benchmark, which does not measure any overlap but is run with the overlap benchmarks so
+	// that the noise of the nodes can be reported next to their results
+	NoiseID = "overlap_noise"
+	// AsyncID is the benchmark comparing the latency of the blocking, non-blocking and persistent operations, which
+	// does not measure any overlap either but tells how much the non-blocking path costs
+	AsyncID = "overlap_async"
+	// PipelineID is the benchmark evaluating chunked collective operations pipelined with the computation, which
+	// tells which chunk size the MPI library and the fabric reward
+	PipelineID = "overlap_pipeline"
+	// DLTrainID is the data-parallel training pattern, reducing the gradients of a transformer model by buckets during
+	// a simulated backward pass
+	DLTrainID = "overlap_dltrain"
+	// PCGID is the pipelined conjugate gradient pattern, hiding the reduction of the dot products behind the sparse
+	// matrix-vector product of a 3D Poisson problem
+	PCGID = "overlap_pcg"
 
 	MaxNumEltsEnvVar = "OPENHPCA_OVERLAP_MAX_NUM_ELTS"
+	// SeedNumEltsEnvVar is the number of elements the size search of the time driven model starts from
+	SeedNumEltsEnvVar = "OPENHPCA_OVERLAP_SEED_NUM_ELTS"
 )
 
+// RequiredBenchmarks are the benchmarks run by default, i.e., the ones the overlap score is based on. The noise,
+// asynchrony, pipeline and pattern benchmarks do not count in the score and some of them are expensive (e.g., the
+// gradients of the default model of overlap_dltrain take about 440 MB per rank), they are only run when the overlap
+// suite is explicitly selected or with a long run.
 var RequiredBenchmarks = []string{overlapIallreduceID, overlapIreduceID, overlapIallgatherID, overlapIallgathervID,
 	overlapIalltoallID, overlapIalltoallvID, overlapIbcastID, overlapIgatherID, overlapIgathervID}
 
@@ -206,6 +233,61 @@ func GetSubBenchmarks(cfg *benchmark.Config, wp *workspace.Config) map[string]ap
 	}
 	m[overlapIgathervID] = overlapIgathervInfo
 
+	overlapNoiseInfo := app.Info{
+		Name: NoiseID,
+		Source: app.SourceCode{
+			URL: "file:///" + filepath.Join(overlapDir, overlapDir, NoiseID),
+		},
+		BinName: overlapNoiseBinName,
+		BinPath: filepath.Join(installDir, "overlap", NoiseID),
+		BinArgs: nil,
+	}
+	m[NoiseID] = overlapNoiseInfo
+
+	overlapAsyncInfo := app.Info{
+		Name: AsyncID,
+		Source: app.SourceCode{
+			URL: "file:///" + filepath.Join(overlapDir, overlapDir, AsyncID),
+		},
+		BinName: overlapAsyncBinName,
+		BinPath: filepath.Join(installDir, "overlap", AsyncID),
+		BinArgs: nil,
+	}
+	m[AsyncID] = overlapAsyncInfo
+
+	overlapPipelineInfo := app.Info{
+		Name: PipelineID,
+		Source: app.SourceCode{
+			URL: "file:///" + filepath.Join(overlapDir, overlapDir, PipelineID),
+		},
+		BinName: overlapPipelineBinName,
+		BinPath: filepath.Join(installDir, "overlap", PipelineID),
+		BinArgs: nil,
+	}
+	m[PipelineID] = overlapPipelineInfo
+
+	overlapDLTrainInfo := app.Info{
+		Name: DLTrainID,
+		Source: app.SourceCode{
+			URL: "file:///" + filepath.Join(overlapDir, overlapDir, DLTrainID),
+		},
+		BinName: overlapDLTrainBinName,
+		BinPath: filepath.Join(installDir, "overlap", DLTrainID),
+		BinArgs: nil,
+	}
+	m[DLTrainID] = overlapDLTrainInfo
+
+	overlapPCGInfo := app.Info{
+		Name: PCGID,
+		Source: app.SourceCode{
+			URL: "file:///" + filepath.Join(overlapDir, overlapDir, PCGID),
+		},
+		BinName: overlapPCGBinName,
+		BinPath: filepath.Join(installDir, "overlap", PCGID),
+		BinArgs: nil,
+	}
+	m[PCGID] = overlapPCGInfo
+
 	return m
 }
 
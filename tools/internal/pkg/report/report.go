@@ -15,6 +15,7 @@ import (
 	"time"
 
 	"github.com/openucx/openhpca/tools/internal/pkg/config"
+	"github.com/openucx/openhpca/tools/internal/pkg/result"
 	"github.com/openucx/openhpca/tools/internal/pkg/runErrors"
 )
 
@@ -176,6 +177,22 @@ func analyzeRunErrors(cfg *config.Data, reportFile *os.File) error {
 	return nil
 }
 
+func addApplicationOverlap(cfg *config.Data, reportFile *os.File) error {
+	summary, err := result.LoadPMPISummary(filepath.Join(cfg.GetRunDir(), result.PMPISummaryFileName))
+	if err != nil {
+		return err
+	}
+	if summary == nil {
+		return nil
+	}
+
+	_, err = reportFile.Write([]byte(fmt.Sprintf("# Application overlap\n\n%s\n", summary.ToString())))
+	if err != nil {
+		return fmt.Errorf("unable to write the application overlap: %w", err)
+	}
+	return nil
+}
+
 func Generate(cfg *config.Data) error {
 	reportFilePath := filepath.Join(cfg.WP.Basedir, "report.md")
 	if cfg.UserParams.Set {
@@ -204,6 +221,11 @@ func Generate(cfg *config.Data) error {
 		return fmt.Errorf("unable to analyze the run errors: %w", err)
 	}
 
+	err = addApplicationOverlap(cfg, reportFile)
+	if err != nil {
+		return fmt.Errorf("unable to add the application overlap: %w", err)
+	}
+
 	fmt.Printf("Successfully create %s\n", reportFilePath)
 
 	return nil
@@ -7,9 +7,11 @@
 package result
 
 import (
+	"encoding/json"
 	"fmt"
 	"io/ioutil"
 	"log"
+	"os"
 	"path/filepath"
 	"strconv"
 	"strings"
@@ -49,6 +51,28 @@ type Data struct {
 	OverlapData         map[string][]string
 	OverlapScore        float32
 	OverlapDetails      map[string]float32
+	// ComputeInflation is the slowdown of the computation with the communication in flight, in percent, for every
+	// overlap benchmark that measured it
+	ComputeInflation map[string]float32
+	// PMPI is the overlap measured in applications by libopenhpca_pmpi.so, nil if no summary is available
+	PMPI *PMPISummary
+	// Noise is the OS noise measured by the overlap_noise benchmark, nil if the benchmark was not run
+	Noise *NoiseRecord
+	// NoiseFlags gives, for every overlap benchmark whose result may be distorted by the OS noise of the run, the
+	// reason why; empty if the noise benchmark was not run
+	NoiseFlags map[string]string
+	// Async is the latency cost of the non-blocking operations measured by the overlap_async benchmark, nil if the
+	// benchmark was not run
+	Async *AsyncRecord
+	// Pipeline is the best chunking of the collective operations measured by the overlap_pipeline benchmark, nil if
+	// the benchmark was not run
+	Pipeline *PipelineRecord
+	// DLTrain is the step time of the data-parallel training pattern measured by the overlap_dltrain benchmark, nil if
+	// the benchmark was not run
+	DLTrain *DLTrainRecord
+	// PCG is the hidden reduction latency of the pipelined conjugate gradient pattern measured by the overlap_pcg
+	// benchmark, nil if the benchmark was not run
+	PCG *PCGRecord
 }
 
 func (r *Data) GetSMBOverlap() (float32, error) {
@@ -296,10 +320,43 @@ func Get(dir string) (*Data, error) {
 	}
 
 	r.OverlapData = r.GetOverlapData()
+	r.Noise, err = ParseNoiseRecord(r.OverlapData[overlap.NoiseID])
+	if err != nil {
+		return nil, err
+	}
+	r.Async, err = ParseAsyncRecord(r.OverlapData[overlap.AsyncID])
+	if err != nil {
+		return nil, err
+	}
+	r.Pipeline, err = ParsePipelineRecord(r.OverlapData[overlap.PipelineID])
+	if err != nil {
+		return nil, err
+	}
+	r.DLTrain, err = ParseDLTrainRecord(r.OverlapData[overlap.DLTrainID])
+	if err != nil {
+		return nil, err
+	}
+	r.PCG, err = ParsePCGRecord(r.OverlapData[overlap.PCGID])
+	if err != nil {
+		return nil, err
+	}
 	r.OverlapScore, r.OverlapDetails, err = ComputeOverlap(r.MpiOverhead, r.OverlapData)
 	if err != nil {
 		return nil, err
 	}
+	r.ComputeInflation, err = GetComputeInflation(r.OverlapData)
+	if err != nil {
+		return nil, err
+	}
+	r.NoiseFlags, err = GetNoiseFlags(r.Noise, r.OverlapData)
+	if err != nil {
+		return nil, err
+	}
+
+	r.PMPI, err = LoadPMPISummary(filepath.Join(r.resultsDir, PMPISummaryFileName))
+	if err != nil {
+		return nil, err
+	}
 
 	return r, nil
 }
@@ -358,6 +415,195 @@ func (r *Data) GetLatency() (float32, string, error) {
 	return 0, unit, fmt.Errorf("unable to find result file for latency")
 }
 
+// versionedRecord is a JSON record written by a benchmark, whose format is versioned
+type versionedRecord interface {
+	GetVersion() int
+}
+
+// parseRecord looks for the JSON record of the given format in the output of a benchmark and decodes it into dst. It
+// returns false if the output does not include any record, e.g., when the benchmark was not run or was an older
+// version.
+func parseRecord(output []string, format string, maxVersion int, dst versionedRecord) (bool, error) {
+	prefix := "{\"format\":\"" + format + "\""
+	for _, line := range output {
+		if !strings.HasPrefix(line, prefix) {
+			continue
+		}
+		err := json.Unmarshal([]byte(line), dst)
+		if err != nil {
+			return false, fmt.Errorf("unable to parse %s record: %w", format, err)
+		}
+		if dst.GetVersion() > maxVersion {
+			return false, fmt.Errorf("unsupported %s record version: %d (max supported: %d)", format, dst.GetVersion(), maxVersion)
+		}
+		return true, nil
+	}
+	return false, nil
+}
+
+// OverlapRecordFormat and OverlapRecordVersion identify the JSON record written by the overlap benchmarks
+const (
+	OverlapRecordFormat  = "openhpca_overlap"
+	OverlapRecordVersion = 1
+)
+
+// OverlapSearchStep is a step of the search of the size matching the cutoff time
+type OverlapSearchStep struct {
+	NumElts uint64  `json:"n_elts"`
+	Time    float64 `json:"time"`
+}
+
+// OverlapResult is the overlap for a given configuration; times are in milliseconds and are nil when unknown
+type OverlapResult struct {
+	NumElts     uint64             `json:"n_elts"`
+	DataSize    uint64             `json:"data_size"`
+	NumIters    int                `json:"n_iters"`
+	RefTime     *float64           `json:"ref_time"`
+	Stdev       *float64           `json:"stdev"`
+	WorkTime    *float64           `json:"work_time"`
+	WaitTime    *float64           `json:"wait_time"`
+	Overlap     *float64           `json:"overlap"`
+	Completed   bool               `json:"completed"`
+	Root        int                `json:"root"`
+	Skew        int                `json:"skew"`
+	Comm        string             `json:"comm"`
+	CommSize    int                `json:"comm_size"`
+	ReduceType  string             `json:"reduce_type,omitempty"`
+	ReduceOp    string             `json:"reduce_op,omitempty"`
+	Pvars       map[string]float64 `json:"pvars,omitempty"`
+	CvarSetting string             `json:"cvar_setting,omitempty"`
+	// Slowdown of the computation with the communication in flight in percent, nil when not measured
+	ComputeInflation        *float64 `json:"compute_inflation,omitempty"`
+	MaxComputeInflation     *float64 `json:"max_compute_inflation,omitempty"`
+	MaxComputeInflationRank int      `json:"max_compute_inflation_rank,omitempty"`
+	// Work units per milli-second of the slowest and fastest ranks, nil when the work was not calibrated per rank
+	WorkRateMin    *float64 `json:"work_rate_min,omitempty"`
+	WorkRateMax    *float64 `json:"work_rate_max,omitempty"`
+	WorkRateSpread *float64 `json:"work_rate_spread,omitempty"`
+	SlowestRank    int      `json:"slowest_rank,omitempty"`
+	// Completion time across the ranks in milliseconds with window-based synchronization, nil otherwise
+	CompletionTime *float64 `json:"completion_time,omitempty"`
+}
+
+// OverlapComm is the overlap reported for a communicator other than MPI_COMM_WORLD, e.g., the ranks of a node
+type OverlapComm struct {
+	Comm     string   `json:"comm"`
+	CommSize int      `json:"comm_size"`
+	Overlap  *float64 `json:"overlap"`
+}
+
+// OverlapReduction is the overlap reported for a reduction with a datatype and an operation other than MPI_DOUBLE and
+// MPI_SUM
+type OverlapReduction struct {
+	ReduceType string   `json:"reduce_type"`
+	ReduceOp   string   `json:"reduce_op"`
+	Overlap    *float64 `json:"overlap"`
+}
+
+// OverlapCvarSetting is the overlap reported for a setting of the MPI_T control variables, e.g., a collective algorithm
+type OverlapCvarSetting struct {
+	Setting string   `json:"setting"`
+	Overlap *float64 `json:"overlap"`
+}
+
+// OverlapProbe is the evaluation of a given amount of injected work during the search of the overlap; the work is in
+// nano-seconds under the time driven model and in work units under the data driven model
+type OverlapProbe struct {
+	Result          int      `json:"result"`
+	NumElts         uint64   `json:"n_elts"`
+	Root            int      `json:"root"`
+	Skew            int      `json:"skew"`
+	Work            int64    `json:"work"`
+	Time            *float64 `json:"time"`
+	Threshold       *float64 `json:"threshold"`
+	Passed          bool     `json:"passed"`
+	ValidationCount int      `json:"validation_count"`
+}
+
+// OverlapRecord is the machine-readable output of an overlap benchmark
+type OverlapRecord struct {
+	Format       string                 `json:"format"`
+	Version      int                    `json:"version"`
+	Benchmark    string                 `json:"benchmark"`
+	Model        string                 `json:"model"`
+	WorldSize    int                    `json:"world_size"`
+	Params       map[string]interface{} `json:"params"`
+	SizeSearch   []OverlapSearchStep    `json:"size_search"`
+	Results      []OverlapResult        `json:"results"`
+	Probes       []OverlapProbe         `json:"probes"`
+	Comms        []OverlapComm          `json:"comms"`
+	Reductions   []OverlapReduction     `json:"reductions"`
+	CvarSettings []OverlapCvarSetting   `json:"cvar_settings"`
+	Overlap      *float64               `json:"overlap"`
+	// ComputeInflation is the slowdown of the computation, in percent, with the final result; nil when not measured
+	ComputeInflation *float64 `json:"compute_inflation"`
+}
+
+// ParseOverlapRecord looks for the JSON record in the output of an overlap benchmark. It returns nil if the output
+// does not include any record, e.g., when it was generated by an older version of the benchmarks.
+func ParseOverlapRecord(output []string) (*OverlapRecord, error) {
+	record := new(OverlapRecord)
+	found, err := parseRecord(output, OverlapRecordFormat, OverlapRecordVersion, record)
+	if err != nil || !found {
+		return nil, err
+	}
+	return record, nil
+}
+
+// GetVersion returns the version of the format of the record
+func (r *OverlapRecord) GetVersion() int {
+	return r.Version
+}
+
+// GetPreviousOverlapSizes returns the number of elements picked by the size search of every overlap benchmark of the
+// run whose results are in dir, indexed by the name of the benchmark. Benchmarks that did not search for a size, e.g.,
+// with a sweep, or that did not write a record are not in the map; so is everything when dir does not hold any
+// result yet.
+func GetPreviousOverlapSizes(dir string) map[string]uint64 {
+	sizes := make(map[string]uint64)
+	labels := make(map[string]string)
+	err := label.FromFile(label.GetFilePath(dir), labels)
+	if err != nil {
+		return sizes
+	}
+	outputFiles, err := util.GetOutputFiles(dir)
+	if err != nil {
+		return sizes
+	}
+	for hash, expLabel := range labels {
+		if !strings.HasPrefix(expLabel, "overlap") || outputFiles[hash] == "" {
+			continue
+		}
+		content, err := ioutil.ReadFile(filepath.Join(dir, outputFiles[hash]))
+		if err != nil {
+			continue
+		}
+		record, err := ParseOverlapRecord(strings.Split(string(content), "\n"))
+		if err != nil || record == nil || len(record.SizeSearch) == 0 || len(record.Results) == 0 {
+			continue
+		}
+		sizes[strings.ReplaceAll(expLabel, "overlap_overlap_", "overlap_")] = record.Results[0].NumElts
+	}
+	return sizes
+}
+
+// parseOverlapLine extracts the overlap from the "Overlap: " line of the text output of the benchmarks
+func parseOverlapLine(output []string) (float32, bool, error) {
+	for _, line := range output {
+		if strings.HasPrefix(line, "Overlap: ") {
+			line = strings.TrimPrefix(line, "Overlap: ")
+			line = strings.TrimRight(line, "\n")
+			line = strings.TrimSuffix(line, " %")
+			value, err := strconv.ParseFloat(line, 32)
+			if err != nil {
+				return 0, false, err
+			}
+			return float32(value), true, nil
+		}
+	}
+	return 0, false, nil
+}
+
 func ComputeOverlap(smbMPIOverhead float32, overlapData map[string][]string) (float32, map[string]float32, error) {
 	numBenchs := len(overlapData)
 	skipped := 0
@@ -372,20 +618,34 @@ func ComputeOverlap(smbMPIOverhead float32, overlapData map[string][]string) (fl
 			skipped++
 			continue
 		}
+		if benchName == overlap.NoiseID || benchName == overlap.AsyncID || benchName == overlap.PipelineID ||
+			benchName == overlap.DLTrainID || benchName == overlap.PCGID {
+			// The noise, asynchrony and pattern benchmarks do not measure the overlap of a single operation, their
+			// results are reported separately
+			skipped++
+			continue
+		}
 		overlapDetails[benchName] = 0.0
-		for _, line := range output {
-			if strings.HasPrefix(line, "Overlap: ") {
-				line = strings.TrimPrefix(line, "Overlap: ")
-				line = strings.TrimRight(line, "\n")
-				line = strings.TrimSuffix(line, " %")
-				value, err := strconv.ParseFloat(line, 32)
-				if err != nil {
-					return 0, nil, err
-				}
-				overlapDetails[benchName] = float32(value)
-				finalOverlap += float32(value)
-				break
+		record, err := ParseOverlapRecord(output)
+		if err != nil {
+			return 0, nil, err
+		}
+		if record != nil {
+			if record.Overlap != nil {
+				overlapDetails[benchName] = float32(*record.Overlap)
+				finalOverlap += float32(*record.Overlap)
 			}
+			continue
+		}
+
+		// Output generated by a version of the benchmarks without structured output
+		value, found, err := parseOverlapLine(output)
+		if err != nil {
+			return 0, nil, err
+		}
+		if found {
+			overlapDetails[benchName] = value
+			finalOverlap += value
 		}
 	}
 	if smbMPIOverhead < 0 {
@@ -410,3 +670,427 @@ func ComputeOverlap(smbMPIOverhead float32, overlapData map[string][]string) (fl
 	numBenchs += added
 	return finalOverlap / float32(numBenchs+1), overlapDetails, nil
 }
+
+// GetComputeInflation returns the compute inflation reported by the overlap benchmarks. The inflation does not
+// change the overlap score: a collective that overlaps 100% but slows down the computation is not free, which is
+// reported next to the score instead.
+func GetComputeInflation(overlapData map[string][]string) (map[string]float32, error) {
+	inflation := make(map[string]float32)
+	for benchName, output := range overlapData {
+		record, err := ParseOverlapRecord(output)
+		if err != nil {
+			return nil, err
+		}
+		if record != nil && record.ComputeInflation != nil {
+			inflation[benchName] = float32(*record.ComputeInflation)
+		}
+	}
+	return inflation, nil
+}
+
+const (
+	PMPISummaryFormat   = "openhpca_pmpi"
+	PMPISummaryVersion  = 1
+	PMPISummaryFileName = "openhpca_pmpi.json"
+)
+
+// PMPICall gathers the measurements of libopenhpca_pmpi.so for a call site, operation and communicator. Times are
+// averages per operation in milli-seconds.
+type PMPICall struct {
+	Site     string   `json:"site"`
+	Op       string   `json:"operation"`
+	Comm     string   `json:"comm"`
+	CommSize int      `json:"comm_size"`
+	Count    uint64   `json:"count"`
+	PostTime float64  `json:"post_time"`
+	GapTime  float64  `json:"gap_time"`
+	WaitTime float64  `json:"wait_time"`
+	Overlap  *float64 `json:"overlap"`
+}
+
+// PMPISummary is the summary written by libopenhpca_pmpi.so at the end of an application
+type PMPISummary struct {
+	Format    string     `json:"format"`
+	Version   int        `json:"version"`
+	WorldSize int        `json:"world_size"`
+	Dropped   uint64     `json:"dropped"`
+	Calls     []PMPICall `json:"calls"`
+}
+
+// LoadPMPISummary reads a summary written by libopenhpca_pmpi.so. It returns nil if the file does not exist, i.e.,
+// when no application was run with the library.
+func LoadPMPISummary(path string) (*PMPISummary, error) {
+	content, err := ioutil.ReadFile(path)
+	if err != nil {
+		if os.IsNotExist(err) {
+			return nil, nil
+		}
+		return nil, fmt.Errorf("unable to read %s: %w", path, err)
+	}
+	summary := new(PMPISummary)
+	err = json.Unmarshal(content, summary)
+	if err != nil {
+		return nil, fmt.Errorf("unable to parse %s: %w", path, err)
+	}
+	if summary.Format != PMPISummaryFormat {
+		return nil, fmt.Errorf("%s is not a PMPI summary", path)
+	}
+	if summary.Version > PMPISummaryVersion {
+		return nil, fmt.Errorf("unsupported PMPI summary version: %d (max supported: %d)", summary.Version, PMPISummaryVersion)
+	}
+	return summary, nil
+}
+
+// ToString returns a human-readable table of the measurements of the summary
+func (s *PMPISummary) ToString() string {
+	content := fmt.Sprintf("Application overlap (%d ranks):\n", s.WorldSize)
+	for _, call := range s.Calls {
+		overlap := "N/A"
+		if call.Overlap != nil {
+			overlap = fmt.Sprintf("%.1f %%", *call.Overlap)
+		}
+		content += fmt.Sprintf("\t- %s at %s on %s (%d ranks): %d calls, post %.3f ms, compute %.3f ms, wait %.3f ms, overlap %s\n",
+			call.Op, call.Site, call.Comm, call.CommSize, call.Count, call.PostTime, call.GapTime, call.WaitTime, overlap)
+	}
+	if s.Dropped > 0 {
+		content += fmt.Sprintf("\t- %d operations could not be tracked\n", s.Dropped)
+	}
+	return content
+}
+
+const (
+	NoiseRecordFormat  = "openhpca_noise"
+	NoiseRecordVersion = 1
+)
+
+// NoiseNode is the noise measured on a node by the overlap_noise benchmark. Times are the times of a quantum of work
+// in micro-seconds and the noise is in percent.
+type NoiseNode struct {
+	Node         string   `json:"node"`
+	NumRanks     int      `json:"n_ranks"`
+	MinTime      float64  `json:"min_time"`
+	MeanTime     float64  `json:"mean_time"`
+	MaxTime      float64  `json:"max_time"`
+	Noise        float64  `json:"noise"`
+	MaxNoise     float64  `json:"max_noise"`
+	NoisiestRank int      `json:"noisiest_rank"`
+	Histogram    []uint64 `json:"histogram"`
+	Noisy        bool     `json:"noisy"`
+}
+
+// NoiseRecord is the machine-readable output of the overlap_noise benchmark
+type NoiseRecord struct {
+	Format     string                 `json:"format"`
+	Version    int                    `json:"version"`
+	Benchmark  string                 `json:"benchmark"`
+	WorldSize  int                    `json:"world_size"`
+	Params     map[string]interface{} `json:"params"`
+	Bins       []float64              `json:"bins"`
+	Nodes      []NoiseNode            `json:"nodes"`
+	NoisyNodes []string               `json:"noisy_nodes"`
+	Noise      float64                `json:"noise"`
+}
+
+// ParseNoiseRecord looks for the JSON record in the output of the overlap_noise benchmark. It returns nil if the
+// output does not include any record, e.g., when the benchmark was not run.
+func ParseNoiseRecord(output []string) (*NoiseRecord, error) {
+	record := new(NoiseRecord)
+	found, err := parseRecord(output, NoiseRecordFormat, NoiseRecordVersion, record)
+	if err != nil || !found {
+		return nil, err
+	}
+	return record, nil
+}
+
+// GetVersion returns the version of the format of the record
+func (r *NoiseRecord) GetVersion() int {
+	return r.Version
+}
+
+// Amplitude returns the highest average noise of a rank across the nodes, in percent
+func (n *NoiseRecord) Amplitude() float64 {
+	amplitude := 0.0
+	for _, node := range n.Nodes {
+		if node.MaxNoise > amplitude {
+			amplitude = node.MaxNoise
+		}
+	}
+	return amplitude
+}
+
+// GetNoiseFlags flags the overlap benchmarks whose result may be distorted by the OS noise measured by the
+// overlap_noise benchmark of the same run. The overlap verdicts accept the probes up to the reference time plus its
+// standard deviation: a result is flagged when the run included noisy nodes, or when the noise amplitude is at least
+// the relative standard deviation of the reference time of the reported result, since the noise alone can then flip
+// the verdicts. Like the compute inflation, the flags do not change the overlap score.
+func GetNoiseFlags(noise *NoiseRecord, overlapData map[string][]string) (map[string]string, error) {
+	flags := make(map[string]string)
+	if noise == nil {
+		return flags, nil
+	}
+	amplitude := noise.Amplitude()
+	for benchName, output := range overlapData {
+		record, err := ParseOverlapRecord(output)
+		if err != nil {
+			return nil, err
+		}
+		if record == nil || record.Overlap == nil {
+			continue
+		}
+		if len(noise.NoisyNodes) > 0 {
+			flags[benchName] = "noisy nodes: " + strings.Join(noise.NoisyNodes, ", ")
+			continue
+		}
+		for _, res := range record.Results {
+			if res.Overlap == nil || *res.Overlap != *record.Overlap || res.RefTime == nil || res.Stdev == nil || *res.RefTime <= 0 {
+				continue
+			}
+			variation := *res.Stdev * 100 / *res.RefTime
+			if amplitude >= variation {
+				flags[benchName] = fmt.Sprintf("noise of %.1f %% above the variation of %.1f %% of the reference time", amplitude, variation)
+			}
+			break
+		}
+	}
+	return flags, nil
+}
+
+// ToString returns a human-readable summary of the noise of the nodes
+func (n *NoiseRecord) ToString() string {
+	content := fmt.Sprintf("OS noise: %.3f %%\n", n.Noise)
+	for _, node := range n.Nodes {
+		noisy := ""
+		if node.Noisy {
+			noisy = " (noisy)"
+		}
+		content += fmt.Sprintf("\t- %s (%d ranks): noise %.3f %%, max %.1f %% on rank %d%s\n", node.Node, node.NumRanks,
+			node.Noise, node.MaxNoise, node.NoisiestRank, noisy)
+	}
+	return content
+}
+
+const (
+	AsyncRecordFormat  = "openhpca_async"
+	AsyncRecordVersion = 1
+)
+
+// AsyncResult is the latency of an operation and a size in its blocking, non-blocking and persistent forms. Times are
+// in milliseconds, overheads are the latency increases compared to the blocking operation in percent, nil when the
+// persistent operations are not supported.
+type AsyncResult struct {
+	Op                  string   `json:"operation"`
+	NumElts             uint64   `json:"n_elts"`
+	DataSize            uint64   `json:"data_size"`
+	BlockingTime        *float64 `json:"blocking_time"`
+	NonblockingTime     *float64 `json:"nonblocking_time"`
+	PersistentTime      *float64 `json:"persistent_time"`
+	NonblockingOverhead *float64 `json:"nonblocking_overhead"`
+	PersistentOverhead  *float64 `json:"persistent_overhead"`
+}
+
+// AsyncRecord is the machine-readable output of the overlap_async benchmark. The overheads of the record are the
+// averages over the small messages, where latency dominates.
+type AsyncRecord struct {
+	Format              string                 `json:"format"`
+	Version             int                    `json:"version"`
+	Benchmark           string                 `json:"benchmark"`
+	WorldSize           int                    `json:"world_size"`
+	Params              map[string]interface{} `json:"params"`
+	Results             []AsyncResult          `json:"results"`
+	NonblockingOverhead *float64               `json:"nonblocking_overhead"`
+	PersistentOverhead  *float64               `json:"persistent_overhead"`
+}
+
+// ParseAsyncRecord looks for the JSON record in the output of the overlap_async benchmark. It returns nil if the
+// output does not include any record, e.g., when the benchmark was not run.
+func ParseAsyncRecord(output []string) (*AsyncRecord, error) {
+	record := new(AsyncRecord)
+	found, err := parseRecord(output, AsyncRecordFormat, AsyncRecordVersion, record)
+	if err != nil || !found {
+		return nil, err
+	}
+	return record, nil
+}
+
+// GetVersion returns the version of the format of the record
+func (r *AsyncRecord) GetVersion() int {
+	return r.Version
+}
+
+func formatOverhead(overhead *float64) string {
+	if overhead == nil {
+		return "N/A"
+	}
+	return fmt.Sprintf("%.1f %%", *overhead)
+}
+
+// ToString returns a human-readable summary of the cost of the non-blocking and persistent operations
+func (a *AsyncRecord) ToString() string {
+	content := fmt.Sprintf("Non-blocking overhead: %s\n", formatOverhead(a.NonblockingOverhead))
+	content += fmt.Sprintf("Persistent overhead: %s\n", formatOverhead(a.PersistentOverhead))
+	return content
+}
+
+const (
+	PipelineRecordFormat  = "openhpca_pipeline"
+	PipelineRecordVersion = 1
+)
+
+// PipelineResult is the end-to-end time of an operation split into a number of chunks, the computation on a chunk
+// overlapping the communication of the next one. Sizes are in bytes, the time in milliseconds and the speedup is
+// relative to the unchunked operation.
+type PipelineResult struct {
+	Op        string   `json:"operation"`
+	NumElts   uint64   `json:"n_elts"`
+	DataSize  uint64   `json:"data_size"`
+	Chunks    int      `json:"chunks"`
+	ChunkSize uint64   `json:"chunk_size"`
+	Time      *float64 `json:"time"`
+	Speedup   *float64 `json:"speedup"`
+}
+
+// PipelineBest is the fastest chunking of an operation and a size
+type PipelineBest struct {
+	Op        string   `json:"operation"`
+	DataSize  uint64   `json:"data_size"`
+	Chunks    int      `json:"chunks"`
+	ChunkSize uint64   `json:"chunk_size"`
+	Speedup   *float64 `json:"speedup"`
+}
+
+// PipelineRecord is the machine-readable output of the overlap_pipeline benchmark
+type PipelineRecord struct {
+	Format    string                 `json:"format"`
+	Version   int                    `json:"version"`
+	Benchmark string                 `json:"benchmark"`
+	WorldSize int                    `json:"world_size"`
+	Params    map[string]interface{} `json:"params"`
+	Results   []PipelineResult       `json:"results"`
+	Best      []PipelineBest         `json:"best"`
+}
+
+// ParsePipelineRecord looks for the JSON record in the output of the overlap_pipeline benchmark. It returns nil if the
+// output does not include any record, e.g., when the benchmark was not run.
+func ParsePipelineRecord(output []string) (*PipelineRecord, error) {
+	record := new(PipelineRecord)
+	found, err := parseRecord(output, PipelineRecordFormat, PipelineRecordVersion, record)
+	if err != nil || !found {
+		return nil, err
+	}
+	return record, nil
+}
+
+// GetVersion returns the version of the format of the record
+func (r *PipelineRecord) GetVersion() int {
+	return r.Version
+}
+
+// ToString returns a human-readable summary of the best chunking of every operation and size
+func (p *PipelineRecord) ToString() string {
+	content := "Best chunking:\n"
+	for _, best := range p.Best {
+		speedup := "N/A"
+		if best.Speedup != nil {
+			speedup = fmt.Sprintf("%.2f", *best.Speedup)
+		}
+		content += fmt.Sprintf("\t- %s of %d bytes: %d chunks of %d bytes (speedup: %s)\n", best.Op, best.DataSize,
+			best.Chunks, best.ChunkSize, speedup)
+	}
+	return content
+}
+
+const (
+	DLTrainRecordFormat  = "openhpca_dltrain"
+	DLTrainRecordVersion = 1
+)
+
+// DLTrainRecord is the machine-readable output of the overlap_dltrain benchmark. Times are in milliseconds, bucket
+// sizes in bytes and the hidden share of the communication in percent.
+type DLTrainRecord struct {
+	Format      string                 `json:"format"`
+	Version     int                    `json:"version"`
+	Benchmark   string                 `json:"benchmark"`
+	WorldSize   int                    `json:"world_size"`
+	Params      map[string]interface{} `json:"params"`
+	NumParams   int64                  `json:"n_params"`
+	Buckets     []int64                `json:"buckets"`
+	StepTime    float64                `json:"step_time"`
+	ComputeTime float64                `json:"compute_time"`
+	CommTime    float64                `json:"comm_time"`
+	ExposedTime float64                `json:"exposed_time"`
+	Hidden      float64                `json:"hidden"`
+}
+
+// ParseDLTrainRecord looks for the JSON record in the output of the overlap_dltrain benchmark. It returns nil if the
+// output does not include any record, e.g., when the benchmark was not run.
+func ParseDLTrainRecord(output []string) (*DLTrainRecord, error) {
+	record := new(DLTrainRecord)
+	found, err := parseRecord(output, DLTrainRecordFormat, DLTrainRecordVersion, record)
+	if err != nil || !found {
+		return nil, err
+	}
+	return record, nil
+}
+
+// GetVersion returns the version of the format of the record
+func (r *DLTrainRecord) GetVersion() int {
+	return r.Version
+}
+
+// ToString returns a human-readable summary of the data-parallel training pattern
+func (d *DLTrainRecord) ToString() string {
+	content := fmt.Sprintf("Data-parallel training (%v, %d buckets):\n", d.Params["model"], len(d.Buckets))
+	content += fmt.Sprintf("\t- Step time: %.3f ms\n", d.StepTime)
+	content += fmt.Sprintf("\t- Exposed communication time: %.3f ms\n", d.ExposedTime)
+	content += fmt.Sprintf("\t- Hidden communication: %.1f %%\n", d.Hidden)
+	return content
+}
+
+const (
+	PCGRecordFormat  = "openhpca_pcg"
+	PCGRecordVersion = 1
+)
+
+// PCGRecord is the machine-readable output of the overlap_pcg benchmark. Times are in milliseconds and the hidden
+// share of the reduction latency in percent.
+type PCGRecord struct {
+	Format                 string                 `json:"format"`
+	Version                int                    `json:"version"`
+	Benchmark              string                 `json:"benchmark"`
+	WorldSize              int                    `json:"world_size"`
+	Params                 map[string]interface{} `json:"params"`
+	Rows                   int64                  `json:"rows"`
+	NNZ                    int64                  `json:"nnz"`
+	Latency                float64                `json:"latency"`
+	BlockingIterTime       float64                `json:"blocking_iter_time"`
+	BlockingExposedLatency float64                `json:"blocking_exposed_latency"`
+	IterTime               float64                `json:"iter_time"`
+	ExposedLatency         float64                `json:"exposed_latency"`
+	Hidden                 float64                `json:"hidden"`
+	Residual               float64                `json:"residual"`
+}
+
+// ParsePCGRecord looks for the JSON record in the output of the overlap_pcg benchmark. It returns nil if the output
+// does not include any record, e.g., when the benchmark was not run.
+func ParsePCGRecord(output []string) (*PCGRecord, error) {
+	record := new(PCGRecord)
+	found, err := parseRecord(output, PCGRecordFormat, PCGRecordVersion, record)
+	if err != nil || !found {
+		return nil, err
+	}
+	return record, nil
+}
+
+// GetVersion returns the version of the format of the record
+func (r *PCGRecord) GetVersion() int {
+	return r.Version
+}
+
+// ToString returns a human-readable summary of the pipelined conjugate gradient pattern
+func (p *PCGRecord) ToString() string {
+	content := fmt.Sprintf("Pipelined conjugate gradient (%v^3 points per rank):\n", p.Params["size"])
+	content += fmt.Sprintf("\t- Iteration time: %.3f us (%.3f us without overlap)\n", p.IterTime*1e3, p.BlockingIterTime*1e3)
+	content += fmt.Sprintf("\t- Exposed reduction latency: %.3f us (%.3f us alone)\n", p.ExposedLatency*1e3, p.Latency*1e3)
+	content += fmt.Sprintf("\t- Hidden reduction latency: %.1f %%\n", p.Hidden)
+	return content
+}
@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2021, NVIDIA CORPORATION. All rights reserved.
+//
+// See LICENSE.txt for license information
+//
+
+package result
+
+import (
+	"math"
+	"testing"
+
+	"github.com/openucx/openhpca/tools/internal/pkg/overlap"
+)
+
+const (
+	testRecordOverlap     = `{"format":"openhpca_overlap","version":1,"benchmark":"overlap_iallreduce","model":"tdm","world_size":2,"params":{},"size_search":[],"results":[],"probes":[],"comms":[],"reductions":[],"cvar_settings":[],"overlap":40,"compute_inflation":null}`
+	testRecordNullOverlap = `{"format":"openhpca_overlap","version":1,"benchmark":"overlap_ireduce","model":"tdm","world_size":2,"params":{},"size_search":[],"results":[],"probes":[],"comms":[],"reductions":[],"cvar_settings":[],"overlap":null,"compute_inflation":null}`
+	testRecordTooNew      = `{"format":"openhpca_overlap","version":2,"benchmark":"overlap_iallreduce","model":"tdm","world_size":2,"overlap":40}`
+)
+
+func TestParseOverlapRecord(t *testing.T) {
+	tests := []struct {
+		output          []string
+		expectedRecord  bool
+		expectedOverlap *float64
+		expectedError   bool
+	}{
+		{
+			output:          []string{"Reference time: 1.0", testRecordOverlap, ""},
+			expectedRecord:  true,
+			expectedOverlap: func() *float64 { v := 40.0; return &v }(),
+		},
+		{
+			output:         []string{testRecordNullOverlap},
+			expectedRecord: true,
+		},
+		{
+			output:        []string{testRecordTooNew},
+			expectedError: true,
+		},
+		{
+			// Output of the benchmarks without structured output
+			output: []string{"Overlap: 20 %", ""},
+		},
+	}
+
+	for _, tt := range tests {
+		record, err := ParseOverlapRecord(tt.output)
+		if tt.expectedError {
+			if err == nil {
+				t.Fatalf("ParseOverlapRecord() succeeded with %v", tt.output)
+			}
+			continue
+		}
+		if err != nil {
+			t.Fatalf("ParseOverlapRecord() failed: %s", err)
+		}
+		if (record != nil) != tt.expectedRecord {
+			t.Fatalf("ParseOverlapRecord() returned %v with %v", record, tt.output)
+		}
+		if record == nil {
+			continue
+		}
+		if (record.Overlap == nil) != (tt.expectedOverlap == nil) {
+			t.Fatalf("ParseOverlapRecord() returned overlap %v instead of %v", record.Overlap, tt.expectedOverlap)
+		}
+		if record.Overlap != nil && *record.Overlap != *tt.expectedOverlap {
+			t.Fatalf("ParseOverlapRecord() returned overlap %f instead of %f", *record.Overlap, *tt.expectedOverlap)
+		}
+	}
+}
+
+func TestComputeOverlap(t *testing.T) {
+	tests := []struct {
+		overlapData     map[string][]string
+		smbMPIOverhead  float32
+		expectedScore   float32
+		expectedDetails map[string]float32
+		expectedError   bool
+	}{
+		{
+			overlapData: map[string][]string{
+				"overlap_iallreduce": {testRecordOverlap},
+				"overlap_ireduce":    {testRecordNullOverlap},
+				"overlap_ibcast":     {"Overlap: 20 %", ""},
+				// Neither ibarrier nor the pattern benchmarks count, whatever their output
+				"overlap_ibarrier": {"Overlap: 100 %"},
+				overlap.NoiseID:    {"Overlap: 100 %"},
+				overlap.AsyncID:    {"Overlap: 100 %"},
+				overlap.PipelineID: {"Overlap: 100 %"},
+				overlap.DLTrainID:  {"Overlap: 100 %"},
+				overlap.PCGID:      {"Overlap: 100 %"},
+			},
+			smbMPIOverhead: 10,
+			// The sub-benchmarks without results, ibarrier included, count as 0, SMB counts as one more benchmark
+			expectedScore: (40 + 0 + 20 + 10) / float32(len(overlap.GetListSubBenchmarks())+1),
+			expectedDetails: map[string]float32{
+				"overlap_iallreduce": 40,
+				"overlap_ireduce":    0,
+				"overlap_ibcast":     20,
+				"overlap_ibarrier":   0,
+				"SMB mpi_overhead":   10,
+			},
+		},
+		{
+			overlapData: map[string][]string{
+				"overlap_iallreduce": {testRecordTooNew},
+			},
+			expectedError: true,
+		},
+		{
+			overlapData: map[string][]string{
+				"overlap_iallreduce": {"Overlap: not a number %"},
+			},
+			expectedError: true,
+		},
+	}
+
+	for _, tt := range tests {
+		score, details, err := ComputeOverlap(tt.smbMPIOverhead, tt.overlapData)
+		if tt.expectedError {
+			if err == nil {
+				t.Fatalf("ComputeOverlap() succeeded with %v", tt.overlapData)
+			}
+			continue
+		}
+		if err != nil {
+			t.Fatalf("ComputeOverlap() failed: %s", err)
+		}
+		if math.Abs(float64(score-tt.expectedScore)) > 1e-4 {
+			t.Fatalf("ComputeOverlap() returned %f instead of %f", score, tt.expectedScore)
+		}
+		for benchName, expected := range tt.expectedDetails {
+			value, ok := details[benchName]
+			if !ok || value != expected {
+				t.Fatalf("ComputeOverlap() returned %f for %s instead of %f", value, benchName, expected)
+			}
+		}
+		for _, benchName := range []string{overlap.NoiseID, overlap.AsyncID, overlap.PipelineID, overlap.DLTrainID, overlap.PCGID} {
+			if _, ok := details[benchName]; ok {
+				t.Fatalf("ComputeOverlap() included %s in the overlap score", benchName)
+			}
+		}
+	}
+}
+
+func TestGetNoiseFlags(t *testing.T) {
+	const (
+		testRecordQuiet  = `{"format":"openhpca_overlap","version":1,"benchmark":"overlap_iallreduce","model":"tdm","world_size":2,"results":[{"n_elts":1024,"ref_time":10,"stdev":2,"overlap":40}],"overlap":40}`
+		testRecordSteady = `{"format":"openhpca_overlap","version":1,"benchmark":"overlap_ibcast","model":"tdm","world_size":2,"results":[{"n_elts":1024,"ref_time":10,"stdev":0.1,"overlap":30}],"overlap":30}`
+	)
+	overlapData := map[string][]string{
+		"overlap_iallreduce": {testRecordQuiet},
+		"overlap_ibcast":     {testRecordSteady},
+		"overlap_ireduce":    {testRecordNullOverlap},
+	}
+	tests := []struct {
+		noise           *NoiseRecord
+		expectedFlagged []string
+	}{
+		{
+			noise: nil,
+		},
+		{
+			// 5% of noise is below the 20% deviation of iallreduce but above the 1% of ibcast
+			noise:           &NoiseRecord{Nodes: []NoiseNode{{Node: "node1", MaxNoise: 0.5}, {Node: "node2", MaxNoise: 5}}},
+			expectedFlagged: []string{"overlap_ibcast"},
+		},
+		{
+			noise:           &NoiseRecord{Nodes: []NoiseNode{{Node: "node1", MaxNoise: 0.01}}, NoisyNodes: []string{"node1"}},
+			expectedFlagged: []string{"overlap_iallreduce", "overlap_ibcast"},
+		},
+	}
+
+	for _, tt := range tests {
+		flags, err := GetNoiseFlags(tt.noise, overlapData)
+		if err != nil {
+			t.Fatalf("GetNoiseFlags() failed: %s", err)
+		}
+		if len(flags) != len(tt.expectedFlagged) {
+			t.Fatalf("GetNoiseFlags() returned %v instead of flagging %v", flags, tt.expectedFlagged)
+		}
+		for _, benchName := range tt.expectedFlagged {
+			if flags[benchName] == "" {
+				t.Fatalf("GetNoiseFlags() did not flag %s: %v", benchName, flags)
+			}
+		}
+	}
+}
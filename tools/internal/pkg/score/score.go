@@ -30,6 +30,15 @@ type Metrics struct {
 	OverlapData    map[string][]string
 	OverlapScore   float32
 	OverlapDetails map[string]float32
+	// ComputeInflation is the slowdown of the computation with the communication in flight, per overlap benchmark
+	ComputeInflation map[string]float32
+	Noise            *result.NoiseRecord
+	// NoiseFlags is the reason why the OS noise may distort the result, per overlap benchmark
+	NoiseFlags map[string]string
+	Async      *result.AsyncRecord
+	Pipeline   *result.PipelineRecord
+	DLTrain    *result.DLTrainRecord
+	PCG        *result.PCGRecord
 }
 
 func Compute(dataDir string) (*Metrics, error) {
@@ -48,6 +57,13 @@ func Compute(dataDir string) (*Metrics, error) {
 	metrics.Latency = float64(data.Latency)
 	metrics.LatencyUnit = data.LatencyUnit
 	metrics.OverlapScore = data.MpiOverhead
+	metrics.ComputeInflation = data.ComputeInflation
+	metrics.Noise = data.Noise
+	metrics.NoiseFlags = data.NoiseFlags
+	metrics.Async = data.Async
+	metrics.Pipeline = data.Pipeline
+	metrics.DLTrain = data.DLTrain
+	metrics.PCG = data.PCG
 
 	if data.BandwidthUnit != "Gb/s" {
 		return nil, fmt.Errorf("unsupported unit for bandwidth (%s)", data.BandwidthUnit)
@@ -72,6 +88,32 @@ func (s *Metrics) ToString() string {
 		content += "\n"
 	}
 	content += "\n"
+	if len(s.ComputeInflation) > 0 {
+		content += "Compute inflation:\n"
+		for benchmarkName, inflation := range s.ComputeInflation {
+			content += fmt.Sprintf("\t- %s: %.1f %%\n", benchmarkName, inflation)
+		}
+		content += "\n"
+	}
+	if s.Noise != nil {
+		content += s.Noise.ToString()
+		for benchmarkName, flag := range s.NoiseFlags {
+			content += fmt.Sprintf("\t- %s possibly distorted by the noise (%s)\n", benchmarkName, flag)
+		}
+		content += "\n"
+	}
+	if s.Async != nil {
+		content += s.Async.ToString() + "\n"
+	}
+	if s.Pipeline != nil {
+		content += s.Pipeline.ToString() + "\n"
+	}
+	if s.DLTrain != nil {
+		content += s.DLTrain.ToString() + "\n"
+	}
+	if s.PCG != nil {
+		content += s.PCG.ToString() + "\n"
+	}
 	//content += fmt.Sprintf("Score: %d\n", s.Score)
 	return content
 }
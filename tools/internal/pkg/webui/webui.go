@@ -12,6 +12,7 @@ import (
 	"os"
 	"path/filepath"
 	"runtime"
+	"strings"
 	"sync"
 	"text/template"
 
@@ -44,6 +45,14 @@ type indexPageData struct {
 	LatencyUnit    string
 	OverlapData    map[string][]string
 	OverlapDetails map[string]float32
+	Inflation      map[string]float32
+	PMPI           *result.PMPISummary
+	Noise          *result.NoiseRecord
+	NoiseFlags     map[string]string
+	Async          *result.AsyncRecord
+	Pipeline       *result.PipelineRecord
+	DLTrain        *result.DLTrainRecord
+	PCG            *result.PCGRecord
 	ScratchPath    string
 	Score          int
 }
@@ -121,6 +130,10 @@ func (c *Config) newServer() *Server {
 				for _, line := range results {
 					content += line + "<br/>\n"
 				}
+				plotPath := filepath.Join(scratchPath, subbenchmark+"_convergence.png")
+				if util.FileExists(plotPath) {
+					content += "<img src=\"images/" + subbenchmark + "_convergence.png\" />\n"
+				}
 				content += "</div>\n"
 			}
 			return content
@@ -145,7 +158,7 @@ func (c *Config) newServer() *Server {
 
 			return content
 		},
-		"getResultMainDetails": func(osuData map[string][]string, overlapDetails map[string]float32, overlapScore string, scratchPath string) string {
+		"getResultMainDetails": func(osuData map[string][]string, overlapDetails map[string]float32, overlapScore string, inflation map[string]float32, noise *result.NoiseRecord, noiseFlags map[string]string, async *result.AsyncRecord, pipeline *result.PipelineRecord, dltrain *result.DLTrainRecord, pcg *result.PCGRecord, scratchPath string) string {
 			content := ""
 			for subbenchmark, results := range osuData {
 				if subbenchmark == bwMetricID || subbenchmark == latencyMetricID {
@@ -163,7 +176,69 @@ func (c *Config) newServer() *Server {
 			content += "<div id =\"overlap\" class=\"tabcontent\">"
 			content += fmt.Sprintf("Overlap score: %s %% <br/><br/>Details:<br/>", overlapScore)
 			for name, score := range overlapDetails {
-				content += fmt.Sprintf("%s score: %.1f</br>\n", name, score)
+				flag := ""
+				if noiseFlags[name] != "" {
+					flag = " (possibly distorted by the noise: " + template.HTMLEscapeString(noiseFlags[name]) + ")"
+				}
+				content += fmt.Sprintf("%s score: %.1f%s</br>\n", name, score, flag)
+			}
+			if len(inflation) > 0 {
+				// How much the communication in flight slows down the computation, which the overlap does not show
+				content += "<br/>Compute inflation:<br/>\n"
+				for name, value := range inflation {
+					content += fmt.Sprintf("%s: %.1f %%</br>\n", name, value)
+				}
+			}
+			if noise != nil {
+				content += fmt.Sprintf("<br/>OS noise: %.3f %%<br/>\n", noise.Noise)
+				noisyNodes := "none"
+				if len(noise.NoisyNodes) > 0 {
+					noisyNodes = template.HTMLEscapeString(strings.Join(noise.NoisyNodes, ", "))
+				}
+				content += "Noisy nodes: " + noisyNodes + "<br/>\n"
+			}
+			if async != nil {
+				// The overlap has to make up for the latency of the non-blocking operations
+				content += "<br/>" + strings.ReplaceAll(async.ToString(), "\n", "<br/>\n")
+			}
+			if pipeline != nil {
+				content += "<br/>" + strings.ReplaceAll(pipeline.ToString(), "\n", "<br/>\n")
+			}
+			if dltrain != nil {
+				content += "<br/>" + strings.ReplaceAll(dltrain.ToString(), "\n", "<br/>\n")
+			}
+			if pcg != nil {
+				content += "<br/>" + strings.ReplaceAll(pcg.ToString(), "\n", "<br/>\n")
+			}
+			content += "</div>"
+			return content
+		},
+		"getListApplicationResults": func(pmpi *result.PMPISummary) string {
+			if pmpi == nil {
+				return ""
+			}
+			content := "\t\t\t\t<input type=\"radio\" name=\"operation\" class=\"tablinks\" value=\"applications\" onclick=\"openTab(event, 'applications')\"/>\n"
+			content += "\t\t\t\t<label for=\"applications\">Applications</label><br/>\n"
+			return content
+		},
+		"getApplicationDetails": func(pmpi *result.PMPISummary) string {
+			if pmpi == nil {
+				return ""
+			}
+			content := "<div id=\"applications\" class=\"tabcontent\">"
+			content += fmt.Sprintf("Overlap measured in applications (%d ranks):<br/><br/>\n", pmpi.WorldSize)
+			content += "<table><tr><th>Operation</th><th>Call site</th><th>Communicator</th><th>Calls</th><th>Post (ms)</th><th>Compute (ms)</th><th>Wait (ms)</th><th>Overlap (%)</th></tr>\n"
+			for _, call := range pmpi.Calls {
+				overlap := "N/A"
+				if call.Overlap != nil {
+					overlap = fmt.Sprintf("%.1f", *call.Overlap)
+				}
+				content += fmt.Sprintf("<tr><td>%s</td><td>%s</td><td>%s (%d)</td><td>%d</td><td>%.3f</td><td>%.3f</td><td>%.3f</td><td>%s</td></tr>\n",
+					call.Op, template.HTMLEscapeString(call.Site), template.HTMLEscapeString(call.Comm), call.CommSize, call.Count, call.PostTime, call.GapTime, call.WaitTime, overlap)
+			}
+			content += "</table>"
+			if pmpi.Dropped > 0 {
+				content += fmt.Sprintf("<br/>%d operations could not be tracked<br/>\n", pmpi.Dropped)
 			}
 			content += "</div>"
 			return content
@@ -302,6 +377,15 @@ func (c *Config) Start() (*Server, error) {
 	s.ipd.LatencyUnit = s.latencyUnit
 	s.ipd.ScratchPath = s.cfg.openhpcaCfg.WP.ScratchDir
 	s.ipd.OverlapData = s.overlapData
+	s.ipd.PMPI = s.data.PMPI
+	s.ipd.Inflation = s.data.ComputeInflation
+	s.ipd.OverlapDetails = s.data.OverlapDetails
+	s.ipd.Noise = s.data.Noise
+	s.ipd.NoiseFlags = s.data.NoiseFlags
+	s.ipd.Async = s.data.Async
+	s.ipd.Pipeline = s.data.Pipeline
+	s.ipd.DLTrain = s.data.DLTrain
+	s.ipd.PCG = s.data.PCG
 	err = analyser.Plot(s.data, s.cfg.openhpcaCfg.WP.ScratchDir)
 	if err != nil {
 		return nil, err